@@ -21,14 +21,21 @@ uniform float frameCount;
 
 in vec3 fragTexCoord;
 in float fragAlpha;
+flat in vec4 fragTexRect;
 out vec4 finalColor;
 
+// Keep the samples within the part of the texture that this sprite covers.
+vec4 Sample(vec2 coord, float layer) {
+	vec2 margin = .5f / vec2(textureSize(tex, 0).xy);
+	return texture(tex, vec3(fragTexRect.xy + clamp(coord * fragTexRect.zw, margin, fragTexRect.zw - margin), layer));
+}
+
 void main() {
 	float first = floor(fragTexCoord.z);
 	float second = mod(ceil(fragTexCoord.z), frameCount);
 	float fade = fragTexCoord.z - first;
 	finalColor = mix(
-		texture(tex, vec3(fragTexCoord.xy, first)),
-		texture(tex, vec3(fragTexCoord.xy, second)), fade);
+		Sample(fragTexCoord.xy, first),
+		Sample(fragTexCoord.xy, second), fade);
 	finalColor *= vec4(fragAlpha);
 }
@@ -18,11 +18,15 @@ uniform vec2 scale;
 in vec2 vert;
 in vec3 texCoord;
 in float alpha;
+// The part of the texture that this sprite covers.
+in vec4 texRect;
 out vec3 fragTexCoord;
 out float fragAlpha;
+flat out vec4 fragTexRect;
 
 void main() {
 	gl_Position = vec4(vert * scale, 0, 1);
 	fragTexCoord = texCoord;
 	fragAlpha = alpha;
+	fragTexRect = texRect;
 }
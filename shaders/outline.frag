@@ -32,11 +32,19 @@ uniform float frame;
 uniform float frameCount;
 uniform vec4 color;
 uniform vec2 off;
+uniform vec4 texRect;
 const vec4 weight = vec4(.4, .4, .4, 1.);
 
 in vec2 fragTexCoord;
 out vec4 finalColor;
 
+// Sample the sprite, even if it only covers part of the texture, the same way
+// as if the texture were clamped to the edges of the sprite.
+vec4 Sample(vec2 coord, float layer) {
+	vec2 margin = .5f / vec2(textureSize(tex, 0).xy);
+	return texture(tex, vec3(texRect.xy + clamp(coord * texRect.zw, margin, texRect.zw - margin), layer));
+}
+
 float Sobel(float layer) {
 	float sum = 0.f;
 	for(int dy = -1; dy <= 1; ++dy)
@@ -44,16 +52,16 @@ float Sobel(float layer) {
 		for(int dx = -1; dx <= 1; ++dx)
 		{
 			vec2 center = fragTexCoord + .618034 * off * vec2(dx, dy);
-			float nw = dot(texture(tex, vec3(center + vec2(-off.x, -off.y), layer)), weight);
-			float ne = dot(texture(tex, vec3(center + vec2(off.x, -off.y), layer)), weight);
-			float sw = dot(texture(tex, vec3(center + vec2(-off.x, off.y), layer)), weight);
-			float se = dot(texture(tex, vec3(center + vec2(off.x, off.y), layer)), weight);
+			float nw = dot(Sample(center + vec2(-off.x, -off.y), layer), weight);
+			float ne = dot(Sample(center + vec2(off.x, -off.y), layer), weight);
+			float sw = dot(Sample(center + vec2(-off.x, off.y), layer), weight);
+			float se = dot(Sample(center + vec2(off.x, off.y), layer), weight);
 			float h = nw + sw - ne - se + 2.f * (
-				dot(texture(tex, vec3(center + vec2(-off.x, 0.f), layer)), weight)
-				- dot(texture(tex, vec3(center + vec2(off.x, 0.f), layer)), weight));
+				dot(Sample(center + vec2(-off.x, 0.f), layer), weight)
+				- dot(Sample(center + vec2(off.x, 0.f), layer), weight));
 			float v = nw + ne - sw - se + 2.f * (
-				dot(texture(tex, vec3(center + vec2(0.f, -off.y), layer)), weight)
-				- dot(texture(tex, vec3(center + vec2(0.f, off.y), layer)), weight));
+				dot(Sample(center + vec2(0.f, -off.y), layer), weight)
+				- dot(Sample(center + vec2(0.f, off.y), layer), weight));
 			sum += h * h + v * v;
 		}
 	}
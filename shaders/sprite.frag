@@ -26,12 +26,20 @@ uniform vec2 blur;
 uniform mat4 swizzleMatrix;
 uniform int useSwizzle;
 uniform float alpha;
+uniform vec4 texRect;
 const int range = 5;
 
 in vec2 fragTexCoord;
 
 out vec4 finalColor;
 
+// Sprites that were packed into an atlas only cover part of the texture, so
+// keep every sample within that part, as clamping to the edge would.
+vec4 Sample(vec2 coord, float layer) {
+	vec2 margin = .5f / vec2(textureSize(tex, 0).xy);
+	return texture(tex, vec3(texRect.xy + clamp(coord * texRect.zw, margin, texRect.zw - margin), layer));
+}
+
 void main() {
 	float first = floor(frame);
 	float second = mod(ceil(frame), frameCount);
@@ -41,10 +49,10 @@ void main() {
 	{
 		if(fade != 0.f)
 			color = mix(
-				texture(tex, vec3(fragTexCoord, first)),
-				texture(tex, vec3(fragTexCoord, second)), fade);
+				Sample(fragTexCoord, first),
+				Sample(fragTexCoord, second), fade);
 		else
-			color = texture(tex, vec3(fragTexCoord, first));
+			color = Sample(fragTexCoord, first);
 	}
 	else
 	{
@@ -56,10 +64,10 @@ void main() {
 			vec2 coord = fragTexCoord + (blur * float(i)) / float(range);
 			if(fade != 0.f)
 				color += scale * mix(
-					texture(tex, vec3(coord, first)),
-					texture(tex, vec3(coord, second)), fade);
+					Sample(coord, first),
+					Sample(coord, second), fade);
 			else
-				color += scale * texture(tex, vec3(coord, first));
+				color += scale * Sample(coord, first);
 		}
 	}
 	if(useSwizzle > 0)
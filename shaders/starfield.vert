@@ -18,16 +18,39 @@ uniform vec2 translate;
 uniform vec2 scale;
 uniform float elongation;
 uniform float brightness;
+// The star pattern repeats this often, and the copy of it that is being drawn
+// starts this far into it.
+uniform float period;
+uniform vec2 start;
+// Each pass draws a different share of the stars in each tile of the pattern.
+uniform float density;
+uniform float layers;
+uniform float pass;
 
 in vec2 offset;
 in float size;
 in float corner;
+// The index of this star among the stars in its tile, and how many stars that
+// tile has.
+in vec2 tile;
 out float fragmentAlpha;
 out vec2 coord;
 
 void main() {
+	float count = floor(tile.y * density / layers);
+	float first = (pass - 1.) * count;
+	if(tile.x < first || tile.x >= first + floor(count / pass))
+	{
+		// Leave this star out by moving it off the screen.
+		fragmentAlpha = 0.;
+		coord = vec2(0, 0);
+		gl_Position = vec4(2, 2, 2, 1);
+		return;
+	}
+
 	fragmentAlpha = brightness * (4. / (4. + elongation)) * size * .2 + .05;
 	coord = vec2(sin(corner), cos(corner));
 	vec2 elongated = vec2(coord.x * size, coord.y * (size + elongation));
-	gl_Position = vec4((rotate * elongated + translate + offset) * scale, 0, 1);
+	vec2 position = mod(offset - start, period);
+	gl_Position = vec4((rotate * elongated + translate + position) * scale, 0, 1);
 }
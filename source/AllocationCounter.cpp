@@ -0,0 +1,72 @@
+/* AllocationCounter.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace {
+	atomic<size_t> count = 0;
+}
+
+
+
+size_t AllocationCounter::Count() noexcept
+{
+	return count.load(memory_order_relaxed);
+}
+
+
+
+// Replace the global allocation functions with ones that count each call. The
+// array and non-throwing versions of "new" and all the versions of "delete"
+// that are not replaced here are defined by the standard library in terms of
+// these ones, so they are counted too.
+void *operator new(size_t size)
+{
+	count.fetch_add(1, memory_order_relaxed);
+	if(!size)
+		size = 1;
+	while(true)
+	{
+		void *pointer = malloc(size);
+		if(pointer)
+			return pointer;
+
+		new_handler handler = get_new_handler();
+		if(!handler)
+			throw bad_alloc();
+		handler();
+	}
+}
+
+
+
+void operator delete(void *pointer) noexcept
+{
+	free(pointer);
+}
+
+
+
+void operator delete(void *pointer, size_t) noexcept
+{
+	free(pointer);
+}
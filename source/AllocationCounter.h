@@ -0,0 +1,30 @@
+/* AllocationCounter.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+
+
+
+// Keeps a running count of how many times memory has been allocated with
+// "new" in any thread, so that code which is meant to run every frame without
+// allocating can be checked. The count is only ever added to; to find out how
+// many allocations something made, compare the count before and after it.
+class AllocationCounter {
+public:
+	static size_t Count() noexcept;
+};
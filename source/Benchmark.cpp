@@ -0,0 +1,252 @@
+/* Benchmark.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "DistanceMap.h"
+#include "GameData.h"
+#include "Random.h"
+#include "shader/RenderStatistics.h"
+#include "RoutePlan.h"
+#include "Ship.h"
+#include "ShipJumpNavigation.h"
+#include "System.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// How many random pairs of systems to plan routes between.
+	const int ROUTE_PAIRS = 1000;
+
+	double Milliseconds(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	}
+
+	// Plan routes between the given pairs of systems, either with the default
+	// hyperdrive or with the given ship's means of travel, and check that every
+	// route takes as many days and as much fuel as the best one found by a full
+	// search outward from its starting system.
+	void CompareRoutes(const vector<pair<const System *, const System *>> &pairs, Ship *ship)
+	{
+		// The route estimates are only calculated once each time the systems
+		// change, so time that separately from the route planning itself.
+		auto start = chrono::steady_clock::now();
+		if(ship)
+		{
+			ship->SetSystem(pairs.front().first);
+			GameData::GetRouteHeuristic(ship->JumpNavigation().JumpRange());
+		}
+		else
+			GameData::GetRouteHeuristic(0.);
+		double setupTime = Milliseconds(start);
+
+		start = chrono::steady_clock::now();
+		vector<RoutePlan> plans;
+		plans.reserve(pairs.size());
+		for(const auto &[from, to] : pairs)
+		{
+			if(ship)
+			{
+				ship->SetSystem(from);
+				plans.emplace_back(*ship, *to);
+			}
+			else
+				plans.emplace_back(*from, *to);
+		}
+		double planTime = Milliseconds(start);
+
+		start = chrono::steady_clock::now();
+		vector<DistanceMap> references;
+		references.reserve(pairs.size());
+		for(const auto &[from, to] : pairs)
+		{
+			if(ship)
+			{
+				ship->SetSystem(from);
+				references.emplace_back(*ship);
+			}
+			else
+				references.emplace_back(from, WormholeStrategy::ALL, false);
+		}
+		double fullTime = Milliseconds(start);
+
+		int reachable = 0;
+		int mismatches = 0;
+		for(size_t i = 0; i < pairs.size(); ++i)
+		{
+			const System &to = *pairs[i].second;
+			const RoutePlan &plan = plans[i];
+			const DistanceMap &reference = references[i];
+			reachable += plan.HasRoute();
+			if(plan.HasRoute() != reference.HasRoute(to) || plan.Days() != reference.Days(to)
+					|| plan.RequiredFuel() != reference.RequiredFuel(to))
+			{
+				++mismatches;
+				cout << "Route mismatch from " << pairs[i].first->TrueName() << " to " << to.TrueName()
+					<< ": " << plan.Days() << " days and " << plan.RequiredFuel() << " fuel, expected "
+					<< reference.Days(to) << " days and " << reference.RequiredFuel(to) << " fuel." << endl;
+			}
+		}
+
+		cout << "Reachable routes: " << reachable << endl;
+		cout << "Route estimates: " << setupTime << " ms" << endl;
+		cout << "Directed search: " << planTime << " ms" << endl;
+		cout << "Full search: " << fullTime << " ms" << endl;
+		cout << "Mismatched routes: " << mismatches << endl;
+	}
+
+	// Find a ship model that travels with a jump drive if that is asked for, or
+	// only with a hyperdrive otherwise, and return a copy of it.
+	shared_ptr<Ship> FindShip(bool hasJumpDrive)
+	{
+		for(const auto &it : GameData::Ships())
+		{
+			const Ship &model = it.second;
+			if(!model.IsValid())
+				continue;
+			const ShipJumpNavigation &navigation = model.JumpNavigation();
+			if(hasJumpDrive ? navigation.HasJumpDrive() : (navigation.HasHyperdrive() && !navigation.HasJumpDrive()))
+				return make_shared<Ship>(model);
+		}
+		return nullptr;
+	}
+
+	// Plan routes between random pairs of systems, with the default hyperdrive
+	// and with ships that travel by hyperdrive and by jump drive, since a jump
+	// drive's range changes which systems are linked.
+	void Routes()
+	{
+		vector<const System *> systems;
+		for(const auto &it : GameData::Systems())
+			if(it.second.IsValid() && !it.second.Inaccessible())
+				systems.push_back(&it.second);
+		if(systems.size() < 2)
+		{
+			cout << "Not enough systems to plan routes between." << endl;
+			return;
+		}
+
+		vector<pair<const System *, const System *>> pairs;
+		while(static_cast<int>(pairs.size()) < ROUTE_PAIRS)
+		{
+			const System *from = systems[Random::Int(systems.size())];
+			const System *to = systems[Random::Int(systems.size())];
+			if(from != to)
+				pairs.emplace_back(from, to);
+		}
+		cout << "Planning routes between " << pairs.size() << " random pairs of " << systems.size()
+			<< " systems." << endl;
+
+		cout << endl << "Without a ship:" << endl;
+		CompareRoutes(pairs, nullptr);
+		for(bool hasJumpDrive : {false, true})
+		{
+			shared_ptr<Ship> ship = FindShip(hasJumpDrive);
+			cout << endl;
+			if(!ship)
+			{
+				cout << "No ship with " << (hasJumpDrive ? "a jump drive" : "only a hyperdrive") << " was found."
+					<< endl;
+				continue;
+			}
+			cout << "With a " << ship->TrueModelName();
+			if(hasJumpDrive)
+				cout << " (jump range " << ship->JumpNavigation().JumpRange() << ")";
+			cout << ":" << endl;
+			CompareRoutes(pairs, ship.get());
+		}
+	}
+
+	void PrintCount(const string &name, int64_t total, int64_t peak, int64_t frames)
+	{
+		cout << name << ": " << static_cast<double>(total) / frames << " per frame (peak " << peak << ")" << endl;
+	}
+}
+
+
+
+bool Benchmark::IsBenchmarkArgument(const char *const *argv)
+{
+	for(const char *const *it = argv + 1; *it; ++it)
+	{
+		string arg = *it;
+		if(arg == "--benchmark-routes")
+			return true;
+	}
+	return false;
+}
+
+
+
+void Benchmark::Run(const char *const *argv)
+{
+	for(const char *const *it = argv + 1; *it; ++it)
+	{
+		string arg = *it;
+		if(arg == "--benchmark-routes")
+			Routes();
+	}
+}
+
+
+
+void Benchmark::Help()
+{
+	cerr << "    --benchmark-routes: plan routes between random pairs of systems in the loaded galaxy"
+		" (including plugins), without a ship and for ships with a hyperdrive and a jump drive, and compare them"
+		" to a full search." << endl;
+	cerr << "    --benchmark-render: when the game exits, print how many draw calls, texture binds,"
+		" uniform updates, buffer uploads and triangles were used per frame (combine with --test <name> --debug"
+		" to measure a repeatable scene)." << endl;
+}
+
+
+
+bool Benchmark::IsRenderBenchmarkArgument(const char *const *argv)
+{
+	for(const char *const *it = argv + 1; *it; ++it)
+		if(string(*it) == "--benchmark-render")
+			return true;
+	return false;
+}
+
+
+
+void Benchmark::PrintRenderStatistics()
+{
+	int64_t frames = RenderStatistics::Frames();
+	cout << "Rendered " << frames << " frames." << endl;
+	if(frames)
+	{
+		const RenderStatistics::Counts &total = RenderStatistics::Total();
+		const RenderStatistics::Counts &peak = RenderStatistics::Peak();
+		PrintCount("Draw calls", total.drawCalls, peak.drawCalls, frames);
+		PrintCount("Triangles", total.triangles, peak.triangles, frames);
+		PrintCount("Texture binds", total.textureBinds, peak.textureBinds, frames);
+		PrintCount("Uniform updates", total.uniformUpdates, peak.uniformUpdates, frames);
+		PrintCount("Buffer uploads", total.bufferUploads, peak.bufferUploads, frames);
+		PrintCount("Uploaded bytes", total.uploadedBytes, peak.uploadedBytes, frames);
+	}
+	cout << "Texture memory in use: " << RenderStatistics::TextureMemory() / 1048576. << " MB" << endl;
+}
@@ -0,0 +1,33 @@
+/* Benchmark.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+
+
+// A class containing methods used to time parts of the game that depend on the
+// loaded game data (including any plugins), and print the results to the console.
+class Benchmark {
+public:
+	static bool IsBenchmarkArgument(const char *const *argv);
+	static void Run(const char *const *argv);
+	static void Help();
+
+	// Drawing needs a window, so the rendering statistics are not gathered by
+	// Run(); instead, they are collected while the game runs normally and then
+	// printed when it exits.
+	static bool IsRenderBenchmarkArgument(const char *const *argv);
+	static void PrintRenderStatistics();
+};
@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataFile.h"
 
 #include "Files.h"
+#include "FileView.h"
+#include "Gzip.h"
 #include "text/Utf8.h"
 
 using namespace std;
@@ -41,13 +43,27 @@ DataFile::DataFile(istream &in)
 // Load from a file path (in UTF-8).
 void DataFile::Load(const filesystem::path &path)
 {
-	string data = Files::Read(path);
+	// Parse the file's contents in place, unless they need to be changed first.
+	const FileView file = Files::Map(path);
+	string_view data = file.Data();
+	string text;
+	// Saved games may be compressed, but otherwise look like any other file.
+	if(Gzip::IsCompressed(data))
+	{
+		text = Gzip::Decompress(data);
+		data = text;
+	}
 	if(data.empty())
 		return;
 
 	// As a sentinel, make sure the file always ends in a newline.
 	if(data.back() != '\n')
-		data.push_back('\n');
+	{
+		if(text.empty())
+			text = data;
+		text.push_back('\n');
+		data = text;
+	}
 
 	// Note what file this node is in, so it will show up in error traces.
 	root.tokens.push_back("file");
@@ -71,6 +87,8 @@ void DataFile::Load(istream &in)
 		in.read(&*data.begin() + currentSize, BLOCK);
 		data.resize(currentSize + in.gcount());
 	}
+	if(Gzip::IsCompressed(data))
+		data = Gzip::Decompress(data);
 	// As a sentinel, make sure the file always ends in a newline.
 	if(data.empty() || data.back() != '\n')
 		data.push_back('\n');
@@ -97,7 +115,7 @@ list<DataNode>::const_iterator DataFile::end() const
 
 
 // Parse the given text.
-void DataFile::LoadData(const string &data)
+void DataFile::LoadData(string_view data)
 {
 	// Keep track of the current stack of indentation levels and the most recent
 	// node at each level - that is, the node that will be the "parent" of any
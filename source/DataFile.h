@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <istream>
 #include <list>
 #include <string>
+#include <string_view>
 
 
 
@@ -46,7 +47,8 @@ public:
 
 
 private:
-	void LoadData(const std::string &data);
+	// Parse the given text, which must end in a newline.
+	void LoadData(std::string_view data);
 
 
 private:
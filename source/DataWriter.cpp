@@ -18,6 +18,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "Files.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <utility>
+
 using namespace std;
 
 
@@ -32,7 +39,21 @@ const string DataWriter::space = " ";
 DataWriter::DataWriter(const filesystem::path &path)
 	: DataWriter()
 {
-	this->path = path;
+	shared_ptr<iostream> file = Files::Open(path, true);
+	sink = [file](const char *data, size_t size)
+	{
+		if(file)
+			file->write(data, size);
+	};
+}
+
+
+
+// Constructor for a DataWriter that passes its output to the given function.
+DataWriter::DataWriter(Sink sink)
+	: DataWriter()
+{
+	this->sink = std::move(sink);
 }
 
 
@@ -41,32 +62,37 @@ DataWriter::DataWriter(const filesystem::path &path)
 DataWriter::DataWriter()
 	: before(&indent)
 {
-	out.precision(8);
 }
 
 
 
-// Destructor, which saves the file all in one block.
+// Destructor, which writes any output that has not been written yet.
 DataWriter::~DataWriter()
 {
-	if(!path.empty())
-		SaveToPath(path);
+	Flush();
 }
 
 
 
-// Save the contents to a file.
+// Save the contents of an in-memory DataWriter to a file.
 void DataWriter::SaveToPath(const filesystem::path &filepath)
 {
-	Files::Write(filepath, out.str());
+	Files::Write(filepath, buffer);
 }
 
 
 
-// Get the contents as a string.
-string DataWriter::SaveToString() const
+// Get the contents of an in-memory DataWriter as a string.
+string DataWriter::SaveToString() const &
 {
-	return out.str();
+	return buffer;
+}
+
+
+
+string DataWriter::SaveToString() &&
+{
+	return std::move(buffer);
 }
 
 
@@ -96,7 +122,7 @@ void DataWriter::Write(const DataNode &node)
 // Begin a new line of the file.
 void DataWriter::Write()
 {
-	out << '\n';
+	Append("\n");
 	before = &indent;
 }
 
@@ -121,7 +147,9 @@ void DataWriter::EndChild()
 // Write a comment line, at the current indentation level.
 void DataWriter::WriteComment(const string &str)
 {
-	out << *before << "# " << str;
+	Append(*before);
+	Append("# ");
+	Append(str);
 	Write();
 }
 
@@ -130,7 +158,12 @@ void DataWriter::WriteComment(const string &str)
 // Write a token, given as a character string.
 void DataWriter::WriteToken(const char *a)
 {
-	WriteToken(string(a));
+	Append(*before);
+	WriteQuoted(a);
+
+	// The next token written will not be the first one on this line, so it only
+	// needs to have a single space before it.
+	before = &space;
 }
 
 
@@ -138,29 +171,82 @@ void DataWriter::WriteToken(const char *a)
 // Write a token, given as a string object.
 void DataWriter::WriteToken(const string &a)
 {
-	out << *before;
-	out << Quote(a);
-
-	// The next token written will not be the first one on this line, so it only
-	// needs to have a single space before it.
+	Append(*before);
+	WriteQuoted(a);
 	before = &space;
 }
 
 
 
 string DataWriter::Quote(const string &a)
+{
+	char quote = QuoteFor(a);
+	return quote ? quote + a + quote : a;
+}
+
+
+
+// Get the quotation mark that should be put around the given text, or a null
+// character if it does not need to be quoted.
+char DataWriter::QuoteFor(string_view text)
 {
 	// Figure out what kind of quotation marks need to be used for this string.
-	bool hasSpace = any_of(a.begin(), a.end(), [](unsigned char c) { return isspace(c); });
-	bool hasQuote = any_of(a.begin(), a.end(), [](char c) { return (c == '"'); });
-	bool hasBacktick = any_of(a.begin(), a.end(), [](char c) { return (c == '`'); });
+	bool hasSpace = any_of(text.begin(), text.end(), [](unsigned char c) { return isspace(c); });
+	bool hasQuote = any_of(text.begin(), text.end(), [](char c) { return (c == '"'); });
+	bool hasBacktick = any_of(text.begin(), text.end(), [](char c) { return (c == '`'); });
 	// If the token is an empty string, it needs to be wrapped in quotes as if it had a space.
-	hasSpace |= a.empty();
+	hasSpace |= text.empty();
 
 	if(hasQuote)
-		return '`' + a + '`';
+		return '`';
 	else if(hasSpace || hasBacktick)
-		return '"' + a + '"';
+		return '"';
 	else
-		return a;
+		return '\0';
+}
+
+
+
+// Write a string token, with quotation marks if needed.
+void DataWriter::WriteQuoted(string_view text)
+{
+	char quote = QuoteFor(text);
+	if(quote)
+		Append(string_view(&quote, 1));
+	Append(text);
+	if(quote)
+		Append(string_view(&quote, 1));
+}
+
+
+
+// Add text to the output. If this DataWriter has somewhere to send its output,
+// it is sent a block at a time, so that the whole output is never in memory.
+void DataWriter::Append(string_view text)
+{
+	buffer.append(text);
+	if(sink && buffer.size() >= BUFFER_SIZE)
+		Flush();
+}
+
+
+
+// Floating point numbers are written with up to eight significant digits.
+void DataWriter::AppendFloat(double value)
+{
+	char digits[32];
+	int length = snprintf(digits, sizeof(digits), "%.8g", value);
+	Append(string_view(digits, max(0, min<int>(length, sizeof(digits) - 1))));
+}
+
+
+
+// Pass all the buffered output to the sink.
+void DataWriter::Flush()
+{
+	if(!sink || buffer.empty())
+		return;
+
+	sink(buffer.data(), buffer.size());
+	buffer.clear();
 }
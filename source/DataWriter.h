@@ -16,10 +16,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <algorithm>
+#include <charconv>
+#include <cstddef>
 #include <filesystem>
+#include <functional>
 #include <map>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 class DataNode;
@@ -33,27 +37,37 @@ class DataNode;
 // automatically adds quotation marks around strings if they contain whitespace.
 class DataWriter {
 public:
-	// Constructor, specifying the file to write.
+	// A function that is given each block of output once it is ready.
+	using Sink = std::function<void(const char *data, size_t size)>;
+
+
+public:
+	// Constructor, specifying the file to write. The output is written to the
+	// file a block at a time as it is generated.
 	explicit DataWriter(const std::filesystem::path &path);
+	// Constructor for a DataWriter that passes its output, a block at a time,
+	// to the given function instead of writing it to a file.
+	explicit DataWriter(Sink sink);
 	// Constructor for a DataWriter that will not save its contents automatically
 	DataWriter();
 	DataWriter(const DataWriter &) = delete;
 	DataWriter(DataWriter &&) = delete;
 	DataWriter &operator=(const DataWriter &) = delete;
 	DataWriter operator=(DataWriter &&) = delete;
-	// The file is not actually saved until the destructor is called. This makes
-	// it possible to write the whole file in a single chunk.
+	// Any output that has not been written yet is written when the DataWriter
+	// is destroyed.
 	~DataWriter();
 
-	// Save the contents to a file.
+	// Save the contents of an in-memory DataWriter to a file.
 	void SaveToPath(const std::filesystem::path &path);
-	// Get the contents as a string.
-	std::string SaveToString() const;
+	// Get the contents of an in-memory DataWriter as a string.
+	std::string SaveToString() const &;
+	std::string SaveToString() &&;
 
 	// The Write() function can take any number of arguments. Each argument is
 	// converted to a token. Arguments may be strings or numeric values.
 	template<class A, class ...B>
-	void Write(const A &a, B... others);
+	void Write(const A &a, const B &...others);
 	// Write the entire structure represented by a DataNode, including any
 	// children that it has.
 	void Write(const DataNode &node);
@@ -82,8 +96,25 @@ public:
 
 
 private:
-	// Save path (in UTF-8). Empty string for in-memory DataWriter.
-	std::filesystem::path path;
+	// Get the quotation mark that should be put around the given text, or a
+	// null character if it does not need to be quoted.
+	static char QuoteFor(std::string_view text);
+	// Write a string token, with quotation marks if needed.
+	void WriteQuoted(std::string_view text);
+	// Add text to the output, passing the output to the sink if the buffer is full.
+	void Append(std::string_view text);
+	void AppendFloat(double value);
+	// Pass all the buffered output to the sink.
+	void Flush();
+
+
+private:
+	// How much output to collect before passing it to the sink.
+	static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+	// Where to write the output. If this is empty, the DataWriter is in-memory
+	// and keeps all of its output in the buffer.
+	Sink sink;
 	// Current indentation level.
 	std::string indent;
 	// Before writing each token, we will write either the indentation string
@@ -92,8 +123,8 @@ private:
 	// Remember which string should be written before the next token. This is
 	// "indent" for the first token in a line and "space" for subsequent tokens.
 	const std::string *before;
-	// Compose the output in memory before writing it to file.
-	std::ostringstream out;
+	// Output that has not been passed to the sink yet.
+	std::string buffer;
 };
 
 
@@ -101,7 +132,7 @@ private:
 // The Write() function can take any number of arguments, each of which becomes
 // a token. They must be either strings or numeric types.
 template<class A, class ...B>
-void DataWriter::Write(const A &a, B... others)
+void DataWriter::Write(const A &a, const B &...others)
 {
 	WriteToken(a);
 	Write(others...);
@@ -116,7 +147,24 @@ void DataWriter::WriteToken(const A &a)
 	static_assert(std::is_arithmetic_v<A>,
 		"DataWriter cannot output anything but strings and arithmetic types.");
 
-	out << *before << a;
+	Append(*before);
+	// Characters are written as characters, and floating point numbers with up
+	// to eight significant digits. Other numbers are written in full.
+	if constexpr(std::is_same_v<A, char> || std::is_same_v<A, signed char> || std::is_same_v<A, unsigned char>)
+	{
+		const char c = static_cast<char>(a);
+		Append(std::string_view(&c, 1));
+	}
+	else if constexpr(std::is_same_v<A, bool>)
+		Append(a ? "1" : "0");
+	else if constexpr(std::is_floating_point_v<A>)
+		AppendFloat(static_cast<double>(a));
+	else
+	{
+		char digits[24];
+		const auto result = std::to_chars(digits, digits + sizeof(digits), a);
+		Append(std::string_view(digits, result.ptr - digits));
+	}
 	before = &space;
 }
 
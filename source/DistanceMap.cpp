@@ -15,14 +15,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DistanceMap.h"
 
+#include "GameData.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
+#include "RouteHeuristic.h"
 #include "Ship.h"
 #include "ShipJumpNavigation.h"
 #include "StellarObject.h"
 #include "System.h"
 #include "Wormhole.h"
 
+#include <algorithm>
+
 using namespace std;
 
 
@@ -49,6 +53,15 @@ DistanceMap::DistanceMap(const System *center, WormholeStrategy wormholeStrategy
 
 
 
+// Constructor that uses the given ship's travel capabilities.
+DistanceMap::DistanceMap(const Ship &ship)
+	: center(ship.GetSystem())
+{
+	Init(&ship);
+}
+
+
+
 // Constructor that uses PlayerInfo to determine the path.
 // If no center system is given, the map will start from the player's system.
 // Pathfinding will only use hyperspace paths known to the player; that is,
@@ -116,6 +129,15 @@ int DistanceMap::Days(const System &target) const
 
 
 
+// Find out how much fuel is needed to travel to the given system.
+int DistanceMap::RequiredFuel(const System &target) const
+{
+	auto it = route.find(&target);
+	return (it == route.end() ? -1 : it->second.fuel);
+}
+
+
+
 // Get a set containing all the systems.
 set<const System *> DistanceMap::Systems() const
 {
@@ -184,6 +206,33 @@ void DistanceMap::Init(const Ship *ship)
 		jumpRangeMax = ship->JumpNavigation().JumpRange();
 	}
 
+	// If a destination is given, search toward it (A* search) rather than
+	// outward in every direction. The estimates are only lower bounds on the
+	// remaining distance, so the route found is still the best one.
+	if(destination)
+	{
+		heuristic = GameData::GetRouteHeuristic(jumpRangeMax);
+
+		// Every jump other than through a wormhole costs at least this much fuel.
+		double cheapestJump = 0.;
+		if(ship)
+		{
+			const ShipJumpNavigation &navigation = ship->JumpNavigation();
+			if(navigation.HasHyperdrive() && navigation.HasJumpDrive())
+				cheapestJump = min(navigation.HyperdriveFuel(), navigation.JumpDriveFuel());
+			else if(navigation.HasHyperdrive())
+				cheapestJump = navigation.HyperdriveFuel();
+			else if(navigation.HasJumpDrive())
+				cheapestJump = navigation.JumpDriveFuel();
+		}
+		else if(jumpRangeMax > 0.)
+			cheapestJump = min(Outfit::DEFAULT_HYPERDRIVE_COST, Outfit::DEFAULT_JUMP_DRIVE_COST);
+		else
+			cheapestJump = Outfit::DEFAULT_HYPERDRIVE_COST;
+		// The fuel of a route is rounded down after each jump.
+		minimumJumpFuel = max(0, static_cast<int>(cheapestJump));
+	}
+
 	// Find the route with the lowest fuel use. If multiple routes use the same fuel,
 	// choose the one with the fewest jumps (i.e. using jump drive rather than
 	// hyperdrive). If multiple routes have the same fuel and the same number of
@@ -203,6 +252,9 @@ void DistanceMap::Init(const Ship *ship)
 		// edgesTodo to process later.
 		RouteEdge nextEdge = edgesTodo.top();
 		edgesTodo.pop();
+		// The estimate only matters for ordering the candidate edges.
+		nextEdge.fuelEstimate = 0;
+		nextEdge.daysEstimate = 0;
 
 		const System *currentSystem = nextEdge.prev;
 
@@ -328,12 +380,31 @@ void DistanceMap::Add(const System &to, RouteEdge edge)
 	// Start building upon this edge and enqueue - this copy of edge
 	// is in an incomplete state and needs to be dequeued and worked on.
 	edge.prev = &to;
-	if(maxDays < 0 || edge.days < maxDays)
+	if((maxDays < 0 || edge.days < maxDays) && Estimate(edge))
 		edgesTodo.emplace(edge);
 }
 
 
 
+// If there is a destination, estimate the remaining fuel and days needed to
+// get there from the given edge. Return false if it is impossible.
+bool DistanceMap::Estimate(RouteEdge &edge) const
+{
+	if(!heuristic)
+		return true;
+
+	int jumps = 0;
+	int drives = 0;
+	if(!heuristic->Estimate(*edge.prev, *destination, jumps, drives))
+		return false;
+
+	edge.daysEstimate = jumps;
+	edge.fuelEstimate = drives * minimumJumpFuel;
+	return true;
+}
+
+
+
 // Check whether the given link is travelable. If no player was given in the
 // constructor then this depends on travel restrictions; otherwise, the player must know
 // that the given link exists.
@@ -19,12 +19,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "WormholeStrategy.h"
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <utility>
 #include <vector>
 
 class PlayerInfo;
+class RouteHeuristic;
 class Ship;
 class System;
 
@@ -50,11 +52,16 @@ public:
 	// Optional arguments are as above.
 	explicit DistanceMap(const System *center, WormholeStrategy wormholeStrategy,
 			bool useJumpDrive, int maxSystems = -1, int maxDays = -1);
+	// Find paths branching out from the given ship's system, using a jump drive
+	// or hyperdrive depending on what the ship has.
+	explicit DistanceMap(const Ship &ship);
 
 	// Find out if the given system is reachable.
 	bool HasRoute(const System &system) const;
 	// Find out how many days away the given system is.
 	int Days(const System &system) const;
+	// Find out how much fuel is needed to travel to the given system.
+	int RequiredFuel(const System &system) const;
 	// Get the planned route from center to this system.
 	std::vector<const System *> Plan(const System &system) const;
 	// Get a set containing all the systems.
@@ -82,6 +89,9 @@ private:
 	bool HasBetter(const System &to, const RouteEdge &edge);
 	// Add the given path to the record.
 	void Add(const System &to, RouteEdge edge);
+	// If there is a destination, estimate the remaining fuel and days needed to
+	// get there from the given edge. Return false if it is impossible.
+	bool Estimate(RouteEdge &edge) const;
 	// Check whether the given link is travelable. If no player was given in the
 	// constructor then this is always true; otherwise, the player must know
 	// that the given link exists.
@@ -109,5 +119,11 @@ private:
 	double jumpRangeMax = 0.;
 	const Ship *ship = nullptr;
 
+	// Lower bounds on the remaining distance to the destination, used to
+	// direct the search toward it rather than expanding in every direction.
+	std::shared_ptr<const RouteHeuristic> heuristic;
+	// The least fuel that any jump (other than through a wormhole) can cost.
+	int minimumJumpFuel = 0;
+
 	friend class RoutePlan;
 };
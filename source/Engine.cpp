@@ -268,7 +268,7 @@ Engine::Engine(PlayerInfo &player)
 			SpriteLoadManager::LoadDeferred(queue, object.GetPlanet()->Landscape());
 	}
 	queue.Wait();
-	queue.ProcessSyncTasks();
+	queue.ProcessSyncTasks(true);
 
 	// Figure out what planet the player is landed on, if any.
 	const StellarObject *object = player.GetStellarObject();
@@ -768,7 +768,7 @@ void Engine::Step(bool isActive)
 		Messages::Add(*GameData::Messages().Get("overheated"));
 
 	// Clear the HUD information from the previous frame.
-	info = Information();
+	info.Clear();
 	if(flagship && flagship->Hull())
 	{
 		Point shipFacingUnit(0., -1.);
@@ -2452,7 +2452,7 @@ void Engine::DoCollisions(Projectile &projectile)
 	// The asteroids can collide with projectiles, the same as any other
 	// object. If the asteroid turns out to be closer than the ship, it
 	// shields the ship (unless the projectile has a blast radius).
-	vector<Collision> collisions;
+	collisions.clear();
 	const Government *gov = projectile.GetGovernment();
 	const Weapon &weapon = projectile.GetWeapon();
 
@@ -2479,10 +2479,9 @@ void Engine::DoCollisions(Projectile &projectile)
 		double triggerRadius = weapon.TriggerRadius();
 		if(triggerRadius)
 		{
-			vector<Body *> inRadius;
-			inRadius.reserve(min(static_cast<vector<Body *>::size_type>(triggerRadius), ships.size()));
-			shipCollisions.Circle(projectile.Position(), triggerRadius, inRadius);
-			for(const Body *body : inRadius)
+			collisionBodies.clear();
+			shipCollisions.Circle(projectile.Position(), triggerRadius, collisionBodies);
+			for(const Body *body : collisionBodies)
 			{
 				const Ship *ship = static_cast<const Ship *>(body);
 				// Don't trigger off of carried ships that are disabled and not directly targeted.
@@ -2545,8 +2544,7 @@ void Engine::DoCollisions(Projectile &projectile)
 			// "safe" weapon.
 			Point hitPos = projectile.Position() + range * projectile.Velocity();
 			bool isSafe = weapon.IsSafe();
-			vector<Body *> blastCollisions;
-			blastCollisions.reserve(32);
+			blastCollisions.clear();
 			shipCollisions.Circle(hitPos, blastRadius, blastCollisions);
 			for(Body *body : blastCollisions)
 			{
@@ -2620,15 +2618,12 @@ void Engine::DoWeather(Weather &weather)
 		// Get all ship bodies that are touching a ring defined by the hazard's min
 		// and max ranges at the hazard's origin. Any ship touching this ring takes
 		// hazard damage.
-		vector<Body *> affectedShips;
+		collisionBodies.clear();
 		if(hazard->SystemWide())
-			affectedShips = shipCollisions.All();
+			collisionBodies = shipCollisions.All();
 		else
-		{
-			affectedShips.reserve(ships.size());
-			shipCollisions.Ring(weather.Origin(), hazard->MinRange(), hazard->MaxRange(), affectedShips);
-		}
-		for(Body *body : affectedShips)
+			shipCollisions.Ring(weather.Origin(), hazard->MinRange(), hazard->MaxRange(), collisionBodies);
+		for(Body *body : collisionBodies)
 		{
 			Ship *hit = static_cast<Ship *>(body);
 			int eventType = hit->TakeDamage(visuals, damage.CalculateDamage(*hit), nullptr);
@@ -2645,10 +2640,9 @@ void Engine::DoCollection(Flotsam &flotsam)
 {
 	// Check if any ship can pick up this flotsam. Cloaked ships without "cloaked pickup" cannot act.
 	Ship *collector = nullptr;
-	vector<Body *> pickupShips;
-	pickupShips.reserve(16);
-	shipCollisions.Circle(flotsam.Position(), 5., pickupShips);
-	for(Body *body : pickupShips)
+	collisionBodies.clear();
+	shipCollisions.Circle(flotsam.Position(), 5., collisionBodies);
+	for(Body *body : collisionBodies)
 	{
 		Ship *ship = static_cast<Ship *>(body);
 		if(!ship->CannotAct(Ship::ActionType::PICKUP) && ship->CanPickUp(flotsam))
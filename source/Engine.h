@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "AsteroidField.h"
 #include "shader/BatchDrawList.h"
 #include "Camera.h"
+#include "Collision.h"
 #include "CollisionSet.h"
 #include "Color.h"
 #include "Command.h"
@@ -44,6 +45,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <utility>
 #include <vector>
 
+class Body;
 class Flotsam;
 class Government;
 class NPC;
@@ -289,6 +291,12 @@ private:
 	int grudgeTime = 0;
 
 	CollisionSet shipCollisions;
+	// Scratch space for the collision checks, which happen many times per step.
+	// It is kept from one step to the next so that it only needs to be
+	// allocated once.
+	std::vector<Collision> collisions;
+	std::vector<Body *> collisionBodies;
+	std::vector<Body *> blastCollisions;
 
 	int alarmTime = 0;
 	int nukeAlarmTime = 0;
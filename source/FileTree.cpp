@@ -0,0 +1,235 @@
+/* FileTree.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "FileTree.h"
+
+#include "Files.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace {
+#if defined(_WIN32) || defined(__APPLE__)
+	// File names on these platforms usually ignore case, so a file that is not
+	// in the tree may still exist under a differently capitalized name.
+	const bool TRUST_MISSES = false;
+#else
+	const bool TRUST_MISSES = true;
+#endif
+	// Listing a directory is mostly a matter of waiting for the disk, so use
+	// more threads than most computers have cores.
+	const unsigned SCAN_THREADS = 8;
+
+	// Remove everything in the given map that is at or inside the given path.
+	// Since paths are sorted one component at a time, all of them are together.
+	template<class Map>
+	void EraseTree(Map &map, const filesystem::path &root)
+	{
+		auto it = map.lower_bound(root);
+		while(it != map.end() && Files::IsParent(root, it->first))
+			it = map.erase(it);
+	}
+}
+
+
+
+// Scan the given directories and everything they contain.
+FileTree::FileTree(const vector<filesystem::path> &roots)
+	: roots(roots)
+{
+	mutex scanMutex;
+	condition_variable condition;
+	// Directories that have been found but not yet scanned.
+	vector<filesystem::path> pending;
+	// How many threads are currently scanning a directory, and so may still
+	// find more directories to scan.
+	unsigned busy = 0;
+
+	for(const filesystem::path &root : roots)
+	{
+		error_code error;
+		filesystem::file_time_type time = filesystem::last_write_time(root, error);
+		if(!error && filesystem::is_directory(root, error))
+		{
+			times[root] = time;
+			pending.push_back(root);
+		}
+	}
+
+	auto scan = [&]() {
+		unique_lock<mutex> lock(scanMutex);
+		while(true)
+		{
+			condition.wait(lock, [&pending, &busy] { return !pending.empty() || !busy; });
+			if(pending.empty())
+				break;
+			filesystem::path path = std::move(pending.back());
+			pending.pop_back();
+			++busy;
+			lock.unlock();
+
+			Directory directory;
+			vector<pair<filesystem::path, filesystem::file_time_type>> found;
+			error_code error;
+			for(filesystem::directory_iterator it(path, error), end; !error && it != end; it.increment(error))
+			{
+				const filesystem::directory_entry &entry = *it;
+				bool isFile = entry.is_regular_file(error);
+				bool isDirectory = !error && !isFile && entry.is_directory(error);
+				if(error)
+					break;
+				if(!isFile && !isDirectory)
+					continue;
+
+				found.emplace_back(entry.path(), entry.last_write_time(error));
+				if(error)
+					break;
+				if(isFile)
+					directory.files.push_back(entry.path());
+				else
+				{
+					directory.directories.push_back(entry.path());
+					if(entry.is_symlink(error))
+						directory.links.push_back(entry.path());
+				}
+			}
+			// If anything in this directory could not be checked, leave it out of
+			// the tree so that questions about it go to the file system instead.
+			if(!error)
+			{
+				sort(directory.files.begin(), directory.files.end());
+				sort(directory.directories.begin(), directory.directories.end());
+				sort(directory.links.begin(), directory.links.end());
+			}
+
+			lock.lock();
+			if(!error)
+			{
+				for(auto &it : found)
+					times.insert(std::move(it));
+				for(const filesystem::path &child : directory.directories)
+					if(!binary_search(directory.links.begin(), directory.links.end(), child))
+						pending.push_back(child);
+				directories.emplace(std::move(path), std::move(directory));
+			}
+			--busy;
+			condition.notify_all();
+		}
+	};
+
+	vector<thread> threads;
+	for(unsigned i = 1; i < SCAN_THREADS; ++i)
+		threads.emplace_back(scan);
+	scan();
+	for(thread &it : threads)
+		it.join();
+}
+
+
+
+// Forget the contents of whichever scanned directory contains the given path.
+void FileTree::Forget(const filesystem::path &path)
+{
+	for(auto it = roots.begin(); it != roots.end(); )
+	{
+		if(Files::IsParent(*it, path) || Files::IsParent(path, *it))
+		{
+			EraseTree(directories, *it);
+			EraseTree(times, *it);
+			it = roots.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+
+
+optional<vector<filesystem::path>> FileTree::List(const filesystem::path &directory) const
+{
+	auto it = directories.find(directory);
+	if(it == directories.end())
+		return nullopt;
+	return it->second.files;
+}
+
+
+
+optional<vector<filesystem::path>> FileTree::ListDirectories(const filesystem::path &directory) const
+{
+	auto it = directories.find(directory);
+	if(it == directories.end())
+		return nullopt;
+	return it->second.directories;
+}
+
+
+
+optional<vector<filesystem::path>> FileTree::RecursiveList(const filesystem::path &directory) const
+{
+	auto it = directories.find(directory);
+	if(it == directories.end())
+		return nullopt;
+
+	vector<filesystem::path> list;
+	vector<const Directory *> stack = {&it->second};
+	while(!stack.empty())
+	{
+		const Directory &current = *stack.back();
+		stack.pop_back();
+		list.insert(list.end(), current.files.begin(), current.files.end());
+		for(const filesystem::path &child : current.directories)
+		{
+			auto childIt = directories.find(child);
+			if(childIt != directories.end())
+				stack.push_back(&childIt->second);
+			else if(!binary_search(current.links.begin(), current.links.end(), child))
+				return nullopt;
+		}
+	}
+	sort(list.begin(), list.end());
+	return list;
+}
+
+
+
+optional<bool> FileTree::Exists(const filesystem::path &path) const
+{
+	if(times.contains(path))
+		return true;
+
+	// If this path would be in a directory that was scanned, it does not exist.
+	const filesystem::path name = path.filename();
+	if(!TRUST_MISSES || name.empty() || name == "." || name == "..")
+		return nullopt;
+	if(directories.contains(path.parent_path()))
+		return false;
+	return nullopt;
+}
+
+
+
+optional<filesystem::file_time_type> FileTree::Timestamp(const filesystem::path &path) const
+{
+	auto it = times.find(path);
+	if(it == times.end())
+		return nullopt;
+	return it->second;
+}
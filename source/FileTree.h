@@ -0,0 +1,71 @@
+/* FileTree.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <vector>
+
+
+
+// A snapshot of the contents of some directories, and the modification time of
+// everything in them, so that questions about those files can be answered
+// without going to the disk again. The directories are scanned by several
+// threads at once, since on a slow or networked disk most of the time spent
+// listing them is spent waiting. Each query returns nothing if the snapshot
+// cannot answer it, in which case the file system must be checked instead;
+// for example, links to other directories are not followed, and the contents
+// of zip files are not included.
+class FileTree {
+public:
+	FileTree() noexcept = default;
+	// Scan the given directories and everything they contain.
+	explicit FileTree(const std::vector<std::filesystem::path> &roots);
+
+	// Forget the contents of whichever scanned directory contains the given
+	// path, because something in it is being changed.
+	void Forget(const std::filesystem::path &path);
+
+	// Get a sorted list of the regular files in the given directory.
+	std::optional<std::vector<std::filesystem::path>> List(const std::filesystem::path &directory) const;
+	// Get a sorted list of the directories in the given directory.
+	std::optional<std::vector<std::filesystem::path>> ListDirectories(const std::filesystem::path &directory) const;
+	// Get a sorted list of the regular files in the given directory and all the
+	// directories within it, without following links to other directories.
+	std::optional<std::vector<std::filesystem::path>> RecursiveList(const std::filesystem::path &directory) const;
+
+	std::optional<bool> Exists(const std::filesystem::path &path) const;
+	std::optional<std::filesystem::file_time_type> Timestamp(const std::filesystem::path &path) const;
+
+
+private:
+	class Directory {
+	public:
+		std::vector<std::filesystem::path> files;
+		std::vector<std::filesystem::path> directories;
+		// Any of the directories that are links, which are not scanned.
+		std::vector<std::filesystem::path> links;
+	};
+
+
+private:
+	std::vector<std::filesystem::path> roots;
+	// Every directory whose contents are known.
+	std::map<std::filesystem::path, Directory> directories;
+	// The modification time of every file and directory in the tree.
+	std::map<std::filesystem::path, std::filesystem::file_time_type> times;
+};
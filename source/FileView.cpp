@@ -0,0 +1,159 @@
+/* FileView.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "FileView.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+using namespace std;
+
+
+
+// Map the given file into memory.
+FileView FileView::Map(const filesystem::path &path)
+{
+	FileView view;
+#ifdef _WIN32
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		return view;
+
+	LARGE_INTEGER size;
+	if(GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		// The view stays valid after both handles are closed.
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(mapping)
+		{
+			view.mapped = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			if(view.mapped)
+				view.mappedSize = size.QuadPart;
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if(file < 0)
+		return view;
+
+	struct stat info;
+	if(!fstat(file, &info) && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		// The mapping stays valid after the file is closed.
+		void *address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if(address != MAP_FAILED)
+		{
+			// Files are almost always read from start to end.
+			posix_madvise(address, info.st_size, POSIX_MADV_SEQUENTIAL);
+			view.mapped = static_cast<const char *>(address);
+			view.mappedSize = info.st_size;
+		}
+	}
+	close(file);
+#endif
+	return view;
+}
+
+
+
+FileView::FileView(string contents) noexcept
+	: contents(std::move(contents))
+{
+}
+
+
+
+FileView::FileView(FileView &&other) noexcept
+	: mapped(std::exchange(other.mapped, nullptr)), mappedSize(std::exchange(other.mappedSize, 0)),
+	contents(std::move(other.contents))
+{
+}
+
+
+
+FileView &FileView::operator=(FileView &&other) noexcept
+{
+	if(this != &other)
+	{
+		Unmap();
+		mapped = std::exchange(other.mapped, nullptr);
+		mappedSize = std::exchange(other.mappedSize, 0);
+		contents = std::move(other.contents);
+	}
+	return *this;
+}
+
+
+
+FileView::~FileView()
+{
+	Unmap();
+}
+
+
+
+string_view FileView::Data() const noexcept
+{
+	return mapped ? string_view(mapped, mappedSize) : string_view(contents);
+}
+
+
+
+size_t FileView::Size() const noexcept
+{
+	return mapped ? mappedSize : contents.size();
+}
+
+
+
+bool FileView::Empty() const noexcept
+{
+	return !Size();
+}
+
+
+
+// Check whether the view refers directly to the file's mapped memory.
+bool FileView::IsMapped() const noexcept
+{
+	return mapped;
+}
+
+
+
+void FileView::Unmap() noexcept
+{
+	if(!mapped)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(mapped);
+#else
+	munmap(const_cast<char *>(mapped), mappedSize);
+#endif
+	mapped = nullptr;
+	mappedSize = 0;
+}
@@ -0,0 +1,62 @@
+/* FileView.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+
+
+// A read-only view of the contents of a file. Where possible, the file is
+// mapped into memory, so that its contents are never copied; otherwise, the
+// view holds a copy of them instead. The contents stay valid for as long as
+// the view exists. Files::Map() creates views for any file the game can read.
+class FileView {
+public:
+	// Map the given file into memory. If the file cannot be mapped, for example
+	// because it is empty or does not exist, the view is empty and unmapped.
+	static FileView Map(const std::filesystem::path &path);
+
+
+public:
+	FileView() noexcept = default;
+	// Create a view of contents that have already been read into memory.
+	explicit FileView(std::string contents) noexcept;
+	FileView(const FileView &) = delete;
+	FileView &operator=(const FileView &) = delete;
+	FileView(FileView &&other) noexcept;
+	FileView &operator=(FileView &&other) noexcept;
+	~FileView();
+
+	std::string_view Data() const noexcept;
+	size_t Size() const noexcept;
+	bool Empty() const noexcept;
+	// Check whether the view refers directly to the file's mapped memory.
+	bool IsMapped() const noexcept;
+
+
+private:
+	void Unmap() noexcept;
+
+
+private:
+	const char *mapped = nullptr;
+	size_t mappedSize = 0;
+	// The contents of a file that is not mapped.
+	std::string contents;
+};
@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Files.h"
 
+#include "FileTree.h"
+#include "FileView.h"
 #include "Logger.h"
 #include "ZipFile.h"
 
@@ -25,6 +27,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <iostream>
 #include <map>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <sstream>
 #include <stdexcept>
 
@@ -45,6 +49,19 @@ namespace {
 
 	shared_ptr<iostream> errorLog;
 
+	// A snapshot of the game's resources and plugins, so that looking for files
+	// in them does not need to go to the disk every time.
+	shared_mutex treeMutex;
+	FileTree fileTree;
+
+	// Anything that is changed through this class is no longer described
+	// correctly by the snapshot.
+	void Forget(const filesystem::path &path)
+	{
+		unique_lock<shared_mutex> lock(treeMutex);
+		fileTree.Forget(path);
+	}
+
 	// Open the given folder in a separate window.
 	void OpenFolder(const filesystem::path &path)
 	{
@@ -261,6 +278,12 @@ const filesystem::path &Files::Tests()
 
 vector<filesystem::path> Files::List(const filesystem::path &directory)
 {
+	{
+		shared_lock<shared_mutex> lock(treeMutex);
+		if(optional<vector<filesystem::path>> list = fileTree.List(directory))
+			return std::move(*list);
+	}
+
 	vector<filesystem::path> list;
 
 	if(!Exists(directory) || !is_directory(directory))
@@ -290,6 +313,12 @@ vector<filesystem::path> Files::List(const filesystem::path &directory)
 // Get a list of any directories in the given directory.
 vector<filesystem::path> Files::ListDirectories(const filesystem::path &directory)
 {
+	{
+		shared_lock<shared_mutex> lock(treeMutex);
+		if(optional<vector<filesystem::path>> list = fileTree.ListDirectories(directory))
+			return std::move(*list);
+	}
+
 	vector<filesystem::path> list;
 
 	if(!Exists(directory) || !is_directory(directory))
@@ -316,6 +345,12 @@ vector<filesystem::path> Files::ListDirectories(const filesystem::path &director
 
 vector<filesystem::path> Files::RecursiveList(const filesystem::path &directory)
 {
+	{
+		shared_lock<shared_mutex> lock(treeMutex);
+		if(optional<vector<filesystem::path>> list = fileTree.RecursiveList(directory))
+			return std::move(*list);
+	}
+
 	vector<filesystem::path> list;
 	if(!Exists(directory) || !is_directory(directory))
 	{
@@ -339,8 +374,25 @@ vector<filesystem::path> Files::RecursiveList(const filesystem::path &directory)
 
 
 
+// Scan the given directories, and answer questions about their contents from
+// memory from now on.
+void Files::Scan(const vector<filesystem::path> &directories)
+{
+	FileTree tree(directories);
+	unique_lock<shared_mutex> lock(treeMutex);
+	fileTree = std::move(tree);
+}
+
+
+
 bool Files::Exists(const filesystem::path &filePath)
 {
+	{
+		shared_lock<shared_mutex> lock(treeMutex);
+		if(optional<bool> exists = fileTree.Exists(filePath))
+			return *exists;
+	}
+
 	if(exists(filePath))
 		return true;
 
@@ -354,6 +406,11 @@ bool Files::Exists(const filesystem::path &filePath)
 
 filesystem::file_time_type Files::Timestamp(const filesystem::path &filePath)
 {
+	{
+		shared_lock<shared_mutex> lock(treeMutex);
+		if(optional<filesystem::file_time_type> time = fileTree.Timestamp(filePath))
+			return *time;
+	}
 	return last_write_time(filePath);
 }
 
@@ -361,6 +418,7 @@ filesystem::file_time_type Files::Timestamp(const filesystem::path &filePath)
 
 bool Files::Copy(const filesystem::path &from, const filesystem::path &to)
 {
+	Forget(to);
 #ifdef _WIN32
 	// Due to a mingw bug, the overwrite_existing flag is not respected on Windows.
 	// TODO: remove once it is fixed.
@@ -381,6 +439,8 @@ bool Files::Copy(const filesystem::path &from, const filesystem::path &to)
 
 void Files::Move(const filesystem::path &from, const filesystem::path &to)
 {
+	Forget(from);
+	Forget(to);
 	rename(from, to);
 }
 
@@ -388,6 +448,7 @@ void Files::Move(const filesystem::path &from, const filesystem::path &to)
 
 void Files::Delete(const filesystem::path &filePath)
 {
+	Forget(filePath);
 	remove_all(filePath);
 }
 
@@ -430,11 +491,12 @@ shared_ptr<iostream> Files::Open(const filesystem::path &path, bool write)
 	}
 
 	if(write)
-#ifdef _WIN32
-		return shared_ptr<iostream>{new fstream{path, ios::out}};
-#else
+	{
+		Forget(path);
+		// Write in binary mode on every platform, so that compressed data is not
+		// changed by line ending translation.
 		return shared_ptr<iostream>{new fstream{path, ios::out | ios::binary}};
-#endif
+	}
 	return shared_ptr<iostream>{new fstream{path, ios::in | ios::binary}};
 }
 
@@ -456,6 +518,20 @@ string Files::Read(shared_ptr<iostream> file)
 
 
 
+FileView Files::Map(const filesystem::path &path)
+{
+	if(exists(path))
+	{
+		FileView view = FileView::Map(path);
+		if(view.IsMapped())
+			return view;
+	}
+	// Files inside zipped plugins, and anything else that cannot be mapped, are read instead.
+	return FileView(Read(path));
+}
+
+
+
 void Files::Write(const filesystem::path &path, const string &data)
 {
 	Write(Open(path, true), data);
@@ -478,6 +554,7 @@ void Files::CreateFolder(const filesystem::path &path)
 	if(Exists(path))
 		return;
 
+	Forget(path);
 	if(filesystem::create_directory(path))
 		filesystem::permissions(path, filesystem::perms(filesystem::perms::owner_all));
 	else
@@ -515,6 +592,14 @@ void Files::LogErrorToFile(const string &message)
 		}
 	}
 
-	Write(errorLog, message);
-	*errorLog << endl;
+	// The log is only flushed once the logger has finished writing each batch of messages.
+	*errorLog << message << '\n';
+}
+
+
+
+void Files::FlushErrorLog()
+{
+	if(errorLog)
+		errorLog->flush();
 }
@@ -18,6 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <vector>
 
+class FileView;
+
 
 
 // File paths and file handling are different on each operating system. This
@@ -52,6 +54,11 @@ public:
 	// that it contains, recursively.
 	static std::vector<std::filesystem::path> RecursiveList(const std::filesystem::path &directory);
 
+	// Scan the given directories all at once, using several threads, and answer
+	// any later questions about the files in them from memory. Anything in them
+	// that is changed through this class is checked on the disk again.
+	static void Scan(const std::vector<std::filesystem::path> &directories);
+
 	static bool Exists(const std::filesystem::path &filePath);
 	static std::filesystem::file_time_type Timestamp(const std::filesystem::path &filePath);
 	static bool Copy(const std::filesystem::path &from, const std::filesystem::path &to);
@@ -69,6 +76,8 @@ public:
 	static std::shared_ptr<std::iostream> Open(const std::filesystem::path &path, bool write = false);
 	static std::string Read(const std::filesystem::path &path);
 	static std::string Read(std::shared_ptr<std::iostream> file);
+	// Get a read-only view of a file's contents, without copying them if possible.
+	static FileView Map(const std::filesystem::path &path);
 	static void Write(const std::filesystem::path &path, const std::string &data);
 	static void Write(std::shared_ptr<std::iostream> file, const std::string &data);
 	static void CreateFolder(const std::filesystem::path &path);
@@ -82,4 +91,5 @@ public:
 	// and not directly here to ensure that other logging actions also
 	// happen (and to ensure thread safety on the logging).
 	static void LogErrorToFile(const std::string &message);
+	static void FlushErrorLog();
 };
@@ -71,6 +71,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cassert>
 #include <filesystem>
 #include <iostream>
+#include <mutex>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -318,6 +319,16 @@ void GameData::Revert()
 	objects.wormholes.Revert(defaultWormholes);
 	objects.persons.Revert(defaultPersons);
 	objects.substitutions.Revert(defaultSubstitutions);
+	// Any system might have changed, so they all need to be updated.
+	objects.updateAllSystems = true;
+	{
+		lock_guard<mutex> lock(objects.routeHeuristicMutex);
+		objects.routeHeuristics.clear();
+	}
+	{
+		lock_guard<mutex> lock(objects.locationIndexMutex);
+		objects.locationIndex.reset();
+	}
 
 	activeGamerules = objects.gamerulesPresets.Get("Default");
 
@@ -732,6 +743,20 @@ const std::set<std::string> &GameData::UniverseWormholeRequirements()
 
 
 
+shared_ptr<const RouteHeuristic> GameData::GetRouteHeuristic(double jumpRange)
+{
+	return objects.GetRouteHeuristic(jumpRange);
+}
+
+
+
+shared_ptr<const LocationIndex> GameData::GetLocationIndex()
+{
+	return objects.GetLocationIndex();
+}
+
+
+
 const Government *GameData::PlayerGovernment()
 {
 	return playerGovernment;
@@ -938,6 +963,11 @@ const Gamerules &GameData::DefaultGamerules()
 
 void GameData::LoadSources(TaskQueue &queue)
 {
+	// Find everything in the game's resources and plugins at once, instead of
+	// listing each directory as it is needed.
+	Files::Scan({Files::Data(), Files::Images(), Files::Sounds(), Files::Resources() / "shaders",
+		Files::GlobalPlugins(), Files::UserPlugins()});
+
 	sources.clear();
 	sources.push_back(Files::Resources());
 
@@ -46,6 +46,7 @@ class Government;
 class Hazard;
 class ImageSet;
 class Interface;
+class LocationIndex;
 class MaskManager;
 class Minable;
 class Mission;
@@ -58,6 +59,7 @@ class Planet;
 class PlayerInfo;
 class Point;
 class Politics;
+class RouteHeuristic;
 class Shader;
 class Ship;
 class Sprite;
@@ -151,6 +153,10 @@ public:
 	static const Set<Gamerules> &GamerulesPresets();
 
 	static const std::set<std::string> &UniverseWormholeRequirements();
+	// Get lower bounds on route lengths for ships with the given jump range.
+	static std::shared_ptr<const RouteHeuristic> GetRouteHeuristic(double jumpRange);
+	// Get the lists of which systems and planets have each attribute and government.
+	static std::shared_ptr<const LocationIndex> GetLocationIndex();
 
 	static ConditionsStore &GlobalConditions();
 
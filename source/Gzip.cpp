@@ -0,0 +1,143 @@
+/* Gzip.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Gzip.h"
+
+#include <zlib.h>
+
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// Adding 16 to the window size tells zlib to use a gzip header instead of a
+	// zlib header. For decompression, adding 32 accepts either one.
+	const int GZIP_WINDOW_BITS = 15 + 16;
+	const int DETECT_WINDOW_BITS = 15 + 32;
+
+	// The size of each block of compressed or decompressed output.
+	const size_t BLOCK_SIZE = 64 * 1024;
+}
+
+
+
+Gzip::Compressor::Compressor(DataWriter::Sink sink)
+	: sink(std::move(sink)), stream(new z_stream{}), output(BLOCK_SIZE)
+{
+	if(deflateInit2(stream.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		throw runtime_error("Unable to initialize gzip compression.");
+}
+
+
+
+Gzip::Compressor::~Compressor()
+{
+	deflateEnd(stream.get());
+}
+
+
+
+void Gzip::Compressor::Write(const char *data, size_t size)
+{
+	// Very large blocks need to be passed to zlib in pieces.
+	while(size && !isFinished)
+	{
+		const uInt piece = static_cast<uInt>(min<size_t>(size, BLOCK_SIZE));
+		stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+		stream->avail_in = piece;
+		Deflate(Z_NO_FLUSH);
+		data += piece;
+		size -= piece;
+	}
+}
+
+
+
+// Write out the end of the compressed data.
+void Gzip::Compressor::Finish()
+{
+	if(isFinished)
+		return;
+
+	stream->next_in = nullptr;
+	stream->avail_in = 0;
+	Deflate(Z_FINISH);
+	isFinished = true;
+}
+
+
+
+void Gzip::Compressor::Deflate(int flush)
+{
+	do {
+		stream->next_out = reinterpret_cast<Bytef *>(output.data());
+		stream->avail_out = static_cast<uInt>(output.size());
+		deflate(stream.get(), flush);
+		const size_t size = output.size() - stream->avail_out;
+		if(size)
+			sink(output.data(), size);
+	} while(!stream->avail_out);
+}
+
+
+
+// Check if the given data starts with a gzip header.
+bool Gzip::IsCompressed(string_view data)
+{
+	return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f
+		&& static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+
+
+// Compress the given data.
+string Gzip::Compress(string_view data)
+{
+	string result;
+	Compressor compressor([&result](const char *block, size_t size) { result.append(block, size); });
+	compressor.Write(data.data(), data.size());
+	compressor.Finish();
+	return result;
+}
+
+
+
+// Decompress the given data, stopping once at least the given number of bytes
+// have been decompressed.
+string Gzip::Decompress(string_view data, size_t limit)
+{
+	z_stream stream{};
+	if(inflateInit2(&stream, DETECT_WINDOW_BITS) != Z_OK)
+		return string();
+
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+	stream.avail_in = static_cast<uInt>(data.size());
+
+	// Text compresses well, so guess that the result will be several times larger.
+	string result;
+	int status = Z_OK;
+	while(status == Z_OK && result.size() < limit)
+	{
+		const size_t size = result.size();
+		result.resize(size + max(BLOCK_SIZE, min<size_t>(data.size() * 4, limit - size)));
+		stream.next_out = reinterpret_cast<Bytef *>(&result[size]);
+		stream.avail_out = static_cast<uInt>(result.size() - size);
+		status = inflate(&stream, Z_NO_FLUSH);
+		result.resize(result.size() - stream.avail_out);
+	}
+	inflateEnd(&stream);
+	return result;
+}
@@ -0,0 +1,68 @@
+/* Gzip.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "DataWriter.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct z_stream_s;
+
+
+
+// Functions for reading and writing gzip compressed data, which is used for
+// compressed saved games. Compressed files keep their usual names, and are
+// recognized by the gzip header at the start of the file.
+class Gzip {
+public:
+	// Compresses data a block at a time, passing the compressed data on to the
+	// given sink as it is produced.
+	class Compressor {
+	public:
+		explicit Compressor(DataWriter::Sink sink);
+		Compressor(const Compressor &) = delete;
+		Compressor &operator=(const Compressor &) = delete;
+		~Compressor();
+
+		void Write(const char *data, size_t size);
+		// Write out the end of the compressed data. Nothing can be written after this.
+		void Finish();
+
+	private:
+		void Deflate(int flush);
+
+	private:
+		DataWriter::Sink sink;
+		std::unique_ptr<z_stream_s> stream;
+		std::vector<char> output;
+		bool isFinished = false;
+	};
+
+
+public:
+	// Check if the given data starts with a gzip header.
+	static bool IsCompressed(std::string_view data);
+	// Compress the given data.
+	static std::string Compress(std::string_view data);
+	// Decompress the given data, stopping once at least the given number of
+	// bytes have been decompressed. Returns as much as could be decompressed
+	// if the data is incomplete or corrupt.
+	static std::string Decompress(std::string_view data, size_t limit = std::string::npos);
+};
@@ -19,6 +19,56 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	// Set the value stored under the given name. If the name is not in the map
+	// yet, reuse one of the spare entries for it if there are any.
+	template<class Map, class Value>
+	void Set(Map &map, vector<typename Map::node_type> &spare, const string &name, const Value &value)
+	{
+		auto it = map.find(name);
+		if(it != map.end())
+			it->second = value;
+		else if(spare.empty())
+			map.emplace(name, value);
+		else
+		{
+			typename Map::node_type node = std::move(spare.back());
+			spare.pop_back();
+			node.key() = name;
+			node.mapped() = value;
+			map.insert(std::move(node));
+		}
+	}
+
+	// Move every entry out of the given map or set and into the spare entries.
+	template<class Container>
+	void Recycle(Container &container, vector<typename Container::node_type> &spare)
+	{
+		while(!container.empty())
+			spare.push_back(container.extract(container.begin()));
+	}
+}
+
+
+
+// Forget everything that has been set, but keep the storage for it.
+void Information::Clear()
+{
+	region = Rectangle();
+	hasCustomRegion = false;
+
+	Recycle(sprites, spareSprites);
+	Recycle(spriteUnits, spareSpriteUnits);
+	Recycle(spriteFrames, spareSpriteFrames);
+	Recycle(spriteSwizzles, spareSpriteSwizzles);
+	Recycle(strings, spareStrings);
+	Recycle(bars, spareBars);
+	Recycle(barSegments, spareBarSegments);
+	Recycle(conditions, spareConditions);
+
+	outlineColor = Color();
+}
+
 
 
 void Information::SetRegion(const Rectangle &rect)
@@ -46,10 +96,10 @@ bool Information::HasCustomRegion() const
 void Information::SetSprite(const string &name, const Sprite *sprite, const Point &unit,
 	float frame, const Swizzle *swizzle)
 {
-	sprites[name] = sprite;
-	spriteUnits[name] = unit;
-	spriteFrames[name] = frame;
-	spriteSwizzles[name] = swizzle;
+	Set(sprites, spareSprites, name, sprite);
+	Set(spriteUnits, spareSpriteUnits, name, unit);
+	Set(spriteFrames, spareSpriteFrames, name, frame);
+	Set(spriteSwizzles, spareSpriteSwizzles, name, swizzle);
 }
 
 
@@ -92,7 +142,7 @@ const Swizzle *Information::GetSwizzle(const string &name) const
 
 void Information::SetString(const string &name, const string &value)
 {
-	strings[name] = value;
+	Set(strings, spareStrings, name, value);
 }
 
 
@@ -109,8 +159,8 @@ const string &Information::GetString(const string &name) const
 
 void Information::SetBar(const string &name, double value, double segments)
 {
-	bars[name] = value;
-	barSegments[name] = segments;
+	Set(bars, spareBars, name, value);
+	Set(barSegments, spareBarSegments, name, segments);
 }
 
 
@@ -135,7 +185,17 @@ double Information::BarSegments(const string &name) const
 
 void Information::SetCondition(const string &condition)
 {
-	conditions.insert(condition);
+	if(conditions.contains(condition))
+		return;
+	if(spareConditions.empty())
+		conditions.insert(condition);
+	else
+	{
+		auto node = std::move(spareConditions.back());
+		spareConditions.pop_back();
+		node.value() = condition;
+		conditions.insert(std::move(node));
+	}
 }
 
 
@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class Sprite;
 
@@ -32,6 +33,10 @@ class Sprite;
 // of how that information is laid out or shown.
 class Information {
 public:
+	// Forget everything that has been set. The storage for it is kept, so that
+	// an object that is refilled every frame does not need to allocate it again.
+	void Clear();
+
 	void SetRegion(const Rectangle &rect);
 	const Rectangle &GetCustomRegion() const;
 	bool HasCustomRegion() const;
@@ -72,4 +77,15 @@ private:
 	std::set<std::string> conditions;
 
 	Color outlineColor;
+
+	// The entries that were removed by Clear(), to be reused by the next ones
+	// that are set instead of allocating new ones.
+	std::vector<decltype(sprites)::node_type> spareSprites;
+	std::vector<decltype(spriteUnits)::node_type> spareSpriteUnits;
+	std::vector<decltype(spriteFrames)::node_type> spareSpriteFrames;
+	std::vector<decltype(spriteSwizzles)::node_type> spareSpriteSwizzles;
+	std::vector<decltype(strings)::node_type> spareStrings;
+	std::vector<decltype(bars)::node_type> spareBars;
+	std::vector<decltype(barSegments)::node_type> spareBarSegments;
+	std::vector<decltype(conditions)::node_type> spareConditions;
 };
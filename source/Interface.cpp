@@ -29,6 +29,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Panel.h"
 #include "shader/PointerShader.h"
 #include "Rectangle.h"
+#include "shader/RenderStatistics.h"
 #include "shader/RingShader.h"
 #include "Screen.h"
 #include "image/Sprite.h"
@@ -38,6 +39,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 using namespace std;
 
@@ -65,6 +67,9 @@ namespace {
 
 
 
+vector<weak_ptr<Interface::Buffer>> Interface::drawnBuffers;
+
+
 // Load an interface.
 void Interface::Load(const DataNode &node)
 {
@@ -77,6 +82,8 @@ void Interface::Load(const DataNode &node)
 	points.clear();
 	values.clear();
 	lists.clear();
+	lastInputs.Clear();
+	buffer.reset();
 
 	// First, figure out the anchor point of this interface.
 	Point anchor = ParseAlignment(node, 2);
@@ -149,8 +156,104 @@ void Interface::Load(const DataNode &node)
 // Draw this interface.
 void Interface::Draw(const Information &info, Panel *panel) const
 {
+	// Find out which elements are visible, and what they will draw. Buttons
+	// must be placed every time, even if nothing needs to be drawn again.
+	inputs.Clear();
+	inputs.Add(Screen::Width());
+	inputs.Add(Screen::Height());
+	inputs.Add(Screen::Zoom());
+	inputs.Add(Font::UnderlinesShown());
+	inputs.Add(info.HasCustomRegion());
+	if(info.HasCustomRegion())
+	{
+		const Rectangle &region = info.GetCustomRegion();
+		inputs.Add(region.Left());
+		inputs.Add(region.Top());
+		inputs.Add(region.Right());
+		inputs.Add(region.Bottom());
+	}
+	placements.clear();
 	for(const unique_ptr<Element> &element : elements)
-		element->Draw(info, panel);
+	{
+		Rectangle box;
+		int state = 0;
+		bool isVisible = element->Prepare(info, panel, box, state);
+		inputs.Add(isVisible ? state : -1);
+		if(isVisible)
+		{
+			element->AddInputs(info, state, inputs);
+			placements.push_back({element.get(), box, state});
+		}
+	}
+
+	if(!buffer || !buffer->renderBuffer || inputs != bufferInputs)
+	{
+		// Drawing into the buffer only pays off if the interface then stays the
+		// same for a while, so only do so if it has not changed since last time.
+		bool isUnchanged = (inputs == lastInputs);
+		swap(inputs, lastInputs);
+		if(!isUnchanged)
+		{
+			for(const Placement &it : placements)
+				it.element->Draw(info, it.box, it.state);
+			return;
+		}
+
+		// Most interfaces only cover a small part of the screen, so make the buffer
+		// just big enough for what is drawn into it. The elements must be laid out
+		// before drawing into the buffer, which changes the screen dimensions.
+		const Point corner = Screen::TopLeft();
+		Point topLeft = Screen::BottomRight();
+		Point bottomRight = corner;
+		for(Placement &it : placements)
+		{
+			it.rect = it.element->Align(info, it.box, it.state);
+			Rectangle area = it.element->DrawnArea(it.rect);
+			topLeft = Point(min(topLeft.X(), area.Left()), min(topLeft.Y(), area.Top()));
+			bottomRight = Point(max(bottomRight.X(), area.Right()), max(bottomRight.Y(), area.Bottom()));
+		}
+		// Line the buffer's pixels up with the screen's, and keep it on the screen.
+		topLeft -= corner;
+		bottomRight -= corner;
+		topLeft = Point(max(0., floor(topLeft.X())), max(0., floor(topLeft.Y())));
+		bottomRight = Point(min<double>(Screen::Width(), ceil(bottomRight.X())),
+			min<double>(Screen::Height(), ceil(bottomRight.Y())));
+		const Point size = bottomRight - topLeft;
+		if(size.X() <= 0. || size.Y() <= 0.)
+			return;
+
+		if(!buffer)
+			buffer = make_shared<Buffer>();
+		if(!buffer->renderBuffer)
+			drawnBuffers.push_back(buffer);
+		if(!buffer->renderBuffer || buffer->renderBuffer->Dimensions() != size)
+			buffer->renderBuffer = make_unique<RenderBuffer>(size);
+		buffer->center = corner + .5 * (topLeft + bottomRight);
+		auto target = buffer->renderBuffer->SetTarget();
+		for(const Placement &it : placements)
+			it.element->DrawAligned(info, it.rect - buffer->center, it.state);
+		target.Deactivate();
+		bufferInputs = lastInputs;
+	}
+	buffer->lastDrawn = RenderStatistics::Frames();
+	buffer->renderBuffer->Draw(buffer->center);
+}
+
+
+
+// Free the buffers of any interfaces that were not drawn in the last frame.
+void Interface::FreeUnusedBuffers()
+{
+	const int64_t frame = RenderStatistics::Frames();
+	erase_if(drawnBuffers, [frame](const weak_ptr<Buffer> &it) -> bool {
+		shared_ptr<Buffer> buffer = it.lock();
+		// The frame counter has already moved on to the next frame.
+		if(buffer && buffer->lastDrawn >= frame - 1)
+			return false;
+		if(buffer)
+			buffer->renderBuffer.reset();
+		return true;
+	});
 }
 
 
@@ -205,6 +308,41 @@ const vector<double> &Interface::GetList(const string &name) const
 
 
 
+// Members of the Inputs class:
+
+void Interface::Inputs::Clear()
+{
+	values.clear();
+	pointers.clear();
+	text.clear();
+}
+
+
+
+void Interface::Inputs::Add(double value)
+{
+	values.push_back(value);
+}
+
+
+
+void Interface::Inputs::Add(const void *pointer)
+{
+	pointers.push_back(pointer);
+}
+
+
+
+void Interface::Inputs::Add(const string &value)
+{
+	// Remember the length of each string, so that different strings that are
+	// joined together to the same text still count as different.
+	values.push_back(value.length());
+	text += value;
+}
+
+
+
 // Members of the AnchoredPoint class:
 
 // Get the point's location, given the current screen dimensions.
@@ -330,34 +468,64 @@ void Interface::Element::Load(const DataNode &node, const Point &globalAnchor)
 
 
 
-// Draw this element, relative to the given anchor point. If this is a
-// button, it will add a clickable zone to the given panel.
-void Interface::Element::Draw(const Information &info, Panel *panel) const
+// Check if this element is visible, and if so, get its bounding box and its
+// state. If this is a button, it will add a clickable zone to the given panel.
+bool Interface::Element::Prepare(const Information &info, Panel *panel, Rectangle &box, int &state) const
 {
 	if(!info.HasCondition(visibleIf))
-		return;
+		return false;
 
 	// Get the bounding box of this element, relative to the anchor point.
-	Rectangle box = (info.HasCustomRegion() ? Bounds(info) : Bounds());
+	box = (info.HasCustomRegion() ? Bounds(info) : Bounds());
 	// Check if this element is active.
-	int state = info.HasCondition(activeIf);
+	state = info.HasCondition(activeIf);
 	// Check if the mouse is hovering over this element.
 	state += (state && box.Contains(UI::GetMouse()));
 	// Place buttons even if they are inactive, in case the UI wants to show a
 	// message explaining why the button is inactive.
 	if(panel)
 		Place(box, panel);
+	return true;
+}
 
+
+
+// Draw this element, aligned within the given bounding box.
+void Interface::Element::Draw(const Information &info, const Rectangle &box, int state) const
+{
+	Draw(Align(info, box, state), info, state);
+}
+
+
+
+// Get the rectangle this element is drawn in, aligned within the given bounding box.
+Rectangle Interface::Element::Align(const Information &info, const Rectangle &box, int state) const
+{
 	// Figure out how the element should be aligned within its bounding box.
 	Point nativeDimensions = NativeDimensions(info, state);
 	Point slack = .5 * (box.Dimensions() - nativeDimensions) - padding;
-	Rectangle rect(box.Center() + alignment * slack, nativeDimensions);
+	return Rectangle(box.Center() + alignment * slack, nativeDimensions);
+}
+
 
+
+// Draw this element in a rectangle that was found by Align().
+void Interface::Element::DrawAligned(const Information &info, const Rectangle &rect, int state) const
+{
 	Draw(rect, info, state);
 }
 
 
 
+// Get the area that drawing this element in the given rectangle covers.
+Rectangle Interface::Element::DrawnArea(const Rectangle &rect) const
+{
+	double overhang = Overhang(rect);
+	return Rectangle(rect.Center(), rect.Dimensions() + Point(2. * overhang, 2. * overhang));
+}
+
+
+
 // Set the conditions that control when this element is visible and active.
 // An empty string means it is always visible or active.
 void Interface::Element::SetConditions(const string &visible, const string &active)
@@ -407,6 +575,14 @@ void Interface::Element::Draw(const Rectangle &rect, const Information &info, in
 
 
 
+// Report how far outside of the given rectangle this element may draw.
+double Interface::Element::Overhang(const Rectangle &rect) const
+{
+	return 0.;
+}
+
+
+
 // Add any click handlers needed for this element. This will only be
 // called if the element is visible and active.
 void Interface::Element::Place(const Rectangle &bounds, Panel *panel) const
@@ -415,6 +591,14 @@ void Interface::Element::Place(const Rectangle &bounds, Panel *panel) const
 
 
 
+// Add the values that this element reads from the Information when it is
+// drawn in the given state to the given inputs.
+void Interface::Element::AddInputs(const Information &info, int state, Inputs &inputs) const
+{
+}
+
+
+
 // Members of the ImageElement class:
 
 // Constructor.
@@ -514,6 +698,32 @@ void Interface::ImageElement::Draw(const Rectangle &rect, const Information &inf
 
 
 
+void Interface::ImageElement::AddInputs(const Information &info, int state, Inputs &inputs) const
+{
+	// A sprite's size and texture change when it is loaded or unloaded.
+	const Sprite *sprite = GetSprite(info, state);
+	inputs.Add(sprite);
+	if(sprite)
+	{
+		inputs.Add(sprite->Width());
+		inputs.Add(sprite->Height());
+		inputs.Add(sprite->Texture());
+	}
+	if(!name.empty())
+	{
+		const Point &unit = info.GetSpriteUnit(name);
+		inputs.Add(unit.X());
+		inputs.Add(unit.Y());
+		inputs.Add(info.GetSpriteFrame(name));
+		inputs.Add(info.GetSwizzle(name));
+	}
+	if(isColored)
+		for(int i = 0; i < 4; ++i)
+			inputs.Add(info.GetOutlineColor().Get()[i]);
+}
+
+
+
 const Sprite *Interface::ImageElement::GetSprite(const Information &info, int state) const
 {
 	return name.empty() ? sprite[state] : info.GetSprite(name);
@@ -588,6 +798,14 @@ void Interface::TextElement::Place(const Rectangle &bounds, Panel *panel) const
 
 
 
+void Interface::TextElement::AddInputs(const Information &info, int state, Inputs &inputs) const
+{
+	if(isDynamic)
+		inputs.Add(info.GetString(str));
+}
+
+
+
 // Fill in any undefined state colors.
 void Interface::TextElement::FinishLoadingColors()
 {
@@ -839,6 +1057,22 @@ void Interface::BarElement::Draw(const Rectangle &rect, const Information &info,
 
 
 
+// Lines and rings are as wide as the bar, and centered on the edge of its rectangle.
+double Interface::BarElement::Overhang(const Rectangle &rect) const
+{
+	return width;
+}
+
+
+
+void Interface::BarElement::AddInputs(const Information &info, int state, Inputs &inputs) const
+{
+	inputs.Add(info.BarValue(name));
+	inputs.Add(info.BarSegments(name));
+}
+
+
+
 // Members of the PointerElement class:
 
 // Constructor.
@@ -893,6 +1127,15 @@ void Interface::PointerElement::Draw(const Rectangle &rect, const Information &i
 
 
 
+// The pointer's tip is at the center of its rectangle, and it points away from
+// its base in any direction.
+double Interface::PointerElement::Overhang(const Rectangle &rect) const
+{
+	return max(rect.Width(), rect.Height());
+}
+
+
+
 // Members of the FillElement class:
 
 // Constructor.
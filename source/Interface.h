@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Color.h"
 #include "Point.h"
 #include "Rectangle.h"
+#include "RenderBuffer.h"
 #include "text/Truncate.h"
 #include "text/WrappedText.h"
 
@@ -35,7 +36,10 @@ class Sprite;
 
 
 // Class representing a user interface, specified in a data file and filled with
-// the contents of an Information object.
+// the contents of an Information object. Most interfaces look the same from one
+// frame to the next, so once an interface has been drawn twice in a row with the
+// same contents, it is drawn into a buffer that is reused until they change. The
+// buffer is freed once the interface goes a frame without being drawn.
 class Interface {
 public:
 	void Load(const DataNode &node);
@@ -43,6 +47,9 @@ public:
 	// Draw this interface. If the given panel is not null, also register any
 	// buttons in this interface with the panel's list of clickable zones.
 	void Draw(const Information &info, Panel *panel = nullptr) const;
+	// Free the buffers of any interfaces that were not drawn in the last frame.
+	// This must be called once per frame.
+	static void FreeUnusedBuffers();
 
 	// Get the location of a named point or box.
 	bool HasPoint(const std::string &name) const;
@@ -57,6 +64,24 @@ public:
 
 
 private:
+	// Everything that decides what an interface looks like: the screen, the
+	// state of each element, and the values that the elements read from the
+	// Information. If two sets of inputs are equal, so is what is drawn.
+	class Inputs {
+	public:
+		void Clear();
+		void Add(double value);
+		void Add(const void *pointer);
+		void Add(const std::string &value);
+
+		bool operator==(const Inputs &other) const = default;
+
+	private:
+		std::vector<double> values;
+		std::vector<const void *> pointers;
+		std::string text;
+	};
+
 	class AnchoredPoint {
 	public:
 		// Get the point's location, given the current screen dimensions.
@@ -87,9 +112,21 @@ private:
 		// this element is used to calculate the element's position.
 		void Load(const DataNode &node, const Point &globalAnchor);
 
-		// Draw this element, relative to the given anchor point. If this is a
-		// button, it will add a clickable zone to the given panel.
-		void Draw(const Information &info, Panel *panel) const;
+		// Check if this element is visible, and if so, get its bounding box and
+		// its state. If this is a button, it will add a clickable zone to the
+		// given panel.
+		bool Prepare(const Information &info, Panel *panel, Rectangle &box, int &state) const;
+		// Draw this element, aligned within the given bounding box.
+		void Draw(const Information &info, const Rectangle &box, int state) const;
+		// Get the rectangle this element is drawn in, aligned within the given
+		// bounding box, and draw it in a rectangle that was found that way.
+		Rectangle Align(const Information &info, const Rectangle &box, int state) const;
+		void DrawAligned(const Information &info, const Rectangle &rect, int state) const;
+		// Get the area that drawing this element in the given rectangle covers.
+		Rectangle DrawnArea(const Rectangle &rect) const;
+		// Add the values that this element reads from the Information when it is
+		// drawn in the given state to the given inputs.
+		virtual void AddInputs(const Information &info, int state, Inputs &inputs) const;
 
 		// Set the conditions that control when this element is visible and active.
 		// An empty string means it is always visible or active.
@@ -108,6 +145,8 @@ private:
 		virtual Point NativeDimensions(const Information &info, int state) const;
 		// Draw this element in the given rectangle.
 		virtual void Draw(const Rectangle &rect, const Information &info, int state) const;
+		// Report how far outside of the given rectangle this element may draw.
+		virtual double Overhang(const Rectangle &rect) const;
 		// Add any click handlers needed for this element. This will only be
 		// called if the element is visible and active.
 		virtual void Place(const Rectangle &bounds, Panel *panel) const;
@@ -134,6 +173,7 @@ private:
 		virtual Point NativeDimensions(const Information &info, int state) const override;
 		// Draw this element in the given rectangle.
 		virtual void Draw(const Rectangle &rect, const Information &info, int state) const override;
+		virtual void AddInputs(const Information &info, int state, Inputs &inputs) const override;
 
 	private:
 		const Sprite *GetSprite(const Information &info, int state) const;
@@ -162,6 +202,7 @@ private:
 		// Add any click handlers needed for this element. This will only be
 		// called if the element is visible and active.
 		virtual void Place(const Rectangle &bounds, Panel *panel) const override;
+		virtual void AddInputs(const Information &info, int state, Inputs &inputs) const override;
 
 		// Fill in any undefined state colors.
 		void FinishLoadingColors();
@@ -222,6 +263,8 @@ private:
 		virtual bool ParseLine(const DataNode &node) override;
 		// Draw this element in the given rectangle.
 		virtual void Draw(const Rectangle &rect, const Information &info, int state) const override;
+		virtual double Overhang(const Rectangle &rect) const override;
+		virtual void AddInputs(const Information &info, int state, Inputs &inputs) const override;
 
 	private:
 		std::string name;
@@ -246,6 +289,7 @@ private:
 		virtual bool ParseLine(const DataNode &node) override;
 		// Draw this element in the given rectangle.
 		virtual void Draw(const Rectangle &rect, const Information &info, int state) const override;
+		virtual double Overhang(const Rectangle &rect) const override;
 
 	private:
 		const Color *color = nullptr;
@@ -269,10 +313,42 @@ private:
 		const Color *color = nullptr;
 	};
 
+	// Where a visible element is to be drawn, and in what state. The rectangle
+	// it is aligned in is only found when it is drawn into the buffer.
+	class Placement {
+	public:
+		const Element *element;
+		Rectangle box;
+		int state;
+		Rectangle rect;
+	};
+
+	// The buffer an interface is drawn into, the part of the screen it covers,
+	// and the last frame it was drawn in.
+	class Buffer {
+	public:
+		std::unique_ptr<RenderBuffer> renderBuffer;
+		Point center;
+		int64_t lastDrawn = 0;
+	};
+
 
 private:
 	std::vector<std::unique_ptr<Element>> elements;
 	std::map<std::string, Element> points;
 	std::map<std::string, double> values;
 	std::map<std::string, std::vector<double>> lists;
+
+	// The visible elements and the inputs of the interface as it is being
+	// drawn, the inputs it had the last time it was drawn, and the ones it had
+	// when it was drawn into the buffer.
+	mutable std::vector<Placement> placements;
+	mutable Inputs inputs;
+	mutable Inputs lastInputs;
+	mutable Inputs bufferInputs;
+	mutable std::shared_ptr<Buffer> buffer;
+
+	// Every buffer that currently holds a render buffer, so that it can be freed
+	// if its interface is not drawn.
+	static std::vector<std::weak_ptr<Buffer>> drawnBuffers;
 };
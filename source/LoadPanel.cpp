@@ -19,7 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Color.h"
 #include "Command.h"
 #include "ConversationPanel.h"
-#include "DataFile.h"
+#include "DataNode.h"
 #include "DialogPanel.h"
 #include "text/DisplayText.h"
 #include "Files.h"
@@ -37,6 +37,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlayerInfo.h"
 #include "Preferences.h"
 #include "Rectangle.h"
+#include "SavedGameIndex.h"
+#include "SaveWriter.h"
 #include "shader/StarField.h"
 #include "StartConditionsPanel.h"
 #include "text/Truncate.h"
@@ -55,8 +57,10 @@ namespace {
 	string FileDate(const filesystem::path &filename)
 	{
 		string date = "0000-00-00";
-		DataFile file(filename);
-		for(const DataNode &node : file)
+		shared_ptr<const DataNode> header = SavedGameIndex::Header(filename);
+		if(!header)
+			return date;
+		for(const DataNode &node : *header)
 			if(node.Token(0) == "date")
 			{
 				int year = node.Value(3);
@@ -493,8 +497,13 @@ bool LoadPanel::Scroll(double dx, double dy)
 
 void LoadPanel::UpdateLists()
 {
+	// Make sure any saves that are still being written are finished first.
+	SaveWriter::Wait();
 	PilotProfile::LoadProfiles();
 	pilots = PilotProfile::GetProfileMap();
+	// Bring the index of saved games up to date in the background, so that
+	// selecting a save usually does not need to read it.
+	SavedGameIndex::Refresh();
 
 	if(!pilots.empty())
 	{
@@ -542,6 +551,7 @@ void LoadPanel::SnapshotCallback(const string &name)
 void LoadPanel::WriteSnapshot(const filesystem::path &sourceFile, const filesystem::path &snapshotName)
 {
 	// Copy the autosave to a new, named file.
+	SaveWriter::Wait();
 	if(Files::Copy(sourceFile, snapshotName))
 	{
 		UpdateLists();
@@ -579,6 +589,7 @@ void LoadPanel::LoadCallback()
 
 void LoadPanel::DeletePilot(const string &)
 {
+	SaveWriter::Wait();
 	loadedInfo.Clear();
 	if(selectedPilot == player.Pilot())
 		player.Clear();
@@ -596,6 +607,7 @@ void LoadPanel::DeletePilot(const string &)
 
 void LoadPanel::DeleteSave()
 {
+	SaveWriter::Wait();
 	loadedInfo.Clear();
 	string pilot = selectedPilot->Identifier();
 	filesystem::path path = Files::Saves() / selectedFile;
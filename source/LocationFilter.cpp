@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DistanceMap.h"
 #include "GameData.h"
 #include "Government.h"
+#include "LocationIndex.h"
 #include "Planet.h"
 #include "Port.h"
 #include "Random.h"
@@ -30,7 +31,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 
 #include <algorithm>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <numeric>
+#include <vector>
 
 using namespace std;
 
@@ -71,14 +76,14 @@ namespace {
 		return false;
 	}
 
-	// Check if the given system is within the given distance of the center.
-	int Distance(const System *center, const System *system, int maximum, DistanceCalculationSettings distanceSettings)
-	{
-		// This function should only ever be called from the main thread, but
-		// just to be sure, use mutex protection on the static locals.
-		static mutex distanceMutex;
-		lock_guard<mutex> lock(distanceMutex);
+	// This should only ever be used from the main thread, but just to be sure,
+	// use mutex protection on the cached distance map.
+	mutex distanceMutex;
 
+	// Get a distance map from the given center that extends at least as far as
+	// the given maximum. The caller must hold the distance mutex.
+	const DistanceMap &CachedDistanceMap(const System *center, int maximum, DistanceCalculationSettings distanceSettings)
+	{
 		static const System *previousCenter = center;
 		static DistanceMap distance(
 			center,
@@ -103,11 +108,52 @@ namespace {
 				maximum
 			);
 		}
+		return distance;
+	}
+
+	// Check if the given system is within the given distance of the center.
+	int Distance(const System *center, const System *system, int maximum, DistanceCalculationSettings distanceSettings)
+	{
+		lock_guard<mutex> lock(distanceMutex);
+		const DistanceMap &distance = CachedDistanceMap(center, maximum, distanceSettings);
+
 		// If the distance is greater than the maximum, this is not a match.
 		int d = distance.Days(*system);
 		return (d > maximum) ? -1 : d;
 	}
 
+	// Get all the systems that are within the given range of distances from the center.
+	set<const System *> WithinDistance(const System *center, int minimum, int maximum,
+		DistanceCalculationSettings distanceSettings)
+	{
+		lock_guard<mutex> lock(distanceMutex);
+		const DistanceMap &distance = CachedDistanceMap(center, maximum, distanceSettings);
+
+		set<const System *> result;
+		for(const System *system : distance.Systems())
+		{
+			int d = distance.Days(*system);
+			if(d >= minimum && d <= maximum)
+				result.insert(result.end(), system);
+		}
+		return result;
+	}
+
+	// Narrow down a sorted list of candidates to those that are also in the given list.
+	void Narrow(vector<int> &candidates, bool &narrowed, const vector<int> &subset)
+	{
+		if(!narrowed)
+			candidates = subset;
+		else
+		{
+			vector<int> both;
+			set_intersection(candidates.begin(), candidates.end(), subset.begin(), subset.end(),
+				back_inserter(both));
+			candidates = std::move(both);
+		}
+		narrowed = true;
+	}
+
 	// Check that at least one neighbor of the hub system matches, for each of the neighbor filters.
 	// False if at least one filter fails to match, true if all filters find at least one match.
 	bool MatchesNeighborFilters(const list<LocationFilter> &neighborFilters, const System *hub, const System *origin)
@@ -480,11 +526,16 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 // Pick a random system that matches this filter, based on the given origin.
 const System *LocationFilter::PickSystem(const System *origin) const
 {
-	// Find a planet that satisfies the filter.
+	shared_ptr<const LocationIndex> index = GameData::GetLocationIndex();
+	const vector<const System *> &allSystems = index->Systems();
+
+	// Find a system that satisfies the filter. Only the systems that could
+	// possibly match need to be checked, and they are checked in the same order
+	// as they are in GameData::Systems().
 	vector<const System *> options;
-	for(const auto &it : GameData::Systems())
+	for(int i : SystemCandidates(*index, origin))
 	{
-		const System &system = it.second;
+		const System &system = *allSystems[i];
 		// Skip systems with incomplete data or that are inaccessible.
 		if(!system.IsValid() || system.Inaccessible())
 			continue;
@@ -499,11 +550,14 @@ const System *LocationFilter::PickSystem(const System *origin) const
 // Pick a random planet that matches this filter, based on the given origin.
 const Planet *LocationFilter::PickPlanet(const System *origin, bool hasClearance, bool requireSpaceport) const
 {
+	shared_ptr<const LocationIndex> index = GameData::GetLocationIndex();
+	const vector<const Planet *> &allPlanets = index->Planets();
+
 	// Find a planet that satisfies the filter.
 	vector<const Planet *> options;
-	for(const auto &it : GameData::Planets())
+	for(int i : PlanetCandidates(*index, origin))
 	{
-		const Planet &planet = it.second;
+		const Planet &planet = *allPlanets[i];
 		// Skip planets with incomplete data or which are from inaccessible systems.
 		if(!planet.IsValid() || (planet.GetSystem() && planet.GetSystem()->Inaccessible()))
 			continue;
@@ -686,3 +740,69 @@ bool LocationFilter::Matches(const System *system, const System *origin, bool di
 
 	return true;
 }
+
+
+
+// Get the indices of all the systems that might match this filter, in order.
+// Each system must still be checked to see if it really does match.
+vector<int> LocationFilter::SystemCandidates(const LocationIndex &index, const System *origin) const
+{
+	vector<int> candidates;
+	bool narrowed = false;
+	if(!systems.empty())
+		Narrow(candidates, narrowed, index.SystemsIn(systems));
+	if(systemIsVisited && visitedSystems)
+		Narrow(candidates, narrowed, index.SystemsIn(*visitedSystems));
+	if(!governments.empty())
+		Narrow(candidates, narrowed, index.SystemsOwnedBy(governments));
+	for(const set<string> &attr : attributes)
+		Narrow(candidates, narrowed, index.SystemsWithAny(attr));
+	if(center)
+		Narrow(candidates, narrowed, index.SystemsIn(
+			WithinDistance(center, centerMinDistance, centerMaxDistance, centerDistanceOptions)));
+	if(origin && originMaxDistance >= 0)
+		Narrow(candidates, narrowed, index.SystemsIn(
+			WithinDistance(origin, originMinDistance, originMaxDistance, originDistanceOptions)));
+
+	if(!narrowed)
+	{
+		candidates.resize(index.Systems().size());
+		iota(candidates.begin(), candidates.end(), 0);
+	}
+	return candidates;
+}
+
+
+
+// Get the indices of all the planets that might match this filter, in order.
+// Each planet must still be checked to see if it really does match.
+vector<int> LocationFilter::PlanetCandidates(const LocationIndex &index, const System *origin) const
+{
+	vector<int> candidates;
+	bool narrowed = false;
+	if(!planets.empty())
+		Narrow(candidates, narrowed, index.PlanetsIn(planets));
+	if(planetIsVisited && visitedPlanets)
+		Narrow(candidates, narrowed, index.PlanetsIn(*visitedPlanets));
+	if(!systems.empty())
+		Narrow(candidates, narrowed, index.PlanetsInSystems(systems));
+	if(systemIsVisited && visitedSystems)
+		Narrow(candidates, narrowed, index.PlanetsInSystems(*visitedSystems));
+	if(!governments.empty())
+		Narrow(candidates, narrowed, index.PlanetsOwnedBy(governments));
+	for(const set<string> &attr : attributes)
+		Narrow(candidates, narrowed, index.PlanetsWithAny(attr));
+	if(center)
+		Narrow(candidates, narrowed, index.PlanetsInSystems(
+			WithinDistance(center, centerMinDistance, centerMaxDistance, centerDistanceOptions)));
+	if(origin && originMaxDistance >= 0)
+		Narrow(candidates, narrowed, index.PlanetsInSystems(
+			WithinDistance(origin, originMinDistance, originMaxDistance, originDistanceOptions)));
+
+	if(!narrowed)
+	{
+		candidates.resize(index.Planets().size());
+		iota(candidates.begin(), candidates.end(), 0);
+	}
+	return candidates;
+}
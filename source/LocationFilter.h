@@ -20,10 +20,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <list>
 #include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
 class Government;
+class LocationIndex;
 class Outfit;
 class Planet;
 class Ship;
@@ -77,6 +79,10 @@ private:
 	// only if the filter wasn't looking for planet characteristics or if the
 	// didPlanet argument is set (meaning we already checked those).
 	bool Matches(const System *system, const System *origin, bool didPlanet) const;
+	// Get the indices of the systems or planets in the given index that might
+	// match this filter, in the same order as in the index.
+	std::vector<int> SystemCandidates(const LocationIndex &index, const System *origin) const;
+	std::vector<int> PlanetCandidates(const LocationIndex &index, const System *origin) const;
 
 
 private:
@@ -0,0 +1,179 @@
+/* LocationIndex.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "LocationIndex.h"
+
+#include "Planet.h"
+#include "StellarObject.h"
+#include "System.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+LocationIndex::LocationIndex(const Set<System> &systems, const Set<Planet> &planets)
+{
+	this->systems.reserve(systems.size());
+	for(const auto &it : systems)
+	{
+		const System &system = it.second;
+		const int i = this->systems.size();
+		this->systems.push_back(&system);
+		systemIndex.emplace(&system, i);
+		if(!system.IsValid())
+			continue;
+
+		systemsByGovernment[system.GetGovernment()].push_back(i);
+		// A system has an attribute if it or any of its planets has it.
+		set<string> attributes = system.Attributes();
+		for(const StellarObject &object : system.Objects())
+			if(object.HasSprite() && object.HasValidPlanet())
+				attributes.insert(object.GetPlanet()->Attributes().begin(), object.GetPlanet()->Attributes().end());
+		for(const string &attribute : attributes)
+			systemsByAttribute[attribute].push_back(i);
+	}
+
+	this->planets.reserve(planets.size());
+	for(const auto &it : planets)
+	{
+		const Planet &planet = it.second;
+		const int i = this->planets.size();
+		this->planets.push_back(&planet);
+		planetIndex.emplace(&planet, i);
+		if(!planet.IsValid())
+			continue;
+
+		planetsByGovernment[planet.GetGovernment()].push_back(i);
+		for(const string &attribute : planet.Attributes())
+			planetsByAttribute[attribute].push_back(i);
+		planetsBySystem[planet.GetSystem()].push_back(i);
+	}
+}
+
+
+
+// Get every system or planet, in the order they are listed in GameData.
+const vector<const System *> &LocationIndex::Systems() const
+{
+	return systems;
+}
+
+
+
+const vector<const Planet *> &LocationIndex::Planets() const
+{
+	return planets;
+}
+
+
+
+// Get the valid systems that are in the given set.
+vector<int> LocationIndex::SystemsIn(const set<const System *> &systems) const
+{
+	vector<int> result;
+	for(const System *system : systems)
+	{
+		auto it = systemIndex.find(system);
+		if(it != systemIndex.end() && system->IsValid())
+			result.push_back(it->second);
+	}
+	sort(result.begin(), result.end());
+	return result;
+}
+
+
+
+// Get the valid systems that are owned by one of the given governments.
+vector<int> LocationIndex::SystemsOwnedBy(const set<const Government *> &governments) const
+{
+	return Union(systemsByGovernment, governments);
+}
+
+
+
+// Get the valid systems that have, or have a planet that has, at least one of
+// the given attributes.
+vector<int> LocationIndex::SystemsWithAny(const set<string> &attributes) const
+{
+	return Union(systemsByAttribute, attributes);
+}
+
+
+
+// Get the valid planets that are in the given set.
+vector<int> LocationIndex::PlanetsIn(const set<const Planet *> &planets) const
+{
+	vector<int> result;
+	for(const Planet *planet : planets)
+	{
+		auto it = planetIndex.find(planet);
+		if(it != planetIndex.end() && planet->IsValid())
+			result.push_back(it->second);
+	}
+	sort(result.begin(), result.end());
+	return result;
+}
+
+
+
+// Get the valid planets that are owned by one of the given governments.
+vector<int> LocationIndex::PlanetsOwnedBy(const set<const Government *> &governments) const
+{
+	return Union(planetsByGovernment, governments);
+}
+
+
+
+// Get the valid planets that have at least one of the given attributes.
+vector<int> LocationIndex::PlanetsWithAny(const set<string> &attributes) const
+{
+	return Union(planetsByAttribute, attributes);
+}
+
+
+
+// Get the valid planets whose system is one of the given systems.
+vector<int> LocationIndex::PlanetsInSystems(const set<const System *> &systems) const
+{
+	vector<int> result;
+	for(const System *system : systems)
+	{
+		auto it = planetsBySystem.find(system);
+		if(it != planetsBySystem.end())
+			result.insert(result.end(), it->second.begin(), it->second.end());
+	}
+	sort(result.begin(), result.end());
+	return result;
+}
+
+
+
+// Combine the lists for each of the given keys into one sorted list.
+template<class Key>
+vector<int> LocationIndex::Union(const map<Key, vector<int>> &lists, const set<Key> &keys)
+{
+	vector<int> result;
+	for(const Key &key : keys)
+	{
+		auto it = lists.find(key);
+		if(it != lists.end())
+			result.insert(result.end(), it->second.begin(), it->second.end());
+	}
+	sort(result.begin(), result.end());
+	result.erase(unique(result.begin(), result.end()), result.end());
+	return result;
+}
@@ -0,0 +1,79 @@
+/* LocationIndex.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Set.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Government;
+class Planet;
+class System;
+
+
+
+// Lists of which systems and planets have each attribute or government, so that
+// a LocationFilter can narrow down which locations might match it before doing
+// the full check on each one. Every list is a sorted list of indices into the
+// list of all systems or planets, which are in the same order as in GameData,
+// so that a filter picks from its matches in the same order either way.
+class LocationIndex {
+public:
+	LocationIndex(const Set<System> &systems, const Set<Planet> &planets);
+
+	// Get every system or planet, in the order they are listed in GameData.
+	const std::vector<const System *> &Systems() const;
+	const std::vector<const Planet *> &Planets() const;
+
+	// Get the valid systems that are in the given set, or that are owned by one
+	// of the given governments, or that (or that have a planet that) have at
+	// least one of the given attributes.
+	std::vector<int> SystemsIn(const std::set<const System *> &systems) const;
+	std::vector<int> SystemsOwnedBy(const std::set<const Government *> &governments) const;
+	std::vector<int> SystemsWithAny(const std::set<std::string> &attributes) const;
+
+	// Get the valid planets that are in the given set, or that are owned by one
+	// of the given governments, or that have at least one of the given
+	// attributes, or whose system is one of the given systems.
+	std::vector<int> PlanetsIn(const std::set<const Planet *> &planets) const;
+	std::vector<int> PlanetsOwnedBy(const std::set<const Government *> &governments) const;
+	std::vector<int> PlanetsWithAny(const std::set<std::string> &attributes) const;
+	std::vector<int> PlanetsInSystems(const std::set<const System *> &systems) const;
+
+
+private:
+	// Combine the lists for each of the given keys into one sorted list.
+	template<class Key>
+	static std::vector<int> Union(const std::map<Key, std::vector<int>> &lists, const std::set<Key> &keys);
+
+
+private:
+	std::vector<const System *> systems;
+	std::vector<const Planet *> planets;
+	std::unordered_map<const System *, int> systemIndex;
+	std::unordered_map<const Planet *, int> planetIndex;
+
+	std::map<const Government *, std::vector<int>> systemsByGovernment;
+	std::map<std::string, std::vector<int>> systemsByAttribute;
+
+	std::map<const Government *, std::vector<int>> planetsByGovernment;
+	std::map<std::string, std::vector<int>> planetsByAttribute;
+	std::map<const System *, std::vector<int>> planetsBySystem;
+};
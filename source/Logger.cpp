@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "text/Format.h"
 #include "GameVersion.h"
+#include "MpscQueue.h"
 
 #ifdef _WIN32
 #include "windows/WinVersion.h"
@@ -24,14 +25,254 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <sys/utsname.h>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 
 using namespace std;
 
 namespace {
+	// A message that is waiting to be written.
+	class Entry {
+	public:
+		string message;
+		Logger::Level level = Logger::Level::INFO;
+		chrono::system_clock::time_point time;
+	};
+
+	// How many messages can be waiting to be written at once. If the queue is
+	// full, the thread logging a message writes out the whole queue itself.
+	constexpr size_t QUEUE_SIZE = 4096;
+	// How long the background thread waits between writing batches of messages.
+	constexpr chrono::milliseconds FLUSH_INTERVAL(100);
+	// How many times a message is written before any more copies of it are dropped.
+	constexpr int MESSAGE_LIMIT = 10;
+	// How many different messages to keep count of. Once this many have been
+	// logged, the counts start over, so that they do not keep growing.
+	constexpr size_t COUNTED_MESSAGES = 1024;
+
 	function<void(const string &message, Logger::Level)> logCallback = nullptr;
+	function<void()> batchCallback = nullptr;
+	// Only one thread at a time may write messages, or take them out of the queue.
 	mutex logMutex;
+	MpscQueue<Entry, QUEUE_SIZE> queue;
+	// Whether a session is active, so messages are queued up rather than written immediately.
+	atomic<bool> isAsynchronous = false;
+	// Whether this thread is writing messages. If the log callback itself logs
+	// something, it must not wait for the mutex.
+	thread_local bool isWriting = false;
+	terminate_handler previousTerminate = nullptr;
+	bool isExitHandlerSet = false;
+
+	// The rest of the state is only used with the mutex held.
+	// The console output of the current batch. Runs of messages going to the
+	// same stream are written out together.
+	string consoleText;
+	bool consoleIsError = false;
+	// The last message that was written, and how many times it has been
+	// repeated since then.
+	string lastMessage;
+	Logger::Level lastLevel = Logger::Level::INFO;
+	chrono::system_clock::time_point lastTime;
+	int repeats = 0;
+	// How many times each message has been logged during this session, and how
+	// many were dropped because they had been logged too many times.
+	unordered_map<string, int> counts;
+	int dropped = 0;
+
+
+	void WriteConsole()
+	{
+		if(consoleText.empty())
+			return;
+		(consoleIsError ? cerr : cout) << consoleText << flush;
+		consoleText.clear();
+	}
+
+
+	void Write(const string &message, Logger::Level level, chrono::system_clock::time_point time)
+	{
+		string formatted = Format::TimestampString(time, true) + " | " + static_cast<char>(level) + " | " + message;
+		const bool isError = (level != Logger::Level::INFO);
+		if(isError != consoleIsError)
+		{
+			WriteConsole();
+			consoleIsError = isError;
+		}
+		consoleText += formatted;
+		consoleText += '\n';
+		// Perform additional logging through callback if any is registered.
+		if(logCallback)
+			logCallback(formatted, level);
+	}
+
+
+	void EndBatch()
+	{
+		WriteConsole();
+		if(batchCallback)
+			batchCallback();
+	}
+
+
+	// If the last message was repeated, write out how many times.
+	void WriteRepeats()
+	{
+		if(repeats)
+			Write("The previous message was repeated " + to_string(repeats)
+				+ (repeats == 1 ? " more time." : " more times."), lastLevel, lastTime);
+		repeats = 0;
+	}
+
+
+	// Write out a message from the queue, unless it repeats the previous
+	// message, or has already been written too many times.
+	void Add(Entry &entry)
+	{
+		if(entry.level == lastLevel && entry.message == lastMessage)
+		{
+			++repeats;
+			lastTime = entry.time;
+			return;
+		}
+		if(counts.size() >= COUNTED_MESSAGES && !counts.contains(entry.message))
+			counts.clear();
+		int &count = counts[entry.message];
+		if(++count > MESSAGE_LIMIT)
+		{
+			++dropped;
+			return;
+		}
+
+		WriteRepeats();
+		lastMessage = entry.message;
+		lastLevel = entry.level;
+		lastTime = entry.time;
+		if(count == MESSAGE_LIMIT)
+			entry.message += " (This message has been logged " + to_string(MESSAGE_LIMIT)
+				+ " times, so it will not be logged again.)";
+		Write(entry.message, entry.level, entry.time);
+	}
+
+
+	// Write out every message in the queue. Returns true if there were any.
+	// This must be called with the mutex held.
+	bool WriteQueue()
+	{
+		bool any = false;
+		Entry entry;
+		while(queue.Pop(entry))
+		{
+			Add(entry);
+			any = true;
+		}
+		return any;
+	}
+
+
+	// Write out the queue, including how many times the last message was
+	// repeated. This must be called with the mutex held.
+	void FlushQueue()
+	{
+		isWriting = true;
+		WriteQueue();
+		WriteRepeats();
+		EndBatch();
+		isWriting = false;
+	}
+
+
+	// The background thread that writes out the queued messages.
+	class Flusher {
+	public:
+		~Flusher()
+		{
+			Stop();
+		}
+
+		void Start()
+		{
+			lock_guard<mutex> lock(flusherMutex);
+			if(worker.joinable())
+				return;
+			shouldQuit = false;
+			worker = thread(&Flusher::Loop, this);
+		}
+
+		void Stop()
+		{
+			{
+				lock_guard<mutex> lock(flusherMutex);
+				shouldQuit = true;
+			}
+			condition.notify_one();
+			if(worker.joinable())
+				worker.join();
+		}
+
+		// Write out the queue as soon as possible.
+		void Wake()
+		{
+			condition.notify_one();
+		}
+
+
+	private:
+		void Loop() noexcept
+		{
+			unique_lock<mutex> lock(flusherMutex);
+			while(!shouldQuit)
+			{
+				condition.wait_for(lock, FLUSH_INTERVAL);
+				lock.unlock();
+				{
+					lock_guard<mutex> logLock(logMutex);
+					isWriting = true;
+					// A run of repeated messages is only cut short when a different message is logged.
+					if(WriteQueue())
+						EndBatch();
+					isWriting = false;
+				}
+				lock.lock();
+			}
+		}
+
+
+	private:
+		mutex flusherMutex;
+		condition_variable condition;
+		bool shouldQuit = false;
+		thread worker;
+	} flusher;
+
+
+	// Write out any messages that are still waiting if the program terminates
+	// or exits without ending the session. Nothing can be written if this
+	// thread was in the middle of writing, or if another thread is. This is
+	// not done for signals such as SIGSEGV, since writing the messages is not
+	// safe to do in a signal handler; errors are written out right away anyway.
+	void FlushOnExit()
+	{
+		if(!isAsynchronous || isWriting || !logMutex.try_lock())
+			return;
+		FlushQueue();
+		logMutex.unlock();
+	}
+
+
+	void OnTerminate()
+	{
+		FlushOnExit();
+		if(previousTerminate)
+			previousTerminate();
+		abort();
+	}
 }
 
 
@@ -39,6 +280,15 @@ namespace {
 Logger::Session::Session(bool quiet)
 	: quiet{quiet}
 {
+	// From now on, write messages on a background thread, and make sure that
+	// none of them are lost if the program terminates or exits early.
+	flusher.Start();
+	isAsynchronous = true;
+	previousTerminate = set_terminate(&OnTerminate);
+	// The exit handler cannot be removed again, so it is only added once.
+	if(!isExitHandlerSet)
+		isExitHandlerSet = !atexit(&FlushOnExit);
+
 	if(quiet)
 		return;
 
@@ -58,28 +308,87 @@ Logger::Session::Session(bool quiet)
 
 Logger::Session::~Session()
 {
-	if(quiet)
-		return;
+	if(!quiet)
+		Log("Logger session end.", Level::INFO);
+
+	// Write out everything that is still waiting, and go back to writing
+	// messages as soon as they are logged.
+	isAsynchronous = false;
+	flusher.Stop();
+	set_terminate(previousTerminate);
+
+	lock_guard<mutex> lock(logMutex);
+	isWriting = true;
+	WriteQueue();
+	WriteRepeats();
+	if(dropped)
+		Write(to_string(dropped) + (dropped == 1 ? " message was" : " messages were")
+			+ " not logged because they had been logged too many times.", Level::WARNING, chrono::system_clock::now());
+	EndBatch();
+	isWriting = false;
 
-	Log("Logger session end.", Level::INFO);
+	lastMessage.clear();
+	counts.clear();
+	dropped = 0;
 }
 
 
 
-void Logger::SetLogCallback(function<void(const string &message, Level)> callback)
+void Logger::SetLogCallback(function<void(const string &message, Level)> callback, function<void()> flushCallback)
 {
+	lock_guard<mutex> lock(logMutex);
 	logCallback = std::move(callback);
+	batchCallback = std::move(flushCallback);
 }
 
 
 
 void Logger::Log(const string &message, Level level)
 {
+	const auto now = chrono::system_clock::now();
+	if(isAsynchronous)
+	{
+		Entry entry{message, level, now};
+		if(queue.Push(std::move(entry)))
+		{
+			// Errors are written out as soon as possible, in case the program is about to exit.
+			if(level == Level::ERROR)
+				flusher.Wake();
+			return;
+		}
+		// The log callback is trying to log something while the queue is full.
+		if(isWriting)
+		{
+			cerr << message << endl;
+			return;
+		}
+
+		// The queue is full, so write it all out on this thread, followed by this message.
+		lock_guard<mutex> lock(logMutex);
+		isWriting = true;
+		WriteQueue();
+		Add(entry);
+		EndBatch();
+		isWriting = false;
+		return;
+	}
+
+	lock_guard<mutex> lock(logMutex);
+	isWriting = true;
+	// Write out anything that was logged while the session was ending.
+	WriteQueue();
+	WriteRepeats();
+	Write(message, level, now);
+	EndBatch();
+	isWriting = false;
+}
+
+
+
+void Logger::Flush()
+{
+	if(isWriting)
+		return;
 	lock_guard<mutex> lock(logMutex);
-	string formatted = Format::TimestampString(chrono::system_clock::now(), true)
-		+ " | " + static_cast<char>(level) + " | " + message;
-	(level == Level::INFO ? cout : cerr) << formatted << endl;
-	// Perform additional logging through callback if any is registered.
-	if(logCallback)
-		logCallback(formatted, level);
+	FlushQueue();
 }
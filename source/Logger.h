@@ -23,6 +23,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Default static logging facility, different programs might have different
 // conventions and requirements on how they handle logging, so the running
 // program should register its preferred logging facility when starting up.
+// Messages are written as soon as they are logged, unless a session is active.
+// During a session, they are written in batches by a background thread instead,
+// so that threads logging many messages do not have to wait for each other or
+// for the disk, and messages that are repeated many times are only written a
+// few times.
 class Logger {
 public:
 	enum class Level : char {
@@ -36,7 +41,10 @@ public:
 		ERROR = 'E'
 	};
 
-	// Print additional control messages when a session begins or ends.
+	// Print additional control messages when a session begins or ends. While
+	// the session is active, messages are written by a background thread, and
+	// any that are still waiting to be written when it ends, or if the program
+	// calls std::terminate() or exit() first, are written out then.
 	class Session {
 	public:
 		Session(bool quiet);
@@ -49,6 +57,11 @@ public:
 
 
 public:
-	static void SetLogCallback(std::function<void(const std::string &message, Level)> callback);
+	// Set a function to pass each message to after it has been written to the
+	// console, and optionally a function to call after each batch of messages.
+	static void SetLogCallback(std::function<void(const std::string &message, Level)> callback,
+		std::function<void()> flushCallback = nullptr);
 	static void Log(const std::string &message, Level level);
+	// Write out every message that has been logged so far, before returning.
+	static void Flush();
 };
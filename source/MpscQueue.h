@@ -0,0 +1,124 @@
+/* MpscQueue.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+
+// A fixed-size queue that any number of threads can add items to at the same
+// time, but that only one thread may take items out of. Neither adding nor
+// removing an item ever waits on a lock. If the queue is full, an item cannot
+// be added until the consumer has removed some of the items ahead of it.
+template<class Type, size_t CAPACITY>
+class MpscQueue {
+	static_assert(CAPACITY && !(CAPACITY & (CAPACITY - 1)), "The capacity must be a power of two.");
+
+public:
+	MpscQueue() noexcept;
+	MpscQueue(const MpscQueue &) = delete;
+	MpscQueue &operator=(const MpscQueue &) = delete;
+
+	// Add an item to the queue. This can be called from any thread. Returns
+	// false if the queue is full, in which case the item is left unchanged.
+	template<class Item>
+	bool Push(Item &&item);
+	// Take the oldest item out of the queue. This must only be called from one
+	// thread at a time. Returns false if the queue is empty.
+	bool Pop(Type &item) noexcept;
+
+
+private:
+	// Each slot remembers which position in the queue it is ready to hold
+	// next, so that the producers and the consumer can tell whether it is free
+	// or full without locking.
+	class Slot {
+	public:
+		std::atomic<size_t> sequence;
+		Type item;
+	};
+
+
+private:
+	std::array<Slot, CAPACITY> slots;
+	// The producers and the consumer each update a different position, so keep
+	// them on separate cache lines.
+	alignas(64) std::atomic<size_t> tail = 0;
+	alignas(64) size_t head = 0;
+};
+
+
+
+template<class Type, size_t CAPACITY>
+MpscQueue<Type, CAPACITY>::MpscQueue() noexcept
+{
+	for(size_t i = 0; i < CAPACITY; ++i)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+
+
+// Add an item to the queue. Returns false if the queue is full.
+template<class Type, size_t CAPACITY>
+template<class Item>
+bool MpscQueue<Type, CAPACITY>::Push(Item &&item)
+{
+	size_t position = tail.load(std::memory_order_relaxed);
+	while(true)
+	{
+		Slot &slot = slots[position & (CAPACITY - 1)];
+		size_t sequence = slot.sequence.load(std::memory_order_acquire);
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+		if(!difference)
+		{
+			// This slot is free, so try to claim it before another producer does.
+			if(tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				slot.item = std::forward<Item>(item);
+				slot.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		// The consumer has not emptied this slot yet.
+		else if(difference < 0)
+			return false;
+		// Another producer claimed this slot first.
+		else
+			position = tail.load(std::memory_order_relaxed);
+	}
+}
+
+
+
+// Take the oldest item out of the queue. Returns false if the queue is empty.
+template<class Type, size_t CAPACITY>
+bool MpscQueue<Type, CAPACITY>::Pop(Type &item) noexcept
+{
+	Slot &slot = slots[head & (CAPACITY - 1)];
+	// If a producer has claimed this slot but not finished writing to it, treat
+	// the queue as empty until it has.
+	if(slot.sequence.load(std::memory_order_acquire) != head + 1)
+		return false;
+
+	item = std::move(slot.item);
+	slot.sequence.store(head + CAPACITY, std::memory_order_release);
+	++head;
+	return true;
+}
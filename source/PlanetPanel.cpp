@@ -78,7 +78,7 @@ PlanetPanel::PlanetPanel(PlayerInfo &player, function<void()> callback)
 	TaskQueue queue;
 	SpriteLoadManager::LoadDeferred(queue, planet.Landscape());
 	queue.Wait();
-	queue.ProcessSyncTasks();
+	queue.ProcessSyncTasks(true);
 
 	Audio::Pause();
 }
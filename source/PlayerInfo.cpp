@@ -41,7 +41,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Preferences.h"
 #include "RaidFleet.h"
 #include "Random.h"
-#include "SavedGame.h"
+#include "SaveWriter.h"
 #include "ScanType.h"
 #include "Ship.h"
 #include "ShipEvent.h"
@@ -305,8 +305,10 @@ void PlayerInfo::New(const StartConditions &start, const shared_ptr<PilotProfile
 // Load player information from a saved game file.
 void PlayerInfo::Load(const filesystem::path &path, const shared_ptr<PilotProfile> &pilot)
 {
-	// Make sure any previously loaded data is cleared.
+	// Make sure any previously loaded data is cleared, and that any save that
+	// is still being written has been finished.
 	Clear();
+	SaveWriter::Wait();
 	this->pilot = pilot;
 	this->pilot->Load();
 
@@ -653,35 +655,17 @@ void PlayerInfo::Save() const
 	// Remember that this was the most recently saved player.
 	Files::Write(Files::Config() / "recent.txt", filePath + '\n');
 
-	if(filePath.ends_with(".txt"))
-	{
-		// Only update the backups if this save will have a newer date.
-		SavedGame saved(filePath);
-		if(saved.GetDate() != date.ToString())
-		{
-			string root = filePath.substr(0, filePath.length() - 4);
-			const int previousCount = Preferences::GetPreviousSaveCount();
-			const string rootPrevious = root + "~~previous-";
-			for(int i = previousCount - 1; i > 0; --i)
-			{
-				const string toMove = rootPrevious + to_string(i) + ".txt";
-				if(Files::Exists(toMove))
-					Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
-			}
-			if(Files::Exists(filePath))
-				Files::Move(filePath, rootPrevious + "1.txt");
-			if(planet->HasServices())
-				Save(rootPrevious + "spaceport.txt");
-		}
-	}
-
-	Save(filePath);
+	// Capture the player's state now, but leave writing it to disk, and updating
+	// the backups if this save will have a newer date, to a background thread.
+	SaveWriter::Save(filePath, Snapshot(), Preferences::Has("Compress saved games"),
+		Preferences::GetPreviousSaveCount(), planet->HasServices());
 
 	// Save pilot data:
 	pilot->Save();
 	// Save global conditions:
-	DataWriter globalConditions(Files::Config() / "global conditions.txt");
+	DataWriter globalConditions;
 	GameData::GlobalConditions().Save(globalConditions);
+	SaveWriter::Write(Files::Config() / "global conditions.txt", std::move(globalConditions).SaveToString());
 }
 
 
@@ -4944,20 +4928,21 @@ void PlayerInfo::Autosave() const
 		return;
 
 	string path = filePath.substr(0, filePath.length() - 4) + "~autosave.txt";
-	Save(path);
+	SaveWriter::Write(path, Snapshot(), Preferences::Has("Compress saved games"));
 }
 
 
 
-void PlayerInfo::Save(const string &filePath) const
+// Get the contents of the save file for the player's current state, or the
+// state at the start of the current transaction if there is one.
+string PlayerInfo::Snapshot() const
 {
 	if(transactionSnapshot)
-		transactionSnapshot->SaveToPath(filePath);
-	else
-	{
-		DataWriter out(filePath);
-		Save(out);
-	}
+		return transactionSnapshot->SaveToString();
+
+	DataWriter out;
+	Save(out);
+	return std::move(out).SaveToString();
 }
 
 
@@ -441,7 +441,7 @@ private:
 	void CreateMissions();
 	void StepMissions(UI &ui);
 	void Autosave() const;
-	void Save(const std::string &path) const;
+	std::string Snapshot() const;
 	void Save(DataWriter &out) const;
 
 	// Check for and apply any punitive actions from planetary security.
@@ -197,6 +197,8 @@ namespace {
 	int targetAsteroidIndex = 0;
 
 	int previousSaveCount = 3;
+	int soundMemoryLimit = 0;
+	int textureMemoryLimit = 0;
 
 #ifdef _WIN32
 	const vector<string> TITLE_BAR_THEME_SETTINGS = {"system default", "light", "dark"};
@@ -297,6 +299,10 @@ void Preferences::Load()
 			largeGraphicsReductionIndex = clamp<int>(node.Value(1), 0, LARGE_GRAPHICS_REDUCTION_SETTINGS.size() - 1);
 		else if(key == "previous saves" && hasValue)
 			previousSaveCount = max<int>(3, node.Value(1));
+		else if(key == "sound memory" && hasValue)
+			soundMemoryLimit = max<int>(0, node.Value(1));
+		else if(key == "texture memory" && hasValue)
+			textureMemoryLimit = max<int>(0, node.Value(1));
 		else if(key == "alt-mouse turning")
 			settings["Control ship with mouse"] = (!hasValue || node.Value(1));
 		else if(key == "notification settings")
@@ -418,6 +424,8 @@ void Preferences::Save()
 	out.Write("Text alignment", textAlignmentIndex);
 	out.Write("Target asteroid based on", targetAsteroidIndex);
 	out.Write("previous saves", previousSaveCount);
+	out.Write("sound memory", soundMemoryLimit);
+	out.Write("texture memory", textureMemoryLimit);
 #ifdef _WIN32
 	if(WinVersion::SupportsDarkTheme())
 		out.Write("Title bar theme", titleBarThemeIndex);
@@ -953,6 +961,20 @@ int Preferences::GetPreviousSaveCount()
 
 
 
+int Preferences::GetSoundMemoryLimit()
+{
+	return soundMemoryLimit;
+}
+
+
+
+int Preferences::GetTextureMemoryLimit()
+{
+	return textureMemoryLimit;
+}
+
+
+
 void Preferences::ToggleMinimapDisplay()
 {
 	if(++minimapDisplayIndex >= static_cast<int>(MINIMAP_DISPLAY_SETTING.size()))
@@ -314,6 +314,10 @@ public:
 	static void ToggleBlockScreenSaver();
 
 	static int GetPreviousSaveCount();
+	// The most memory that sounds may use, in megabytes, or 0 for no limit.
+	static int GetSoundMemoryLimit();
+	// The most texture memory that deferred images may use, in megabytes, or 0 for no limit.
+	static int GetTextureMemoryLimit();
 
 #ifdef _WIN32
 	static void ToggleTitleBarTheme();
@@ -832,6 +832,7 @@ void PreferencesPanel::DrawSettings()
 		DATE_FORMAT,
 		NOTIFY_ON_DEST,
 		"Save message log",
+		"Compress saved games",
 		TEXT_ALIGNMENT,
 #ifdef _WIN32
 		"\t",
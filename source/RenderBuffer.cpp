@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "GameWindow.h"
 #include "Logger.h"
+#include "shader/RenderStatistics.h"
 #include "Screen.h"
 #include "shader/Shader.h"
 
@@ -117,6 +118,11 @@ RenderBuffer::RenderTargetGuard::RenderTargetGuard(RenderBuffer &b, int screenWi
 RenderBuffer::RenderBuffer(const Point &dimensions)
 	: size(dimensions)
 {
+	// This may be created in the middle of drawing to another render target,
+	// so remember which one that is.
+	GLint previousFramebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
 	// Generate a framebuffer.
 	glGenFramebuffers(1, &framebuffer);
 	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
@@ -136,6 +142,8 @@ RenderBuffer::RenderBuffer(const Point &dimensions)
 	// Attach a blank image to the texture.
 	const Point scaledSize = size * multiplier * Screen::Zoom() / 100.0;
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, scaledSize.X(), scaledSize.Y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	textureMemory = 4 * static_cast<int64_t>(scaledSize.X()) * static_cast<int64_t>(scaledSize.Y());
+	RenderStatistics::AddTextureMemory(textureMemory);
 
 	// Attach the texture to the frame buffer.
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texid, 0);
@@ -147,7 +155,7 @@ RenderBuffer::RenderBuffer(const Point &dimensions)
 
 
 	glBindTexture(GL_TEXTURE_2D, 0);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
 
 	// Default to the current viewport size at the time of construction.
 	glGetIntegerv(GL_VIEWPORT, lastViewport);
@@ -160,6 +168,7 @@ RenderBuffer::~RenderBuffer()
 {
 	glDeleteTextures(1, &texid);
 	glDeleteFramebuffers(1, &framebuffer);
+	RenderStatistics::RemoveTextureMemory(textureMemory);
 }
 
 
@@ -227,21 +236,23 @@ void RenderBuffer::Draw(const Point &position, const Point &clipsize, const Poin
 
 	glBindTexture(GL_TEXTURE_2D, texid);
 
-	glUniform2f(sizeI, clipsize.X(), clipsize.Y());
-	glUniform2f(positionI, position.X(), position.Y());
-	glUniform2f(scaleI, 2.f / Screen::Width(), -2.f / Screen::Height());
+	RenderStatistics::SetUniform(glUniform2f, sizeI, clipsize.X(), clipsize.Y());
+	RenderStatistics::SetUniform(glUniform2f, positionI, position.X(), position.Y());
+	RenderStatistics::SetUniform(glUniform2f, scaleI, 2.f / Screen::Width(), -2.f / Screen::Height());
 
-	glUniform2f(srcpositionI, srcposition.X(), srcposition.Y());
-	glUniform2f(srcscaleI, 1.f / size.X(), 1.f / size.Y());
+	RenderStatistics::SetUniform(glUniform2f, srcpositionI, srcposition.X(), srcposition.Y());
+	RenderStatistics::SetUniform(glUniform2f, srcscaleI, 1.f / size.X(), 1.f / size.Y());
 
-	glUniform4f(fadeI,
+	RenderStatistics::SetUniform(glUniform4f, fadeI,
 		fadePadding[0] / clipsize.Y(),
 		fadePadding[1] / clipsize.Y(),
 		fadePadding[2] / clipsize.X(),
 		fadePadding[3] / clipsize.X()
 	);
+	RenderStatistics::AddTextureBinds();
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderStatistics::AddDrawCall(2);
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
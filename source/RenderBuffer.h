@@ -18,6 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Point.h"
 #include "Screen.h"
 
+#include <cstdint>
+
 
 
 // Class that can redirect all drawing commands to an internal texture.
@@ -87,4 +89,6 @@ private:
 	float fadePadding[4] = {};
 
 	Point multiplier;
+	// How much texture memory this buffer takes up, in bytes.
+	int64_t textureMemory = 0;
 };
@@ -29,11 +29,11 @@ RouteEdge::RouteEdge(const System *system)
 // is lower priority than the given item.
 bool RouteEdge::operator<(const RouteEdge &other) const
 {
-	if(fuel != other.fuel)
-		return fuel > other.fuel;
+	if(fuel + fuelEstimate != other.fuel + other.fuelEstimate)
+		return fuel + fuelEstimate > other.fuel + other.fuelEstimate;
 
-	if(days != other.days)
-		return days > other.days;
+	if(days + daysEstimate != other.days + other.daysEstimate)
+		return days + daysEstimate > other.days + other.daysEstimate;
 
 	return danger > other.danger;
 }
@@ -44,4 +44,9 @@ public:
 	// It's used for comparison purposes only. Anyone going to this system
 	// is going to hit its danger anyway, so it doesn't change anything.
 	double danger = 0.;
+	// A lower bound on the fuel and days still needed to get from this system
+	// to the destination, if the search has one. This only affects the order in
+	// which edges are explored, so it is left at zero for edges in the final route.
+	int fuelEstimate = 0;
+	int daysEstimate = 0;
 };
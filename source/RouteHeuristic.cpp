@@ -0,0 +1,192 @@
+/* RouteHeuristic.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "RouteHeuristic.h"
+
+#include "Planet.h"
+#include "StellarObject.h"
+#include "System.h"
+#include "Wormhole.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+using namespace std;
+
+namespace {
+	// How many landmark systems to precompute distances for. More landmarks give
+	// tighter bounds, but cost memory and make each estimate slower.
+	const int LANDMARK_COUNT = 8;
+
+	const int UNREACHABLE = numeric_limits<int>::max();
+}
+
+
+
+RouteHeuristic::RouteHeuristic(const Set<System> &systems, double jumpRange)
+{
+	// Every system gets a node, even if it is not valid, so that any edge that
+	// DistanceMap could possibly follow is also present here.
+	for(const auto &it : systems)
+	{
+		index.emplace(&it.second, static_cast<int>(this->systems.size()));
+		this->systems.push_back(&it.second);
+	}
+
+	// Build the relaxed star map, and its reverse for finding distances to a landmark.
+	const int count = this->systems.size();
+	vector<vector<Edge>> edges(count);
+	vector<vector<Edge>> reverseEdges(count);
+	for(int i = 0; i < count; ++i)
+	{
+		const System &system = *this->systems[i];
+		for(const System *link : (jumpRange > 0. ? system.JumpNeighbors(jumpRange) : system.Links()))
+		{
+			auto it = index.find(link);
+			if(it == index.end())
+				continue;
+			edges[i].push_back(Edge{it->second, false});
+			reverseEdges[it->second].push_back(Edge{i, false});
+			longestJump = max(longestJump, system.Position().Distance(link->Position()));
+		}
+		for(const StellarObject &object : system.Objects())
+			if(object.HasSprite() && object.HasValidPlanet() && object.GetPlanet()->IsWormhole())
+			{
+				const System *link = &object.GetPlanet()->GetWormhole()->WormholeDestination(system);
+				auto it = index.find(link);
+				// If a wormhole leads somewhere unknown, no bound can be trusted.
+				if(it == index.end())
+				{
+					landmarks.clear();
+					hasWormholes = true;
+					return;
+				}
+				edges[i].push_back(Edge{it->second, true});
+				reverseEdges[it->second].push_back(Edge{i, true});
+				hasWormholes = true;
+			}
+	}
+
+	// Choose landmarks that are as far away from each other as possible, so that
+	// the estimates are good in every direction. A system that cannot be reached
+	// from any existing landmark is the "farthest" of all, so every separate
+	// cluster of systems (e.g. a plugin's galaxy) gets a landmark of its own.
+	vector<int> closest(count, UNREACHABLE);
+	while(static_cast<int>(landmarks.size()) < min(LANDMARK_COUNT, count))
+	{
+		int next = -1;
+		for(int i = 0; i < count; ++i)
+			if(this->systems[i]->IsValid() && !this->systems[i]->Inaccessible()
+					&& closest[i] && (next < 0 || closest[i] > closest[next]))
+				next = i;
+		if(next < 0)
+			break;
+
+		Landmark &landmark = landmarks.emplace_back();
+		Search(edges, next, true, landmark.jumpsFrom);
+		Search(reverseEdges, next, true, landmark.jumpsTo);
+		Search(edges, next, false, landmark.drivesFrom);
+		Search(reverseEdges, next, false, landmark.drivesTo);
+
+		for(int i = 0; i < count; ++i)
+			closest[i] = min({closest[i], landmark.jumpsFrom[i], landmark.jumpsTo[i]});
+	}
+}
+
+
+
+// Get a lower bound on the number of jumps needed to get from one system to
+// the other, and on how many of those jumps are not made through wormholes
+// (i.e. cost fuel). Returns false if the destination cannot be reached at all.
+bool RouteHeuristic::Estimate(const System &from, const System &to, int &jumps, int &drives) const
+{
+	jumps = 0;
+	drives = 0;
+	if(&from == &to)
+		return true;
+
+	auto fromIt = index.find(&from);
+	auto toIt = index.find(&to);
+	if(fromIt == index.end() || toIt == index.end())
+		return true;
+	const int x = fromIt->second;
+	const int t = toIt->second;
+
+	for(const Landmark &landmark : landmarks)
+	{
+		// The route from the landmark to the destination can be no shorter than
+		// the route from the landmark to here, plus the rest of this route.
+		if(landmark.jumpsFrom[x] != UNREACHABLE)
+		{
+			if(landmark.jumpsFrom[t] == UNREACHABLE)
+				return false;
+			jumps = max(jumps, landmark.jumpsFrom[t] - landmark.jumpsFrom[x]);
+			drives = max(drives, landmark.drivesFrom[t] - landmark.drivesFrom[x]);
+		}
+		// Similarly, the route from here to the landmark can be no shorter than
+		// this route plus the route from the destination to the landmark.
+		if(landmark.jumpsTo[t] != UNREACHABLE)
+		{
+			if(landmark.jumpsTo[x] == UNREACHABLE)
+				return false;
+			jumps = max(jumps, landmark.jumpsTo[x] - landmark.jumpsTo[t]);
+			drives = max(drives, landmark.drivesTo[x] - landmark.drivesTo[t]);
+		}
+	}
+
+	// Without wormholes, every jump covers at most the longest jump distance.
+	if(!hasWormholes && longestJump > 0.)
+	{
+		double distance = from.Position().Distance(to.Position());
+		int minimum = static_cast<int>(ceil(distance / longestJump - 1e-9));
+		jumps = max(jumps, minimum);
+		drives = max(drives, minimum);
+	}
+	return true;
+}
+
+
+
+// Find the distance from the given system to every other, following the
+// given edges. Wormhole edges are free if only counting drive jumps.
+void RouteHeuristic::Search(const vector<vector<Edge>> &edges, int start, bool countWormholes,
+	vector<int> &distance)
+{
+	distance.assign(edges.size(), UNREACHABLE);
+	distance[start] = 0;
+
+	// Every edge costs either zero or one, so a deque can be used instead of a
+	// priority queue: free edges go to the front, the rest to the back.
+	deque<int> todo{start};
+	while(!todo.empty())
+	{
+		int current = todo.front();
+		todo.pop_front();
+		for(const Edge &edge : edges[current])
+		{
+			int cost = (countWormholes || !edge.isWormhole);
+			if(distance[current] + cost >= distance[edge.to])
+				continue;
+
+			distance[edge.to] = distance[current] + cost;
+			if(cost)
+				todo.push_back(edge.to);
+			else
+				todo.push_front(edge.to);
+		}
+	}
+}
@@ -0,0 +1,82 @@
+/* RouteHeuristic.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Set.h"
+
+#include <unordered_map>
+#include <vector>
+
+class System;
+
+
+
+// Lower bounds on how many jumps it takes to travel between two systems, used
+// to direct a RoutePlan's search toward its destination (A* search). The bounds
+// are computed for a "relaxed" star map, which contains every hyperspace link,
+// every jump within the given range and every wormhole, so that no ship with
+// that jump range can ever do better than the estimate. Wormholes can connect
+// systems that are far apart, so instead of relying only on the systems'
+// positions, the distances to and from a few "landmark" systems are precomputed
+// and the triangle inequality is used to bound the distance between any two
+// other systems.
+class RouteHeuristic {
+public:
+	// Compute the landmark distances for ships with the given jump range. If the
+	// range is zero, only hyperspace links (and wormholes) are considered.
+	RouteHeuristic(const Set<System> &systems, double jumpRange);
+
+	// Get a lower bound on the number of jumps needed to get from one system to
+	// the other, and on how many of those jumps are not made through wormholes
+	// (i.e. cost fuel). Returns false if the destination cannot be reached at all.
+	bool Estimate(const System &from, const System &to, int &jumps, int &drives) const;
+
+
+private:
+	// Distances from and to one landmark system, in jumps and in non-wormhole jumps.
+	class Landmark {
+	public:
+		std::vector<int> jumpsFrom;
+		std::vector<int> jumpsTo;
+		std::vector<int> drivesFrom;
+		std::vector<int> drivesTo;
+	};
+
+	// A connection in the relaxed star map.
+	class Edge {
+	public:
+		int to;
+		bool isWormhole;
+	};
+
+
+private:
+	// Find the distance from the given system to every other, following the
+	// given edges. Wormhole edges are free if only counting drive jumps.
+	static void Search(const std::vector<std::vector<Edge>> &edges, int start, bool countWormholes,
+		std::vector<int> &distance);
+
+
+private:
+	std::unordered_map<const System *, int> index;
+	std::vector<const System *> systems;
+	std::vector<Landmark> landmarks;
+
+	// If there are no wormholes, the distance between two systems also puts a
+	// lower bound on the number of jumps between them.
+	bool hasWormholes = false;
+	double longestJump = 0.;
+};
@@ -0,0 +1,276 @@
+/* SaveWriter.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SaveWriter.h"
+
+#include "Files.h"
+#include "Gzip.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// A file waiting to be written.
+	class Job {
+	public:
+		filesystem::path path;
+		string contents;
+		bool compress = false;
+		// Only saved games have backups.
+		bool isSave = false;
+		int previousCount = 0;
+		bool spaceportBackup = false;
+		// The date line of a saved game. Saves from different dates are never
+		// combined, since the older one still needs to be moved into the backups.
+		string date;
+	};
+
+	deque<Job> jobs;
+	bool isWriting = false;
+	bool shouldQuit = false;
+	mutex jobMutex;
+	// Used to wake up the writer thread when there is a job for it.
+	condition_variable jobCondition;
+	// Used to wake up anyone waiting for all the jobs to be done.
+	condition_variable doneCondition;
+	// The thread that writes the files. It is started when the first job is
+	// queued, and joined by SaveWriter::Shutdown().
+	thread writerThread;
+
+	// How much of a compressed save to decompress when looking for its date.
+	const size_t DATE_SEARCH_LIMIT = 64 * 1024;
+
+
+	// Get the line of a saved game that gives its date. It is always one of
+	// the first few lines, and is never indented.
+	string DateLine(const string &contents)
+	{
+		size_t start = contents.starts_with("date ") ? 0 : contents.find("\ndate ");
+		if(start == string::npos)
+			return string();
+		if(start)
+			++start;
+		return contents.substr(start, contents.find('\n', start) - start);
+	}
+
+
+	// Get the date line of a saved game that is on disk, without reading the
+	// rest of the file.
+	string SavedDateLine(const filesystem::path &path)
+	{
+		shared_ptr<iostream> in = Files::Open(path);
+		if(!in)
+			return string();
+
+		// A compressed save only needs to have its beginning decompressed.
+		char header[2];
+		in->read(header, sizeof(header));
+		if(Gzip::IsCompressed(string_view(header, in->gcount())))
+		{
+			string line = DateLine(Gzip::Decompress(Files::Read(path), DATE_SEARCH_LIMIT));
+			if(line.ends_with('\r'))
+				line.pop_back();
+			return line;
+		}
+		in->clear();
+		in->seekg(0);
+
+		string line;
+		while(getline(*in, line))
+			if(line.starts_with("date "))
+			{
+				if(line.ends_with('\r'))
+					line.pop_back();
+				return line;
+			}
+		return string();
+	}
+
+
+	// Write the contents to a temporary file, and only replace the original
+	// file once that has succeeded.
+	void WriteAtomically(const filesystem::path &path, const string &contents, bool compress)
+	{
+		filesystem::path temporary = path;
+		temporary += "~~writing";
+		bool success = false;
+		{
+			shared_ptr<iostream> out = Files::Open(temporary, true);
+			if(out)
+			{
+				if(compress)
+				{
+					Gzip::Compressor compressor([&out](const char *data, size_t size) { out->write(data, size); });
+					compressor.Write(contents.data(), contents.size());
+					compressor.Finish();
+				}
+				else
+					*out << contents;
+				out->flush();
+				success = !out->fail();
+			}
+		}
+		if(success)
+			Files::Move(temporary, path);
+		else
+		{
+			Logger::Log("Unable to write \"" + path.string() + "\".", Logger::Level::ERROR);
+			if(Files::Exists(temporary))
+				Files::Delete(temporary);
+		}
+	}
+
+
+	// Move the existing save into the backups if the new save is from a
+	// different date, then write the new save.
+	void WriteSave(const Job &job)
+	{
+		const string &name = job.path.string();
+		if(name.ends_with(".txt") && SavedDateLine(job.path) != DateLine(job.contents))
+		{
+			const string rootPrevious = name.substr(0, name.length() - 4) + "~~previous-";
+			for(int i = job.previousCount - 1; i > 0; --i)
+			{
+				const string toMove = rootPrevious + to_string(i) + ".txt";
+				if(Files::Exists(toMove))
+					Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+			}
+			if(Files::Exists(job.path))
+				Files::Move(job.path, rootPrevious + "1.txt");
+			if(job.spaceportBackup)
+				WriteAtomically(rootPrevious + "spaceport.txt", job.contents, job.compress);
+		}
+		WriteAtomically(job.path, job.contents, job.compress);
+	}
+
+
+	void WriteJob(const Job &job)
+	{
+		try {
+			if(job.isSave)
+				WriteSave(job);
+			else
+				WriteAtomically(job.path, job.contents, job.compress);
+		}
+		catch(const exception &e)
+		{
+			Logger::Log("Unable to write \"" + job.path.string() + "\": " + e.what(), Logger::Level::ERROR);
+		}
+	}
+
+
+	void WriterLoop() noexcept
+	{
+		unique_lock<mutex> lock(jobMutex);
+		while(true)
+		{
+			jobCondition.wait(lock, []() noexcept -> bool { return shouldQuit || !jobs.empty(); });
+			// Finish writing everything before quitting.
+			if(jobs.empty())
+				break;
+
+			Job job = std::move(jobs.front());
+			jobs.pop_front();
+			isWriting = true;
+			lock.unlock();
+
+			WriteJob(job);
+
+			lock.lock();
+			isWriting = false;
+			if(jobs.empty())
+				doneCondition.notify_all();
+		}
+	}
+
+
+	void Queue(Job &&job)
+	{
+		if(job.isSave)
+			job.date = DateLine(job.contents);
+		{
+			lock_guard<mutex> lock(jobMutex);
+			if(!shouldQuit)
+			{
+				if(!writerThread.joinable())
+					writerThread = thread(&WriterLoop);
+
+				// If the last contents queued for this file are still waiting to be
+				// written and would be written the same way, they no longer need to be.
+				auto it = find_if(jobs.rbegin(), jobs.rend(), [&job](const Job &other) { return other.path == job.path; });
+				if(it != jobs.rend() && it->isSave == job.isSave && it->date == job.date
+						&& it->spaceportBackup == job.spaceportBackup)
+					*it = std::move(job);
+				else
+					jobs.push_back(std::move(job));
+				jobCondition.notify_one();
+				return;
+			}
+		}
+		// The background thread has already been stopped.
+		WriteJob(job);
+	}
+}
+
+
+
+// Write a saved game, moving the previous save into the backups if it is from
+// a different date than this one.
+void SaveWriter::Save(const filesystem::path &path, string contents, bool compress,
+	int previousCount, bool spaceportBackup)
+{
+	Queue(Job{path, std::move(contents), compress, true, previousCount, spaceportBackup});
+}
+
+
+
+// Write the given contents to a file, compressing them if requested.
+void SaveWriter::Write(const filesystem::path &path, string contents, bool compress)
+{
+	Queue(Job{path, std::move(contents), compress});
+}
+
+
+
+// Wait until every file that has been queued has been written.
+void SaveWriter::Wait()
+{
+	unique_lock<mutex> lock(jobMutex);
+	doneCondition.wait(lock, []() noexcept -> bool { return jobs.empty() && !isWriting; });
+}
+
+
+
+// Write every file that has been queued, then stop the background thread.
+void SaveWriter::Shutdown()
+{
+	{
+		lock_guard<mutex> lock(jobMutex);
+		shouldQuit = true;
+	}
+	jobCondition.notify_all();
+	if(writerThread.joinable())
+		writerThread.join();
+}
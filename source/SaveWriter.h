@@ -0,0 +1,50 @@
+/* SaveWriter.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+
+
+// Class for writing saved games on a background thread, so that the game does
+// not stall while a large save file is written to disk. The contents of each
+// save are captured on the main thread, and if a file is saved again with the
+// same date before the previous contents were written, only the newest contents
+// are written. Each file is first written to a temporary file which then
+// replaces the original, so that a save is never left half written. The thread
+// is started when the first file is queued, and Shutdown() must be called
+// before the program exits.
+class SaveWriter {
+public:
+	// Write a saved game. If the file already exists and is from a different
+	// date than the new contents, it is first moved to the "~~previous-1"
+	// backup (moving the older backups down to make room for it, and keeping
+	// at most the given number of them). If requested, the new contents are
+	// then also written to the "~~previous-spaceport" backup. Compressed saves
+	// are written in gzip format, but keep the same file names.
+	static void Save(const std::filesystem::path &path, std::string contents, bool compress,
+		int previousCount, bool spaceportBackup);
+	// Write the given contents to a file, compressing them if requested.
+	static void Write(const std::filesystem::path &path, std::string contents, bool compress = false);
+
+	// Wait until every file that has been queued has been written. This must be
+	// done before reading any saved games from disk.
+	static void Wait();
+	// Write every file that has been queued, then stop the background thread.
+	// Any files queued after this are written immediately.
+	static void Shutdown();
+};
@@ -15,16 +15,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "SavedGame.h"
 
-#include "DataFile.h"
 #include "DataNode.h"
 #include "Date.h"
 #include "Files.h"
 #include "text/Format.h"
 #include "GameData.h"
 #include "Planet.h"
+#include "SavedGameIndex.h"
 #include "image/SpriteSet.h"
 #include "System.h"
 
+#include <memory>
+
 using namespace std;
 
 
@@ -39,14 +41,16 @@ SavedGame::SavedGame(const filesystem::path &path)
 void SavedGame::Load(const filesystem::path &path)
 {
 	Clear();
-	DataFile file(path);
-	if(file.begin() != file.end())
-		this->path = path;
+	// Only the start of each saved game is needed, and it is usually indexed.
+	shared_ptr<const DataNode> header = SavedGameIndex::Header(path);
+	if(!header)
+		return;
+	this->path = path;
 
 	int flagshipIterator = -1;
 	int flagshipTarget = 0;
 
-	for(const DataNode &node : file)
+	for(const DataNode &node : *header)
 	{
 		const string &key = node.Token(0);
 		bool hasValue = node.Size() >= 2;
@@ -0,0 +1,398 @@
+/* SavedGameIndex.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SavedGameIndex.h"
+
+#include "DataFile.h"
+#include "DataNode.h"
+#include "DataWriter.h"
+#include "Files.h"
+#include "Gzip.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using namespace std;
+
+namespace {
+	// The index does not end in ".txt", so it is never mistaken for a saved game.
+	const string INDEX_NAME = "saved games.index";
+	// How much of a saved game to read at a time while looking for the end of
+	// the fields that are indexed.
+	const size_t BLOCK_SIZE = 64 * 1024;
+
+	// The size and modification time of a saved game when it was indexed.
+	class FileInfo {
+	public:
+		bool operator==(const FileInfo &other) const = default;
+
+		uintmax_t size = 0;
+		int64_t time = 0;
+	};
+
+	class Entry {
+	public:
+		FileInfo info;
+		shared_ptr<const DataNode> header;
+	};
+
+	mutex indexMutex;
+	map<string, Entry> entries;
+	bool isLoaded = false;
+	bool isChanged = false;
+	// Saved games waiting to be indexed by the refresh thread.
+	deque<string> stale;
+	bool isRefreshing = false;
+	bool shouldQuit = false;
+	// The thread that refreshes the index, which is only running while there
+	// is something to do. It is joined by SavedGameIndex::Shutdown().
+	thread refreshThread;
+
+
+	bool GetInfo(const filesystem::path &path, FileInfo &info)
+	{
+		error_code error;
+		info.size = filesystem::file_size(path, error);
+		if(error)
+			return false;
+		info.time = filesystem::last_write_time(path, error).time_since_epoch().count();
+		return !error;
+	}
+
+
+	int64_t ToInteger(const string &token)
+	{
+		int64_t value = 0;
+		from_chars(token.data(), token.data() + token.size(), value);
+		return value;
+	}
+
+
+	// Saved games list the player's accounts after their ships and all the
+	// other fields that are indexed, so nothing after the end of the "account"
+	// node needs to be read. Scan the given text, starting from the given line,
+	// and return where the "account" node ends, or npos if the text does not
+	// extend that far yet. Only complete lines are scanned, so the scan can be
+	// continued once more text has been read.
+	size_t HeaderEnd(string_view text, size_t &pos, bool &inAccount)
+	{
+		while(pos < text.size())
+		{
+			size_t next = text.find('\n', pos);
+			if(next == string_view::npos)
+				break;
+
+			string_view line = text.substr(pos, next - pos);
+			if(line.ends_with('\r'))
+				line.remove_suffix(1);
+			if(!line.empty() && line[0] != '\t' && line[0] != ' ' && line[0] != '#')
+			{
+				if(inAccount)
+					return pos;
+				inAccount = (line == "account");
+			}
+			pos = next + 1;
+		}
+		return string::npos;
+	}
+
+
+	// Decompress only as much of a compressed saved game as is needed.
+	string ReadCompressedHeader(const string &data)
+	{
+		for(size_t limit = 4 * BLOCK_SIZE; ; limit *= 4)
+		{
+			string text = Gzip::Decompress(data, limit);
+			size_t pos = 0;
+			bool inAccount = false;
+			size_t end = HeaderEnd(text, pos, inAccount);
+			if(end != string::npos)
+				text.resize(end);
+			if(end != string::npos || text.size() < limit)
+				return text;
+		}
+	}
+
+
+	// Read the start of a saved game, up to the end of the fields that are indexed.
+	string ReadHeader(const filesystem::path &path)
+	{
+		shared_ptr<iostream> in = Files::Open(path);
+		if(!in)
+			return string();
+
+		string text;
+		size_t pos = 0;
+		bool inAccount = false;
+		while(*in)
+		{
+			size_t size = text.size();
+			text.resize(size + BLOCK_SIZE);
+			in->read(&text[size], BLOCK_SIZE);
+			text.resize(size + in->gcount());
+			if(!size && Gzip::IsCompressed(text))
+				return ReadCompressedHeader(text + Files::Read(in));
+
+			size_t end = HeaderEnd(text, pos, inAccount);
+			if(end != string::npos)
+			{
+				text.resize(end);
+				break;
+			}
+		}
+		return text;
+	}
+
+
+	// Read the fields that are shown in the "Load Game" panel from the given
+	// saved game. The flagship is always the only ship that is kept.
+	shared_ptr<const DataNode> ReadEntry(const filesystem::path &path, const string &name, const FileInfo &info)
+	{
+		istringstream in(ReadHeader(path));
+		DataFile file(in);
+
+		DataWriter out;
+		out.Write("save", name, info.size, info.time);
+		out.BeginChild();
+		{
+			int flagshipIndex = 0;
+			int shipIndex = -1;
+			for(const DataNode &node : file)
+			{
+				const string &key = node.Token(0);
+				if(key == "pilot" || key == "date" || key == "system" || key == "planet" || key == "playtime")
+					out.Write(node);
+				else if(key == "flagship index" && node.Size() >= 2)
+					flagshipIndex = node.Value(1);
+				else if(key == "account")
+				{
+					for(const DataNode &child : node)
+						if(child.Token(0) == "credits")
+						{
+							out.Write("account");
+							out.BeginChild();
+							out.Write(child);
+							out.EndChild();
+							break;
+						}
+				}
+				else if(key == "ship" && ++shipIndex == flagshipIndex)
+				{
+					out.Write("flagship index", 0);
+					out.Write("ship");
+					out.BeginChild();
+					for(const DataNode &child : node)
+						if(child.Token(0) == "name" || child.Token(0) == "sprite")
+							out.Write(child);
+					out.EndChild();
+				}
+			}
+		}
+		out.EndChild();
+
+		istringstream entry(std::move(out).SaveToString());
+		DataFile result(entry);
+		return make_shared<const DataNode>(*result.begin());
+	}
+
+
+	// Read the index from disk. This must be called with the mutex held.
+	void LoadIndex()
+	{
+		if(isLoaded)
+			return;
+		isLoaded = true;
+
+		DataFile file(Files::Saves() / INDEX_NAME);
+		for(const DataNode &node : file)
+			if(node.Token(0) == "save" && node.Size() >= 4)
+			{
+				Entry &entry = entries[node.Token(1)];
+				entry.info.size = ToInteger(node.Token(2));
+				entry.info.time = ToInteger(node.Token(3));
+				entry.header = make_shared<const DataNode>(node);
+			}
+	}
+
+
+	// Get the contents of the index file. This must be called with the mutex held.
+	string IndexContents()
+	{
+		DataWriter out;
+		for(const auto &it : entries)
+			out.Write(*it.second.header);
+		return std::move(out).SaveToString();
+	}
+
+
+	void RefreshLoop() noexcept
+	{
+		unique_lock<mutex> lock(indexMutex);
+		while(!shouldQuit)
+		{
+			if(!stale.empty())
+			{
+				string name = std::move(stale.front());
+				stale.pop_front();
+				lock.unlock();
+
+				const filesystem::path path = Files::Saves() / name;
+				FileInfo info;
+				shared_ptr<const DataNode> header;
+				try {
+					if(GetInfo(path, info))
+						header = ReadEntry(path, name, info);
+				}
+				catch(const exception &)
+				{
+					// Anything that cannot be indexed now will be read when it is needed.
+				}
+
+				lock.lock();
+				if(header)
+				{
+					entries[name] = Entry{info, std::move(header)};
+					isChanged = true;
+				}
+				continue;
+			}
+
+			// Write the index once everything in it is up to date.
+			if(!isChanged)
+				break;
+			isChanged = false;
+			string contents = IndexContents();
+			lock.unlock();
+			Files::Write(Files::Saves() / INDEX_NAME, contents);
+			lock.lock();
+		}
+		isRefreshing = false;
+	}
+
+
+	// Start the refresh thread, if it is not already running. This must be
+	// called with the mutex held.
+	void StartRefresh()
+	{
+		if(isRefreshing || shouldQuit)
+			return;
+		// The previous refresh has finished, but its thread must still be joined.
+		if(refreshThread.joinable())
+			refreshThread.join();
+		isRefreshing = true;
+		refreshThread = thread(&RefreshLoop);
+	}
+}
+
+
+
+// Check every saved game against the index, and re-read any that are new or
+// have changed on a background thread.
+void SavedGameIndex::Refresh()
+{
+	lock_guard<mutex> lock(indexMutex);
+	LoadIndex();
+
+	set<string> names;
+	for(const filesystem::path &path : Files::List(Files::Saves()))
+	{
+		if(path.extension() != ".txt")
+			continue;
+
+		string name = Files::Name(path);
+		names.insert(name);
+		FileInfo info;
+		if(!GetInfo(path, info))
+			continue;
+		auto it = entries.find(name);
+		if((it == entries.end() || it->second.info != info) && find(stale.begin(), stale.end(), name) == stale.end())
+			stale.push_back(name);
+	}
+
+	// Forget about any saved games that have been deleted.
+	isChanged |= erase_if(entries, [&names](const auto &it) { return !names.contains(it.first); });
+
+	if(!stale.empty() || isChanged)
+		StartRefresh();
+}
+
+
+
+// Get a node whose children are the indexed fields of the given saved game.
+shared_ptr<const DataNode> SavedGameIndex::Header(const filesystem::path &path)
+{
+	FileInfo info;
+	if(!GetInfo(path, info))
+		return nullptr;
+
+	// Only the saves directory is indexed.
+	const string name = Files::Name(path);
+	if(path != Files::Saves() / name)
+	{
+		shared_ptr<const DataNode> header = ReadEntry(path, name, info);
+		return header->HasChildren() ? header : nullptr;
+	}
+
+	shared_ptr<const DataNode> header;
+	{
+		lock_guard<mutex> lock(indexMutex);
+		LoadIndex();
+		auto it = entries.find(name);
+		if(it != entries.end() && it->second.info == info)
+			header = it->second.header;
+		else
+		{
+			// This save is needed now, so there is no need for the refresh
+			// thread to read it too.
+			auto staleIt = find(stale.begin(), stale.end(), name);
+			if(staleIt != stale.end())
+				stale.erase(staleIt);
+		}
+	}
+
+	if(!header)
+	{
+		header = ReadEntry(path, name, info);
+		lock_guard<mutex> lock(indexMutex);
+		entries[name] = Entry{info, header};
+		isChanged = true;
+		StartRefresh();
+	}
+	return header->HasChildren() ? header : nullptr;
+}
+
+
+
+// Stop the background thread, abandoning any refresh that is in progress.
+void SavedGameIndex::Shutdown()
+{
+	{
+		lock_guard<mutex> lock(indexMutex);
+		shouldQuit = true;
+	}
+	// The thread is never started again once this is set, so it can be joined
+	// without holding the mutex.
+	if(refreshThread.joinable())
+		refreshThread.join();
+}
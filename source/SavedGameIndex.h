@@ -0,0 +1,46 @@
+/* SavedGameIndex.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+class DataNode;
+
+
+
+// Class keeping an index of the few fields from the start of each saved game
+// that the "Load Game" panel displays, so that a saved game does not need to be
+// read and parsed every time it is selected. The index is stored in the saves
+// directory, and each entry is only trusted if the size and modification time
+// of its saved game have not changed since it was indexed.
+class SavedGameIndex {
+public:
+	// Check every saved game against the index, and re-read any that are new
+	// or have changed on a background thread.
+	static void Refresh();
+
+	// Get a node whose children are the indexed fields of the given saved game,
+	// in the same format as they are in the saved game itself. If the index
+	// is out of date, the saved game is read now. Returns null if the file is
+	// empty or does not exist.
+	static std::shared_ptr<const DataNode> Header(const std::filesystem::path &path);
+
+	// Stop the background thread, abandoning any refresh that is in progress.
+	// This must be called before the program exits. After that, the index is
+	// no longer refreshed.
+	static void Shutdown();
+};
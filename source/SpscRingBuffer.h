@@ -0,0 +1,133 @@
+/* SpscRingBuffer.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+
+
+// A fixed-size buffer that one thread writes items into while another thread
+// reads them out, without either of them waiting on a lock. Rather than copying
+// items in and out, the writer fills in the free space of the buffer directly,
+// and the reader looks at the stored items in place before discarding them.
+// Because the buffer wraps around, the free space and the stored items may each
+// be split in two; each view only covers the part before the wrap.
+template<class Type>
+class SpscRingBuffer {
+public:
+	explicit SpscRingBuffer(size_t capacity);
+	SpscRingBuffer(const SpscRingBuffer &) = delete;
+	SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+	size_t Capacity() const noexcept;
+	// Get the number of items that can be read. If this is called by a thread
+	// other than the reader or the writer, the result may already be out of date.
+	size_t Size() const noexcept;
+
+	// Get the free space that can be written to before the end of the buffer.
+	// This must only be called by the writer.
+	std::span<Type> WriteView() noexcept;
+	// Make the given number of items at the start of the write view readable.
+	void Commit(size_t count) noexcept;
+
+	// Get the stored items up to the end of the buffer. This must only be called
+	// by the reader.
+	std::span<const Type> ReadView() const noexcept;
+	// Discard the given number of items from the start of the read view.
+	void Consume(size_t count) noexcept;
+
+
+private:
+	std::vector<Type> items;
+	// The total number of items that have ever been written and read. The reader
+	// and the writer each update a different one, so keep them on separate
+	// cache lines.
+	alignas(64) std::atomic<size_t> written = 0;
+	alignas(64) std::atomic<size_t> read = 0;
+};
+
+
+
+template<class Type>
+SpscRingBuffer<Type>::SpscRingBuffer(size_t capacity)
+	: items(capacity)
+{
+}
+
+
+
+template<class Type>
+size_t SpscRingBuffer<Type>::Capacity() const noexcept
+{
+	return items.size();
+}
+
+
+
+// Get the number of items that can be read.
+template<class Type>
+size_t SpscRingBuffer<Type>::Size() const noexcept
+{
+	// Check the reader first, so that the writer cannot appear to be behind it.
+	size_t start = read.load(std::memory_order_acquire);
+	return written.load(std::memory_order_acquire) - start;
+}
+
+
+
+// Get the free space that can be written to before the end of the buffer.
+template<class Type>
+std::span<Type> SpscRingBuffer<Type>::WriteView() noexcept
+{
+	size_t end = written.load(std::memory_order_relaxed);
+	size_t space = items.size() - (end - read.load(std::memory_order_acquire));
+	size_t position = end % items.size();
+	return std::span<Type>(items.data() + position, std::min(space, items.size() - position));
+}
+
+
+
+// Make the given number of items at the start of the write view readable.
+template<class Type>
+void SpscRingBuffer<Type>::Commit(size_t count) noexcept
+{
+	written.store(written.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+
+
+// Get the stored items up to the end of the buffer.
+template<class Type>
+std::span<const Type> SpscRingBuffer<Type>::ReadView() const noexcept
+{
+	size_t start = read.load(std::memory_order_relaxed);
+	size_t size = written.load(std::memory_order_acquire) - start;
+	size_t position = start % items.size();
+	return std::span<const Type>(items.data() + position, std::min(size, items.size() - position));
+}
+
+
+
+// Discard the given number of items from the start of the read view.
+template<class Type>
+void SpscRingBuffer<Type>::Consume(size_t count) noexcept
+{
+	read.store(read.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
@@ -100,7 +100,7 @@ StartConditionsPanel::StartConditionsPanel(PlayerInfo &player, UI &gamePanels,
 	for(const StartConditions &scenario : scenarios)
 		SpriteLoadManager::LoadDeferred(queue, scenario.GetThumbnail());
 	queue.Wait();
-	queue.ProcessSyncTasks();
+	queue.ProcessSyncTasks(true);
 }
 
 
@@ -27,6 +27,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Planet.h"
 #include "Random.h"
 #include "image/SpriteSet.h"
+#include "SystemGrid.h"
 
 #include <algorithm>
 #include <cmath>
@@ -519,7 +520,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets, const ConditionsSt
 // Update any information about the system that may have changed due to events,
 // or because the game was started, e.g. neighbors, solar wind and power, or
 // if the system is inhabited.
-void System::UpdateSystem(const Set<System> &systems, const set<double> &neighborDistances)
+void System::UpdateSystem(const SystemGrid &grid, const set<double> &neighborDistances)
 {
 	accessibleLinks.clear();
 	neighbors.clear();
@@ -548,15 +549,15 @@ void System::UpdateSystem(const Set<System> &systems, const set<double> &neighbo
 	// jump range that can be encountered.
 	if(jumpRange)
 	{
-		UpdateNeighbors(systems, jumpRange);
+		UpdateNeighbors(grid, jumpRange);
 		// Systems with a static jump range must also create a set for
 		// the DEFAULT_NEIGHBOR_DISTANCE to be returned for those systems
 		// which are visible from it.
-		UpdateNeighbors(systems, DEFAULT_NEIGHBOR_DISTANCE);
+		UpdateNeighbors(grid, DEFAULT_NEIGHBOR_DISTANCE);
 	}
 	else
 		for(const double distance : neighborDistances)
-			UpdateNeighbors(systems, distance);
+			UpdateNeighbors(grid, distance);
 
 	// Cache the map star icons.
 	mapIcons.clear();
@@ -684,6 +685,14 @@ const set<const System *> &System::Links() const
 
 
 
+// Get every system this system is linked to, even if it is not accessible.
+const set<const System *> &System::AllLinks() const
+{
+	return links;
+}
+
+
+
 // Get a list of systems that can be jumped to from here with the given
 // jump distance, whether or not there is a direct hyperspace link to them.
 // If this system has its own jump range, then it will always return the
@@ -1143,7 +1152,7 @@ void System::LoadObjectHelper(const DataNode &node, StellarObject &object, bool
 // Once the star map is fully loaded or an event has changed systems
 // or links, figure out which stars are "neighbors" of this one, i.e.
 // close enough to see or to reach via jump drive.
-void System::UpdateNeighbors(const Set<System> &systems, double distance)
+void System::UpdateNeighbors(const SystemGrid &grid, double distance)
 {
 	set<const System *> &neighborSet = neighbors[distance];
 
@@ -1153,17 +1162,12 @@ void System::UpdateNeighbors(const Set<System> &systems, double distance)
 		neighborSet.insert(system);
 
 	// Any other star system that is within the neighbor distance is also a
-	// neighbor.
-	for(const auto &it : systems)
-	{
-		const System &other = it.second;
-		// Skip systems that are invalid or inaccessible.
-		if(!other.IsValid() || other.Inaccessible())
-			continue;
-
-		if(&other != this && other.Position().Distance(position) <= distance)
-			neighborSet.insert(&other);
-	}
+	// neighbor. The grid only contains systems that are valid and accessible.
+	vector<const System *> nearby;
+	grid.Circle(position, distance, nearby);
+	for(const System *other : nearby)
+		if(other != this)
+			neighborSet.insert(other);
 }
 
 
@@ -37,6 +37,7 @@ class Outfit;
 class Planet;
 class Ship;
 class Sprite;
+class SystemGrid;
 
 
 
@@ -78,7 +79,7 @@ public:
 	void Load(const DataNode &node, Set<Planet> &planets, const ConditionsStore *playerConditions);
 	// Update any information about the system that may have changed due to events,
 	// e.g. neighbors, solar wind and power, or if the system is inhabited.
-	void UpdateSystem(const Set<System> &systems, const std::set<double> &neighborDistances);
+	void UpdateSystem(const SystemGrid &grid, const std::set<double> &neighborDistances);
 
 	// Modify a system's links.
 	void Link(System *other);
@@ -102,6 +103,8 @@ public:
 
 	// Get a list of systems you can travel to through hyperspace from here.
 	const std::set<const System *> &Links() const;
+	// Get every system this system is linked to, even if it is not accessible.
+	const std::set<const System *> &AllLinks() const;
 	// Get a list of systems that can be jumped to from here with the given
 	// jump distance, whether or not there is a direct hyperspace link to them.
 	// If this system has its own jump range, then it will always return the
@@ -196,7 +199,7 @@ private:
 	// Once the star map is fully loaded or an event has changed systems
 	// or links, figure out which stars are "neighbors" of this one, i.e.
 	// close enough to see or to reach via jump drive.
-	void UpdateNeighbors(const Set<System> &systems, double distance);
+	void UpdateNeighbors(const SystemGrid &grid, double distance);
 
 
 private:
@@ -0,0 +1,95 @@
+/* SystemGrid.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SystemGrid.h"
+
+#include "System.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// Most neighbor lookups use the default jump range, so make each cell just
+	// big enough that those lookups only need to check a few cells.
+	int64_t Cell(double coordinate)
+	{
+		return static_cast<int64_t>(floor(coordinate / System::DEFAULT_NEIGHBOR_DISTANCE));
+	}
+}
+
+
+
+// Update the grid to match the given systems. The grid is only rebuilt if a
+// system has been added, removed, or moved since the last update. Returns
+// true if anything changed.
+bool SystemGrid::Update(const Set<System> &systems)
+{
+	vector<pair<const System *, Point>> current;
+	current.reserve(entries.size());
+	for(const auto &it : systems)
+		if(it.second.IsValid() && !it.second.Inaccessible())
+			current.emplace_back(&it.second, it.second.Position());
+	if(current == entries)
+		return false;
+
+	entries = std::move(current);
+	cells.clear();
+	for(const auto &[system, position] : entries)
+		cells[Key(Cell(position.X()), Cell(position.Y()))].push_back(system);
+	return true;
+}
+
+
+
+// Get all systems within the given distance of the given point.
+void SystemGrid::Circle(const Point &center, double radius, vector<const System *> &result) const
+{
+	auto Check = [&center, radius, &result](const vector<const System *> &cell)
+	{
+		for(const System *system : cell)
+			if(system->Position().Distance(center) <= radius)
+				result.push_back(system);
+	};
+
+	const int64_t minX = Cell(center.X() - radius);
+	const int64_t maxX = Cell(center.X() + radius);
+	const int64_t minY = Cell(center.Y() - radius);
+	const int64_t maxY = Cell(center.Y() + radius);
+
+	// For a very large radius it is quicker to check every occupied cell than
+	// to look up every cell the circle might overlap.
+	if(static_cast<double>(maxX - minX + 1) * (maxY - minY + 1) > cells.size())
+	{
+		for(const auto &it : cells)
+			Check(it.second);
+		return;
+	}
+
+	for(int64_t y = minY; y <= maxY; ++y)
+		for(int64_t x = minX; x <= maxX; ++x)
+		{
+			auto it = cells.find(Key(x, y));
+			if(it != cells.end())
+				Check(it->second);
+		}
+}
+
+
+
+uint64_t SystemGrid::Key(int64_t x, int64_t y)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
@@ -0,0 +1,54 @@
+/* SystemGrid.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Point.h"
+#include "Set.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class System;
+
+
+
+// A SystemGrid allows quickly finding every star system within a certain
+// distance of a point on the star map, by splitting the map up into square
+// cells and keeping track of which systems are in each cell. Only systems that
+// are valid and accessible are included, since those are the only ones that
+// can be anyone's neighbors.
+class SystemGrid {
+public:
+	// Update the grid to match the given systems. The grid is only rebuilt if a
+	// system has been added, removed, or moved since the last update. Returns
+	// true if anything changed.
+	bool Update(const Set<System> &systems);
+
+	// Get all systems within the given distance of the given point.
+	void Circle(const Point &center, double radius, std::vector<const System *> &result) const;
+
+
+private:
+	static uint64_t Key(int64_t x, int64_t y);
+
+
+private:
+	// Every system in the grid, and where it was when the grid was built.
+	std::vector<std::pair<const System *, Point>> entries;
+	std::unordered_map<uint64_t, std::vector<const System *>> cells;
+};
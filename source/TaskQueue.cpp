@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <chrono>
 #include <condition_variable>
 #include <exception>
+#include <limits>
 
 using namespace std;
 
@@ -53,6 +54,10 @@ namespace {
 
 		vector<thread> threads;
 	} threads;
+
+	// How many more bytes upload tasks may copy to the GPU in this frame. This is
+	// only used on the main thread.
+	int64_t uploadBudget = TaskQueue::MAX_FRAME_UPLOAD_BYTES;
 }
 
 
@@ -70,10 +75,22 @@ void TaskQueue::SetWorkerThreadCount(uint64_t count)
 
 
 
+void TaskQueue::ResetUploadBudget()
+{
+	uploadBudget = MAX_FRAME_UPLOAD_BYTES;
+}
+
+
+
 TaskQueue::~TaskQueue()
 {
 	// Make sure every task that belongs to this queue is finished.
 	Wait();
+
+	// Uploads that are not finished yet will never be, so let them free their data.
+	for( ; !uploadTasks.empty(); uploadTasks.pop())
+		if(uploadTasks.front().cancel)
+			uploadTasks.front().cancel();
 }
 
 
@@ -102,8 +119,17 @@ shared_future<void> TaskQueue::Run(function<void()> asyncTask, function<void()>
 
 
 
+// Queue a function that copies data to the GPU a part at a time.
+void TaskQueue::RunUpload(function<bool(int64_t &budget)> uploadTask, function<void()> cancelTask)
+{
+	lock_guard<mutex> lock(syncMutex);
+	uploadTasks.push(Upload{std::move(uploadTask), std::move(cancelTask)});
+}
+
+
+
 // Process any tasks to be scheduled to be executed on the main thread.
-void TaskQueue::ProcessSyncTasks()
+void TaskQueue::ProcessSyncTasks(bool finishUploads)
 {
 	unique_lock<mutex> lock(syncMutex);
 	for(int i = 0; !syncTasks.empty() && i < MAX_SYNC_TASKS; ++i)
@@ -116,6 +142,24 @@ void TaskQueue::ProcessSyncTasks()
 		task();
 		lock.lock();
 	}
+
+	// Work through the uploads in order until this frame's share of bytes is used up.
+	// An unfinished upload stays at the front of the queue to be continued next time.
+	int64_t unlimited = numeric_limits<int64_t>::max();
+	int64_t &budget = finishUploads ? unlimited : uploadBudget;
+	while(!uploadTasks.empty() && budget > 0)
+	{
+		// The tasks are only ever added to from this thread, so the front one
+		// stays in place while the lock is released.
+		auto &task = uploadTasks.front().upload;
+
+		lock.unlock();
+		bool isDone = task(budget);
+		lock.lock();
+
+		if(isDone)
+			uploadTasks.pop();
+	}
 }
 
 
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <list>
@@ -48,12 +49,18 @@ public:
 
 	// The maximum amount of sync tasks to execute in one go.
 	static constexpr int MAX_SYNC_TASKS = 100;
+	// The maximum number of bytes that upload tasks may copy to the GPU in each
+	// frame. This is shared by every queue, so that they cannot add up to more.
+	static constexpr int64_t MAX_FRAME_UPLOAD_BYTES = 8 << 20;
 
 
 public:
 	// Set the number of worker threads for TaskQueues to run their tasks on.
 	// If not used, a default based on system resources will be chosen.
 	static void SetWorkerThreadCount(uint64_t count);
+	// Let upload tasks copy another frame's worth of data to the GPU. This must be
+	// called from the main thread once per frame.
+	static void ResetUploadBudget();
 
 
 public:
@@ -68,14 +75,31 @@ public:
 	// Returns a future representing the future result of the async call. Ignores
 	// any main thread task that still need to be executed!
 	std::shared_future<void> Run(std::function<void()> asyncTask, std::function<void()> syncTask = {});
-
-	// Process any tasks to be scheduled to be executed on the main thread.
-	void ProcessSyncTasks();
+	// Queue a function that copies data to the GPU a part at a time, so that a large
+	// upload can be spread over several frames. It is called on the main thread with
+	// the number of bytes that may still be copied, which it must reduce by however
+	// much it copies, until it returns true to show that it is done. If the queue is
+	// destroyed before then, the optional cancel function is called instead, so that
+	// whatever was being copied can be freed. This must only be called from the main thread.
+	void RunUpload(std::function<bool(int64_t &budget)> uploadTask, std::function<void()> cancelTask = {});
+
+	// Process any tasks to be scheduled to be executed on the main thread. Unless
+	// the uploads are needed right away, they only copy as much data as is left
+	// of this frame's budget.
+	void ProcessSyncTasks(bool finishUploads = false);
 
 	// Waits for all of this queue's task to finish. Ignores any sync tasks to be processed.
 	void Wait();
 
 
+private:
+	// A task that copies data to the GPU over several calls.
+	struct Upload {
+		std::function<bool(int64_t &)> upload;
+		std::function<void()> cancel;
+	};
+
+
 private:
 	// Whether there are any outstanding async tasks left in this queue.
 	bool IsDone() const;
@@ -91,5 +115,6 @@ private:
 
 	// Tasks from this queue that need to be executed on the main thread.
 	std::queue<std::function<void()>> syncTasks;
+	std::queue<Upload> uploadTasks;
 	mutable std::mutex syncMutex;
 };
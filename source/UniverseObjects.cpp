@@ -19,8 +19,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "Files.h"
 #include "Information.h"
+#include "LocationIndex.h"
 #include "Logger.h"
 #include "PlayerInfo.h"
+#include "RouteHeuristic.h"
 #include "image/Sprite.h"
 #include "image/SpriteSet.h"
 #include "TaskQueue.h"
@@ -41,6 +43,7 @@ shared_future<void> UniverseObjects::Load(TaskQueue &queue, const vector<filesys
 	const PlayerInfo &player, const ConditionsStore *globalConditions, bool debugMode)
 {
 	progress = 0.;
+	verifySystemUpdates = debugMode;
 
 	// We need to copy any variables used for loading to avoid a race condition.
 	// 'this' is not copied, so 'this' shouldn't be accessed after calling this
@@ -146,6 +149,17 @@ void UniverseObjects::Change(const DataNode &node, PlayerInfo &player)
 	const set<const System *> *visitedSystems = &player.VisitedSystems();
 	const set<const Planet *> *visitedPlanets = &player.VisitedPlanets();
 
+	// A changed planet or wormhole may add or remove links between systems,
+	// which the route length estimates depend on.
+	{
+		lock_guard<mutex> lock(routeHeuristicMutex);
+		routeHeuristics.clear();
+	}
+	{
+		lock_guard<mutex> lock(locationIndexMutex);
+		locationIndex.reset();
+	}
+
 	const string &key = node.Token(0);
 	bool hasValue = node.Size() >= 2;
 	if(key == "fleet" && hasValue)
@@ -157,21 +171,44 @@ void UniverseObjects::Change(const DataNode &node, PlayerInfo &player)
 	else if(key == "outfitter" && hasValue)
 		outfitSales.Get(node.Token(1))->Load(node, outfits, playerConditions, visitedSystems, visitedPlanets);
 	else if(key == "planet" && hasValue)
-		planets.Get(node.Token(1))->Load(node, wormholes, playerConditions);
+	{
+		Planet *planet = planets.Get(node.Token(1));
+		TrackChange(planet);
+		planet->Load(node, wormholes, playerConditions);
+	}
 	else if(key == "shipyard" && hasValue)
 		shipSales.Get(node.Token(1))->Load(node, ships, playerConditions, visitedSystems, visitedPlanets);
 	else if(key == "system" && hasValue)
-		systems.Get(node.Token(1))->Load(node, planets, playerConditions);
+	{
+		// Any planets that are removed from this system, or added to it, may
+		// also change which other systems they are in.
+		System *system = systems.Get(node.Token(1));
+		TrackChange(system);
+		system->Load(node, planets, playerConditions);
+		TrackChange(system);
+	}
 	else if(key == "news" && hasValue)
 		news.Get(node.Token(1))->Load(node, playerConditions, visitedSystems, visitedPlanets);
-	else if(key == "link" && node.Size() >= 3)
-		systems.Get(node.Token(1))->Link(systems.Get(node.Token(2)));
-	else if(key == "unlink" && node.Size() >= 3)
-		systems.Get(node.Token(1))->Unlink(systems.Get(node.Token(2)));
+	else if((key == "link" || key == "unlink") && node.Size() >= 3)
+	{
+		System *first = systems.Get(node.Token(1));
+		System *second = systems.Get(node.Token(2));
+		TrackChange(first);
+		TrackChange(second);
+		if(key == "link")
+			first->Link(second);
+		else
+			first->Unlink(second);
+	}
 	else if(key == "substitutions" && node.HasChildren())
 		substitutions.Load(node, playerConditions);
 	else if(key == "wormhole" && hasValue)
-		wormholes.Get(node.Token(1))->Load(node);
+	{
+		Wormhole *wormhole = wormholes.Get(node.Token(1));
+		TrackChange(wormhole->GetPlanet());
+		wormhole->Load(node);
+		TrackChange(wormhole->GetPlanet());
+	}
 	else if(key == "event" && hasValue)
 	{
 		GameEvent eventCopy = *events.Get(node.Token(1));
@@ -185,29 +222,85 @@ void UniverseObjects::Change(const DataNode &node, PlayerInfo &player)
 
 
 
-// Update the neighbor lists and other information for all the systems.
+// Update the neighbor lists and other information for the systems that
+// may have been affected by any changes since the last update.
 // (This must be done any time a GameEvent creates or moves a system.)
 void UniverseObjects::UpdateSystems()
 {
-	for(auto &it : systems)
 	{
-		// Skip systems that have no name.
-		if(it.first.empty() || it.second.TrueName().empty())
-			continue;
-		it.second.UpdateSystem(systems, neighborDistances);
+		lock_guard<mutex> lock(routeHeuristicMutex);
+		routeHeuristics.clear();
+	}
+	// Updating a system may change whether it is "uninhabited."
+	{
+		lock_guard<mutex> lock(locationIndexMutex);
+		locationIndex.reset();
+	}
 
-		// If there were changes to a system there might have been a change to a legacy
-		// wormhole which we must handle.
-		for(const auto &object : it.second.Objects())
-			if(object.GetPlanet())
-				planets.Get(object.GetPlanet()->TrueName())->FinishLoading(wormholes);
+	// Each system keeps a list of neighbors for every jump range, so if a new
+	// jump range has been added every system must be updated.
+	if(neighborDistances != updatedNeighborDistances)
+		updateAllSystems = true;
+
+	systemGrid.Update(systems);
+	if(updateAllSystems)
+	{
+		for(auto &it : systems)
+			UpdateSystem(it.second);
 	}
+	else if(!changedSystems.empty())
+	{
+		// A system's neighbors are all the systems within its jump range, so a
+		// change to a system might affect any other system that is close enough
+		// to it to have that system as its neighbor, either before or after the
+		// change. Its links also affect any systems that are linked to it.
+		double range = System::DEFAULT_NEIGHBOR_DISTANCE;
+		if(!neighborDistances.empty())
+			range = max(range, *neighborDistances.rbegin());
+		set<const System *> affected;
+		for(const auto &it : systems)
+		{
+			range = max(range, it.second.JumpRange());
+			for(const System *link : it.second.AllLinks())
+				if(changedSystems.contains(link))
+				{
+					affected.insert(&it.second);
+					break;
+				}
+		}
+
+		vector<const System *> nearby;
+		for(const auto &[system, oldPosition] : changedSystems)
+		{
+			affected.insert(system);
+			systemGrid.Circle(system->Position(), range, nearby);
+			if(oldPosition != system->Position())
+				systemGrid.Circle(oldPosition, range, nearby);
+		}
+		affected.insert(nearby.begin(), nearby.end());
+
+		for(const System *system : affected)
+			UpdateSystem(*systems.Get(system->TrueName()));
+
+		if(verifySystemUpdates)
+			VerifySystemUpdates();
+	}
+
+	changedSystems.clear();
+	updateAllSystems = false;
+	updatedNeighborDistances = neighborDistances;
 }
 
 
 
 void UniverseObjects::RecomputeWormholeRequirements()
 {
+	// The wormholes may have changed, and with them the links between systems.
+	{
+		lock_guard<mutex> lock(routeHeuristicMutex);
+		routeHeuristics.clear();
+	}
+
 	// Create a complete set of all attributes that affect any wormhole in the universe.
 	universeWormholeRequirements.clear();
 	for(const auto &wormhole : std::views::values(wormholes))
@@ -218,6 +311,31 @@ void UniverseObjects::RecomputeWormholeRequirements()
 
 
 
+// Get the route length estimates for ships with the given jump range,
+// calculating them if this has not been done since systems last changed.
+shared_ptr<const RouteHeuristic> UniverseObjects::GetRouteHeuristic(double jumpRange) const
+{
+	lock_guard<mutex> lock(routeHeuristicMutex);
+	shared_ptr<const RouteHeuristic> &heuristic = routeHeuristics[jumpRange];
+	if(!heuristic)
+		heuristic = make_shared<RouteHeuristic>(systems, jumpRange);
+	return heuristic;
+}
+
+
+
+// Get the lists of which systems and planets have each attribute and
+// government, building them if this has not been done since the last change.
+shared_ptr<const LocationIndex> UniverseObjects::GetLocationIndex() const
+{
+	lock_guard<mutex> lock(locationIndexMutex);
+	if(!locationIndex)
+		locationIndex = make_shared<LocationIndex>(systems, planets);
+	return locationIndex;
+}
+
+
+
 // Check for objects that are referred to but never defined. Some elements, like
 // fleets, don't need to be given a name if undefined. Others (like outfits and
 // planets) are written to the player's save and need a name to prevent data loss.
@@ -734,3 +852,80 @@ void UniverseObjects::LoadFile(const filesystem::path &path, const PlayerInfo &p
 		overwrite = false;
 	}
 }
+
+
+
+// Remember that a change may have affected the given system.
+void UniverseObjects::TrackChange(const System *system)
+{
+	// Only the position the system had before it was first changed matters.
+	changedSystems.emplace(system, system->Position());
+	for(const auto &object : system->Objects())
+		TrackChange(object.GetPlanet());
+}
+
+
+
+// Remember that a change may have affected every system containing the given planet.
+void UniverseObjects::TrackChange(const Planet *planet)
+{
+	if(!planet)
+		return;
+	for(const System *system : planet->Systems())
+		changedSystems.emplace(system, system->Position());
+}
+
+
+
+// Update a single system, and any legacy wormholes in it.
+void UniverseObjects::UpdateSystem(System &system)
+{
+	// Skip systems that have no name.
+	if(system.TrueName().empty())
+		return;
+	system.UpdateSystem(systemGrid, neighborDistances);
+
+	// If there were changes to a system there might have been a change to a legacy
+	// wormhole which we must handle.
+	for(const auto &object : system.Objects())
+		if(object.GetPlanet())
+			planets.Get(object.GetPlanet()->TrueName())->FinishLoading(wormholes);
+}
+
+
+
+// Check that updating only the changed systems gave the same result as
+// updating every system would have, and log any systems that were missed.
+void UniverseObjects::VerifySystemUpdates()
+{
+	struct State {
+		set<const System *> links;
+		vector<set<const System *>> neighbors;
+		set<string> attributes;
+		vector<const Sprite *> mapIcons;
+		set<const Outfit *> payloads;
+		int minimumFleetPeriod;
+
+		bool operator==(const State &other) const = default;
+	};
+	auto GetState = [this](const System &system) -> State
+	{
+		State state{system.Links(), {}, system.Attributes(), system.GetMapIcons(), system.Payloads(),
+			system.MinimumFleetPeriod()};
+		for(double distance : neighborDistances)
+			state.neighbors.push_back(system.JumpNeighbors(distance));
+		return state;
+	};
+
+	map<const System *, State> partial;
+	for(const auto &it : systems)
+		partial.emplace(&it.second, GetState(it.second));
+
+	for(auto &it : systems)
+		UpdateSystem(it.second);
+
+	for(const auto &it : systems)
+		if(partial.at(&it.second) != GetState(it.second))
+			Logger::Log("System \"" + it.first + "\" was not correctly updated after a change.",
+				Logger::Level::WARNING);
+}
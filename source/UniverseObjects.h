@@ -39,11 +39,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Person.h"
 #include "Phrase.h"
 #include "Planet.h"
+#include "Point.h"
 #include "shader/Shader.h"
 #include "Ship.h"
 #include "StartConditions.h"
 #include "Swizzle.h"
 #include "System.h"
+#include "SystemGrid.h"
 #include "test/Test.h"
 #include "test/TestData.h"
 #include "TextReplacements.h"
@@ -54,14 +56,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <future>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
 #include <vector>
 
 class ConditionsStore;
+class LocationIndex;
 class Panel;
 class PlayerInfo;
+class RouteHeuristic;
 class Sprite;
 class TaskQueue;
 
@@ -84,11 +89,18 @@ public:
 
 	// Apply the given change to the universe.
 	void Change(const DataNode &node, PlayerInfo &player);
-	// Update the neighbor lists and other information for all the systems.
+	// Update the neighbor lists and other information for the systems that
+	// may have been affected by any changes since the last update.
 	// (This must be done any time a GameEvent creates or moves a system.)
 	void UpdateSystems();
 	// Determine which attributes may be required in order to use a wormhole.
 	void RecomputeWormholeRequirements();
+	// Get the route length estimates for ships with the given jump range,
+	// calculating them if this has not been done since systems last changed.
+	std::shared_ptr<const RouteHeuristic> GetRouteHeuristic(double jumpRange) const;
+	// Get the lists of which systems and planets have each attribute and
+	// government, building them if this has not been done since the last change.
+	std::shared_ptr<const LocationIndex> GetLocationIndex() const;
 
 	// Check for objects that are referred to but never defined.
 	void CheckReferences();
@@ -101,6 +113,15 @@ public:
 private:
 	void LoadFile(const std::filesystem::path &path, const PlayerInfo &player,
 		const ConditionsStore *globalConditions, bool debugMode = false);
+	// Remember that a change may have affected the given system, or every
+	// system that contains the given planet.
+	void TrackChange(const System *system);
+	void TrackChange(const Planet *planet);
+	// Update a single system, and any legacy wormholes in it.
+	void UpdateSystem(System &system);
+	// Check that updating only the changed systems gave the same result as
+	// updating every system would have.
+	void VerifySystemUpdates();
 
 
 private:
@@ -142,6 +163,23 @@ private:
 	// This is used for speeding up the route calculations.
 	std::set<std::string> universeWormholeRequirements;
 	std::set<double> neighborDistances;
+	// The positions of all systems, for finding each system's neighbors.
+	SystemGrid systemGrid;
+	// The systems that changes have touched since they were last updated, and
+	// where each of them was before it was changed. If something has happened
+	// that could affect every system, they are all updated instead.
+	std::map<const System *, Point> changedSystems;
+	bool updateAllSystems = true;
+	std::set<double> updatedNeighborDistances;
+	// In debug mode, compare every partial system update to a full one.
+	bool verifySystemUpdates = false;
+	// Route length estimates for each jump range, calculated when first needed.
+	mutable std::mutex routeHeuristicMutex;
+	mutable std::map<double, std::shared_ptr<const RouteHeuristic>> routeHeuristics;
+	// Which systems and planets match each kind of location filter, calculated
+	// when first needed after any change.
+	mutable std::mutex locationIndexMutex;
+	mutable std::shared_ptr<const LocationIndex> locationIndex;
 
 	TextReplacements substitutions;
 	Trade trade;
@@ -19,21 +19,26 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "supplier/effect/Fade.h"
 #include "../Files.h"
 #include "../Logger.h"
+#include "../MpscQueue.h"
 #include "Music.h"
 #include "player/MusicPlayer.h"
 #include "../Point.h"
+#include "../Preferences.h"
 #include "Sound.h"
+#include "../TaskQueue.h"
 
 #include <AL/al.h>
 #include <AL/alc.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -61,8 +66,12 @@ namespace {
 		player.Move(angle.X() * scale, angle.Y() * scale, -scale);
 	}
 
-	// Thread entry point for loading the sound files.
-	void Load();
+	// Read a sound's files on one of the worker threads, unless it is already
+	// loaded or being loaded.
+	void Load(const Sound *sound, bool isStartup);
+	// If sounds are using more memory than they are allowed to, free the ones
+	// that have gone the longest without being played.
+	void FreeUnusedSounds();
 
 
 	// Mutex to make sure different threads don't modify the audio at the same time.
@@ -78,11 +87,24 @@ namespace {
 	map<SoundCategory, double> volume{{SoundCategory::MASTER, .125}};
 	map<SoundCategory, double> cachedVolume;
 
+	// A request to play a sound from a thread other than the main one.
+	class Request {
+	public:
+		const Sound *sound = nullptr;
+		Point position;
+		SoundCategory category = SoundCategory::MASTER;
+	};
+
 	// This queue keeps track of sounds that have been requested to play. Each
 	// added sound is "deferred" until the next audio position update to make
 	// sure that all sounds from a given frame start at the same time.
 	map<const Sound *, QueueEntry> soundQueue;
+	// Sounds requested from other threads are passed to the main thread without
+	// locking. In the rare case that more sounds are requested in one frame than
+	// the queue can hold, the rest are added to the deferred map instead.
+	MpscQueue<Request, 4096> requests;
 	map<const Sound *, QueueEntry> deferred;
+	atomic<bool> hasDeferred = false;
 	thread::id mainThreadID;
 
 	// Sound resources that have been loaded from files.
@@ -93,9 +115,31 @@ namespace {
 	/// The looping players for reuse. Looping sources always have the Fade effect.
 	map<const Sound *, shared_ptr<AudioPlayer>> loopingPlayers;
 
-	// Queue and thread for loading sound files in the background.
-	map<string, filesystem::path> loadQueue;
-	thread loadThread;
+	// Sound files are read in the background, by the shared worker threads.
+	unique_ptr<TaskQueue> loadQueue;
+	// How many of the sounds that are read at startup have been read so far.
+	size_t soundsToLoad = 0;
+	atomic<size_t> soundsLoaded = 0;
+	atomic<bool> stopLoading = false;
+
+	// The most memory that sounds may use, in bytes, or 0 for no limit. If
+	// there is a limit, sounds with files larger than this size are not read
+	// at startup, but only when they are first played.
+	size_t memoryLimit = 0;
+	const size_t LAZY_FILE_SIZE = 256 * 1024;
+	// If a sound is not loaded when it is requested, it may start playing up
+	// to this many steps later. After that, the request is dropped.
+	const int MAX_PENDING_STEPS = 3;
+	// How often to check how much memory the sounds are using, and how many
+	// steps a sound must go without being played before it can be freed.
+	const int MEMORY_CHECK_STEPS = 60;
+	const int MIN_UNUSED_STEPS = 60 * 60;
+	// Sounds that have been requested, but that are still being loaded, and how
+	// many steps each one has been waiting.
+	map<const Sound *, pair<QueueEntry, int>> pendingSounds;
+	// The last step in which each sound was played.
+	map<const Sound *, int64_t> lastPlayed;
+	int64_t stepCount = 0;
 
 	// The current position of the "listener," i.e. the center of the screen.
 	Point listener;
@@ -149,6 +193,7 @@ void Audio::Init(const vector<filesystem::path> &sources)
 // Get all the sound files in the game data and all plugins.
 void Audio::LoadSounds(const vector<filesystem::path> &sources)
 {
+	map<string, filesystem::path> found;
 	for(const auto &source : sources)
 	{
 		filesystem::path root = source / "sounds";
@@ -162,13 +207,37 @@ void Audio::LoadSounds(const vector<filesystem::path> &sources)
 				string name = (path.parent_path() / path.stem()).lexically_relative(root).generic_string();
 				if(name.ends_with('~'))
 					name.resize(name.length() - 1);
-				loadQueue[name] = path;
+				found[name] = path;
 			}
 		}
 	}
-	// Begin loading the files.
-	if(!loadQueue.empty())
-		loadThread = thread(&Load);
+
+	vector<const Sound *> newSounds;
+	{
+		unique_lock<mutex> lock(audioMutex);
+		for(const auto &[fileName, path] : found)
+		{
+			// @3x sounds should be merged with their regular variant here.
+			string name = fileName;
+			if(name.ends_with("@3x"))
+				name.resize(name.size() - 3);
+
+			Sound &sound = sounds[name];
+			if(!sound.HasFiles())
+				newSounds.push_back(&sound);
+			sound.AddFile(path, name);
+		}
+	}
+
+	// Begin loading the files. If sounds have a memory limit, leave the larger
+	// ones to be loaded once they are needed.
+	memoryLimit = static_cast<size_t>(Preferences::GetSoundMemoryLimit()) * 1024 * 1024;
+	erase_if(newSounds, [](const Sound *sound) { return memoryLimit && sound->FileSize() > LAZY_FILE_SIZE; });
+	if(!loadQueue)
+		loadQueue = make_unique<TaskQueue>();
+	soundsToLoad += newSounds.size();
+	for(const Sound *sound : newSounds)
+		Load(sound, true);
 }
 
 
@@ -191,14 +260,10 @@ void Audio::CheckReferences(bool parseOnly)
 // Report the progress of loading sounds.
 double Audio::GetProgress()
 {
-	unique_lock<mutex> lock(audioMutex);
-
-	if(loadQueue.empty())
+	if(soundsLoaded >= soundsToLoad)
 		return 1.;
 
-	double done = sounds.size();
-	double total = done + loadQueue.size();
-	return done / total;
+	return static_cast<double>(soundsLoaded) / soundsToLoad;
 }
 
 
@@ -242,9 +307,19 @@ void Audio::Update(const Point &listenerPosition)
 
 	listener = listenerPosition;
 
-	for(const auto &it : deferred)
-		soundQueue[it.first].Add(it.second);
-	deferred.clear();
+	// Every request for the same sound is combined into a single entry.
+	Request request;
+	while(requests.Pop(request))
+		soundQueue[request.sound].Add(request.position, request.category);
+
+	if(hasDeferred)
+	{
+		unique_lock<mutex> lock(audioMutex);
+		for(const auto &it : deferred)
+			soundQueue[it.first].Add(it.second);
+		deferred.clear();
+		hasDeferred = false;
+	}
 }
 
 
@@ -261,17 +336,18 @@ void Audio::Play(const Sound *sound, SoundCategory category)
 // "listener". This will make it softer and change the left / right balance.
 void Audio::Play(const Sound *sound, const Point &position, SoundCategory category)
 {
-	if(!isInitialized || !sound || sound->Buffer().empty() || !volume[SoundCategory::MASTER])
+	if(!isInitialized || !sound || !sound->HasFiles() || !volume[SoundCategory::MASTER])
 		return;
 
 	// Place sounds from the main thread directly into the queue. They are from
 	// the UI, and the Engine may not be running right now to call Update().
 	if(this_thread::get_id() == mainThreadID)
 		soundQueue[sound].Add(position - listener, category);
-	else
+	else if(!requests.Push(Request{sound, position - listener, category}))
 	{
 		unique_lock<mutex> lock(audioMutex);
 		deferred[sound].Add(position - listener, category);
+		hasDeferred = true;
 	}
 }
 
@@ -371,6 +447,7 @@ void Audio::Step(bool isFastForward)
 		auto queueIt = soundQueue.find(sound);
 		if(queueIt != soundQueue.end())
 		{
+			lastPlayed[sound] = stepCount;
 			Move(*player, queueIt->second);
 			soundQueue.erase(queueIt);
 			++it;
@@ -391,11 +468,37 @@ void Audio::Step(bool isFastForward)
 
 	erase_if(players, [](const auto &player){ return player->IsFinished(); });
 
+	// Sounds that have finished loading since they were requested can start
+	// playing now, but any that take too long to load are skipped rather than
+	// being played late.
+	for(auto it = pendingSounds.begin(); it != pendingSounds.end(); )
+	{
+		auto &[entry, steps] = it->second;
+		if(it->first->IsLoaded())
+			soundQueue[it->first].Add(entry);
+		else if(++steps <= MAX_PENDING_STEPS)
+		{
+			++it;
+			continue;
+		}
+		it = pendingSounds.erase(it);
+	}
+
 	// Now, what is left in the queue is sounds that want to play, and that do
 	// not correspond to an existing source.
 	for(const auto &[sound, entry] : soundQueue)
 	{
+		if(!sound->IsLoaded())
+		{
+			Load(sound, false);
+			pendingSounds[sound].first.Add(entry);
+			continue;
+		}
 		unique_ptr<AudioSupplier> supplier = sound->CreateSupplier();
+		// Skip any sound whose files could not be read.
+		if(!supplier)
+			continue;
+		lastPlayed[sound] = stepCount;
 		supplier->Set3x(isFastForward);
 		shared_ptr<AudioPlayer> player;
 		if(sound->IsLooping())
@@ -419,6 +522,9 @@ void Audio::Step(bool isFastForward)
 
 	if(musicPlayer && musicPlayer->IsFinished())
 		musicPlayer.reset();
+
+	if(memoryLimit && !(++stepCount % MEMORY_CHECK_STEPS))
+		FreeUnusedSounds();
 }
 
 
@@ -426,22 +532,22 @@ void Audio::Step(bool isFastForward)
 // Shut down the audio system (because we're about to quit).
 void Audio::Quit()
 {
-	// First, check if sounds are still being loaded in a separate thread, and
-	// if so interrupt that thread and wait for it to quit.
-	unique_lock<mutex> lock(audioMutex);
-	if(!loadQueue.empty())
-		loadQueue.clear();
-	if(loadThread.joinable())
+	// First, check if sounds are still being loaded in the background, and if
+	// so skip the rest of them and wait for the ones in progress to finish.
+	stopLoading = true;
+	if(loadQueue)
 	{
-		lock.unlock();
-		loadThread.join();
-		lock.lock();
+		loadQueue->Wait();
+		loadQueue.reset();
 	}
+	unique_lock<mutex> lock(audioMutex);
 
 	// Now, stop and delete any OpenAL sources that are playing.
 	players.clear();
 	loopingPlayers.clear();
 	musicPlayer.reset();
+	pendingSounds.clear();
+	lastPlayed.clear();
 
 	// Free the memory buffers for all the sound resources.
 	sounds.clear();
@@ -482,39 +588,53 @@ namespace {
 		category = other.category;
 	}
 
-	// Thread entry point for loading sounds.
-	void Load()
+	// Read a sound's files on one of the worker threads.
+	void Load(const Sound *sound, bool isStartup)
+	{
+		// Every sound belongs to the sounds map, so it is safe to modify it.
+		Sound *target = const_cast<Sound *>(sound);
+		if(!target->StartLoading())
+			return;
+
+		loadQueue->Run([target, isStartup]
+		{
+			if(!stopLoading)
+				target->Load();
+			if(isStartup)
+				++soundsLoaded;
+		});
+	}
+
+
+
+	// Free the sounds that have gone the longest without being played, until
+	// they are using no more memory than they are allowed to.
+	void FreeUnusedSounds()
 	{
-		string name;
-		filesystem::path path;
-		Sound *sound;
-		while(true)
+		size_t total = 0;
+		vector<pair<int64_t, Sound *>> loaded;
 		{
-			{
-				unique_lock<mutex> lock(audioMutex);
-				// If this is not the first time through, remove the previous item
-				// in the queue. This is a signal that it has been loaded, so we
-				// must not remove it until after loading the file.
-				if(!path.empty() && !loadQueue.empty())
-					loadQueue.erase(loadQueue.begin());
-				if(loadQueue.empty())
-					return;
-				name = loadQueue.begin()->first;
-				path = loadQueue.begin()->second;
-
-				// @3x sounds should be merged with their regular variant here.
-				if(name.ends_with("@3x"))
-					name.resize(name.size() - 3);
-
-				// Since we need to unlock the mutex below, create the map entry to
-				// avoid a race condition when accessing sounds' size.
-				sound = &sounds[name];
-			}
+			unique_lock<mutex> lock(audioMutex);
+			for(auto &it : sounds)
+				if(it.second.IsLoaded())
+				{
+					total += it.second.MemoryUsage();
+					auto lastIt = lastPlayed.find(&it.second);
+					loaded.emplace_back(lastIt == lastPlayed.end() ? 0 : lastIt->second, &it.second);
+				}
+		}
+		if(total <= memoryLimit)
+			return;
 
-			// Unlock the mutex for the time-intensive part of the loop.
-			if(!sound->Load(path, name))
-				Logger::Log("Unable to load sound \"" + name + "\" from path: " + path.string(),
-					Logger::Level::WARNING);
+		sort(loaded.begin(), loaded.end());
+		for(const auto &[last, sound] : loaded)
+		{
+			// Never free a sound that has been played recently, since it is
+			// likely to be played again soon.
+			if(total <= memoryLimit || stepCount - last < MIN_UNUSED_STEPS)
+				break;
+			total -= sound->MemoryUsage();
+			sound->Unload();
 		}
 	}
 }
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "supplier/WavSupplier.h"
 
 #include <cstdint>
+#include <system_error>
 
 using namespace std;
 
@@ -30,64 +31,111 @@ namespace {
 	uint32_t ReadHeader(shared_ptr<iostream> &in, uint32_t frequency);
 	uint32_t Read4(const shared_ptr<iostream> &in);
 	uint16_t Read2(const shared_ptr<iostream> &in);
+
+	// Read the samples from a WAV file. Returns null if it cannot be read.
+	shared_ptr<const Sound::Samples> Read(const filesystem::path &path, const string &name);
 }
 
 
 
-bool Sound::Load(const filesystem::path &path, const string &name)
+void Sound::AddFile(const filesystem::path &path, const string &name)
 {
-	if(path.extension() != ".wav")
-		return false;
 	this->name = name;
 
 	isLooped = path.stem().string().ends_with('~');
 	bool isFast = isLooped ? path.stem().string().ends_with("@3x~") : path.stem().string().ends_with("@3x");
-	vector<AudioSupplier::sample_t> &buf = isFast ? buffer3x : buffer;
+	(isFast ? path3x : this->path) = path;
+}
+
+
+
+bool Sound::HasFiles() const
+{
+	return !path.empty() || !path3x.empty();
+}
+
+
+
+size_t Sound::FileSize() const
+{
+	size_t size = 0;
+	error_code error;
+	for(const filesystem::path &file : {path, path3x})
+		if(!file.empty())
+		{
+			uintmax_t fileSize = filesystem::file_size(file, error);
+			if(!error)
+				size += fileSize;
+		}
+	return size;
+}
+
+
+
+bool Sound::StartLoading()
+{
+	State expected = State::UNLOADED;
+	return state.compare_exchange_strong(expected, State::LOADING);
+}
+
 
-	shared_ptr<iostream> in = Files::Open(path);
-	if(!in)
-		return false;
-	uint32_t bytes = ReadHeader(in, AudioSupplier::SAMPLE_RATE);
-	if(!bytes)
-	{
-		Logger::Log("WAV file uses an unsupported format. Only 44100Hz little-endian 16-bit PCM is supported.",
-			Logger::Level::WARNING);
-		return false;
-	}
 
-	// Read 16-bit mono from the file.
-	vector<char> data(bytes);
-	in->read(data.data(), bytes);
+bool Sound::Load()
+{
+	shared_ptr<const Samples> samples;
+	shared_ptr<const Samples> samples3x;
+	if(!path.empty())
+		samples = Read(path, name);
+	if(!path3x.empty())
+		samples3x = Read(path3x, name);
+	bool success = (path.empty() || samples) && (path3x.empty() || samples3x);
 
-	// Store 16-bit stereo buffer.
-	buf.resize(2 * data.size() / sizeof(AudioSupplier::sample_t));
-	for(size_t i = 0; i < buf.size() / 2; ++i)
 	{
-		buf[2 * i] = reinterpret_cast<AudioSupplier::sample_t *>(data.data())[i];
-		buf[2 * i + 1] = reinterpret_cast<AudioSupplier::sample_t *>(data.data())[i];
+		lock_guard<mutex> lock(samplesMutex);
+		buffer = std::move(samples);
+		buffer3x = std::move(samples3x);
 	}
-	return true;
+	state = State::LOADED;
+	return success;
 }
 
 
 
-const string &Sound::Name() const
+void Sound::Unload()
 {
-	return name;
+	State expected = State::LOADED;
+	if(!state.compare_exchange_strong(expected, State::UNLOADED))
+		return;
+
+	lock_guard<mutex> lock(samplesMutex);
+	buffer.reset();
+	buffer3x.reset();
 }
 
 
 
-const vector<AudioSupplier::sample_t> &Sound::Buffer() const
+bool Sound::IsLoaded() const
 {
-	return buffer.empty() ? buffer3x : buffer;
+	return state == State::LOADED;
 }
 
 
 
-const vector<AudioSupplier::sample_t> &Sound::Buffer3x() const
+size_t Sound::MemoryUsage() const
 {
-	return buffer3x.empty() ? buffer : buffer3x;
+	lock_guard<mutex> lock(samplesMutex);
+	size_t size = 0;
+	for(const shared_ptr<const Samples> &samples : {buffer, buffer3x})
+		if(samples)
+			size += samples->size() * sizeof(AudioSupplier::sample_t);
+	return size;
+}
+
+
+
+const string &Sound::Name() const
+{
+	return name;
 }
 
 
@@ -101,7 +149,13 @@ bool Sound::IsLooping() const
 
 unique_ptr<AudioSupplier> Sound::CreateSupplier() const
 {
-	return unique_ptr<AudioSupplier>{new WavSupplier{*this, false, IsLooping()}};
+	lock_guard<mutex> lock(samplesMutex);
+	// If there is only a regular or only a fast-forward variant, use it for both.
+	const shared_ptr<const Samples> &regular = buffer ? buffer : buffer3x;
+	const shared_ptr<const Samples> &fast = buffer3x ? buffer3x : buffer;
+	if(!regular)
+		return nullptr;
+	return unique_ptr<AudioSupplier>{new WavSupplier{regular, fast, false, IsLooping()}};
 }
 
 
@@ -196,4 +250,33 @@ namespace {
 			result |= static_cast<uint16_t>(data[i]) << (i * 8);
 		return result;
 	}
+
+
+
+	shared_ptr<const Sound::Samples> Read(const filesystem::path &path, const string &name)
+	{
+		shared_ptr<iostream> in = Files::Open(path);
+		uint32_t bytes = in ? ReadHeader(in, AudioSupplier::SAMPLE_RATE) : 0;
+		if(!bytes)
+		{
+			if(in)
+				Logger::Log("WAV file uses an unsupported format. Only 44100Hz little-endian 16-bit PCM is supported.",
+					Logger::Level::WARNING);
+			Logger::Log("Unable to load sound \"" + name + "\" from path: " + path.string(), Logger::Level::WARNING);
+			return nullptr;
+		}
+
+		// Read 16-bit mono from the file.
+		vector<char> data(bytes);
+		in->read(data.data(), bytes);
+
+		// Store 16-bit stereo buffer.
+		auto buf = make_shared<Sound::Samples>(2 * data.size() / sizeof(AudioSupplier::sample_t));
+		for(size_t i = 0; i < buf->size() / 2; ++i)
+		{
+			(*buf)[2 * i] = reinterpret_cast<AudioSupplier::sample_t *>(data.data())[i];
+			(*buf)[2 * i + 1] = reinterpret_cast<AudioSupplier::sample_t *>(data.data())[i];
+		}
+		return buf;
+	}
 }
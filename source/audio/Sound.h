@@ -17,30 +17,68 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "supplier/AudioSupplier.h"
 
+#include <atomic>
+#include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 
 
 // This is a sound that can be played. The sound's file name will determine
-// whether it is looping (ends in '~') or not.
+// whether it is looping (ends in '~') or not. A sound remembers where its files
+// are, so that its samples can be read whenever they are needed, and freed
+// again if it has not been played for a while.
 class Sound {
 public:
-	bool Load(const std::filesystem::path &path, const std::string &name);
+	using Samples = std::vector<AudioSupplier::sample_t>;
 
-	const std::string &Name() const;
 
-	const std::vector<AudioSupplier::sample_t> &Buffer() const;
-	const std::vector<AudioSupplier::sample_t> &Buffer3x() const;
+public:
+	// Remember which file holds this sound, or its fast-forward (@3x) variant.
+	void AddFile(const std::filesystem::path &path, const std::string &name);
+	// Check whether this sound has any files.
+	bool HasFiles() const;
+	// The total size of this sound's files, in bytes.
+	size_t FileSize() const;
+
+	// Mark this sound as being loaded. Returns false if it is already loaded,
+	// or is already being loaded by another thread.
+	bool StartLoading();
+	// Read the samples from this sound's files. This can be done on any thread,
+	// once StartLoading() has returned true. Returns false if a file could not be read.
+	bool Load();
+	// Free this sound's samples, unless it is being loaded. They will need to
+	// be loaded again before the sound can be played.
+	void Unload();
+	bool IsLoaded() const;
+	// How much memory this sound's samples take up, in bytes.
+	size_t MemoryUsage() const;
+
+	const std::string &Name() const;
 	bool IsLooping() const;
 
+	// Create a supplier for this sound. It keeps its own reference to the
+	// samples, so they remain valid even if this sound is unloaded. Returns
+	// null if the sound is not loaded, or its files could not be read.
 	std::unique_ptr<AudioSupplier> CreateSupplier() const;
 
 
+private:
+	enum class State : int {UNLOADED, LOADING, LOADED};
+
+
 private:
 	std::string name;
-	std::vector<AudioSupplier::sample_t> buffer;
-	std::vector<AudioSupplier::sample_t> buffer3x;
+	std::filesystem::path path;
+	std::filesystem::path path3x;
 	bool isLooped = false;
+
+	std::atomic<State> state = State::UNLOADED;
+	// The samples are swapped in and out by the loading threads, so guard them.
+	mutable std::mutex samplesMutex;
+	std::shared_ptr<const Samples> buffer;
+	std::shared_ptr<const Samples> buffer3x;
 };
@@ -15,38 +15,155 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AsyncAudioSupplier.h"
 
-#include <cmath>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
 
 
-AsyncAudioSupplier::AsyncAudioSupplier(shared_ptr<iostream> data, bool looping)
-	: looping(looping), data(std::move(data))
+// The threads that decode the data of every supplier. Each supplier is queued
+// up whenever its buffer has space, and a thread then decodes until the buffer
+// is full again, so only as many threads are needed as there are streams that
+// may be playing at once.
+class AsyncAudioSupplier::Decoders {
+public:
+	static Decoders &Instance();
+
+	~Decoders();
+
+	// Queue the given supplier to be decoded.
+	void Add(AsyncAudioSupplier *supplier);
+	// Remove the given supplier from the queue, and wait until no thread is decoding it.
+	void Remove(AsyncAudioSupplier *supplier);
+
+
+private:
+	void Loop() noexcept;
+
+
+private:
+	// A music track and the one it is fading into may be playing at the same time.
+	static constexpr size_t THREAD_COUNT = 2;
+
+	mutex decoderMutex;
+	condition_variable decoderCondition;
+	deque<AsyncAudioSupplier *> queue;
+	vector<AsyncAudioSupplier *> running;
+	vector<thread> threads;
+	bool shouldQuit = false;
+};
+
+
+
+AsyncAudioSupplier::Decoders &AsyncAudioSupplier::Decoders::Instance()
 {
+	static Decoders decoders;
+	return decoders;
 }
 
 
 
-AsyncAudioSupplier::~AsyncAudioSupplier()
+AsyncAudioSupplier::Decoders::~Decoders()
 {
-	// Tell the decoding thread to stop.
 	{
-		lock_guard<mutex> lock(bufferMutex);
-		done = true;
+		lock_guard<mutex> lock(decoderMutex);
+		shouldQuit = true;
 	}
-	bufferCondition.notify_all();
-	if(audioThread.joinable())
-		audioThread.join();
+	decoderCondition.notify_all();
+	for(thread &it : threads)
+		it.join();
+}
+
+
+
+void AsyncAudioSupplier::Decoders::Add(AsyncAudioSupplier *supplier)
+{
+	{
+		lock_guard<mutex> lock(decoderMutex);
+		// The threads are only started once there is something for them to do.
+		if(threads.empty())
+			for(size_t i = 0; i < THREAD_COUNT; ++i)
+				threads.emplace_back(&Decoders::Loop, this);
+		queue.push_back(supplier);
+	}
+	decoderCondition.notify_one();
+}
+
+
+
+void AsyncAudioSupplier::Decoders::Remove(AsyncAudioSupplier *supplier)
+{
+	unique_lock<mutex> lock(decoderMutex);
+	while(true)
+	{
+		erase(queue, supplier);
+		if(find(running.begin(), running.end(), supplier) == running.end())
+			break;
+		decoderCondition.wait(lock);
+	}
+}
+
+
+
+void AsyncAudioSupplier::Decoders::Loop() noexcept
+{
+	unique_lock<mutex> lock(decoderMutex);
+	while(true)
+	{
+		decoderCondition.wait(lock, [this] { return shouldQuit || !queue.empty(); });
+		if(shouldQuit)
+			return;
+
+		AsyncAudioSupplier *supplier = queue.front();
+		queue.pop_front();
+		running.push_back(supplier);
+		lock.unlock();
+
+		supplier->Decode();
+		// If the buffer was read from while this thread was finishing up, it
+		// may have more space already.
+		supplier->isScheduled = false;
+		bool again = !supplier->finished && !supplier->BufferSpace().empty()
+			&& !supplier->isScheduled.exchange(true);
+
+		lock.lock();
+		// The supplier may have been scheduled again as soon as it was marked as
+		// not scheduled, in which case another thread may already be running it
+		// too. Only remove this thread's entry, so that it is still waited for.
+		running.erase(find(running.begin(), running.end(), supplier));
+		if(again)
+			queue.push_back(supplier);
+		// Wake up anything waiting to remove this supplier.
+		decoderCondition.notify_all();
+	}
+}
+
+
+
+
+AsyncAudioSupplier::AsyncAudioSupplier(shared_ptr<iostream> data, bool looping)
+	: looping(looping), data(std::move(data)), buffer(BUFFER_CHUNK_SIZE * OUTPUT_CHUNK)
+{
+}
+
+
+
+AsyncAudioSupplier::~AsyncAudioSupplier()
+{
+	StopDecoding();
 }
 
 
 
 size_t AsyncAudioSupplier::MaxChunks() const
 {
-	if(done && buffer.size() < OUTPUT_CHUNK)
+	if(finished && buffer.Size() < OUTPUT_CHUNK)
 		return 0;
 
 	return max(static_cast<size_t>(2), AvailableChunks());
@@ -56,61 +173,117 @@ size_t AsyncAudioSupplier::MaxChunks() const
 
 size_t AsyncAudioSupplier::AvailableChunks() const
 {
-	return buffer.size() / OUTPUT_CHUNK;
+	return buffer.Size() / OUTPUT_CHUNK;
 }
 
 
-vector<AudioSupplier::sample_t> AsyncAudioSupplier::NextDataChunk()
+
+void AsyncAudioSupplier::NextDataChunk(vector<sample_t> &chunk)
 {
-	if(AvailableChunks())
-	{
-		lock_guard<mutex> lock(bufferMutex);
+	span<const sample_t> samples = PeekChunk(chunk);
+	if(samples.data() != chunk.data())
+		copy(samples.begin(), samples.end(), chunk.begin());
+	ReleaseChunk();
+}
+
 
-		vector<sample_t> temp{buffer.begin(), buffer.begin() + OUTPUT_CHUNK};
-		buffer.erase(buffer.begin(), buffer.begin() + OUTPUT_CHUNK);
-		bufferCondition.notify_all();
-		return temp;
+
+// Hands out each chunk in place in the output buffer.
+span<const AudioSupplier::sample_t> AsyncAudioSupplier::PeekChunk(vector<sample_t> &chunk)
+{
+	if(!AvailableChunks())
+	{
+		fill(chunk.begin(), chunk.end(), 0);
+		return chunk;
 	}
-	else
-		return vector<sample_t>(OUTPUT_CHUNK);
+	isPeeked = true;
+	return buffer.ReadView().first(OUTPUT_CHUNK);
 }
 
 
 
-void AsyncAudioSupplier::StartAudioThread()
+void AsyncAudioSupplier::ReleaseChunk()
 {
-	audioThread = thread(&AsyncAudioSupplier::Decode, this);
+	if(!isPeeked)
+		return;
+	isPeeked = false;
+	buffer.Consume(OUTPUT_CHUNK);
+	// There is now space to decode more data into.
+	if(!finished && !isScheduled.exchange(true))
+		Decoders::Instance().Add(this);
 }
 
 
 
-void AsyncAudioSupplier::AwaitBufferSpace()
+void AsyncAudioSupplier::StartDecoding()
 {
-	unique_lock<mutex> lock(bufferMutex);
-	while(!done && buffer.size() > (BUFFER_CHUNK_SIZE - 1) * OUTPUT_CHUNK)
-		bufferCondition.wait(lock);
+	isScheduled = true;
+	Decoders::Instance().Add(this);
 }
 
 
 
-void AsyncAudioSupplier::AddBufferData(vector<sample_t> &samples)
+void AsyncAudioSupplier::StopDecoding()
 {
-	lock_guard<mutex> lock(bufferMutex);
-	buffer.insert(buffer.end(), samples.begin(), samples.end());
-	samples.clear();
-	if(done)
-		PadBuffer();
+	done = true;
+	// Make sure that this supplier is never queued up again.
+	isScheduled = true;
+	Decoders::Instance().Remove(this);
 }
 
 
 
-void AsyncAudioSupplier::PadBuffer()
+span<AudioSupplier::sample_t> AsyncAudioSupplier::BufferSpace()
 {
-	buffer.resize(OUTPUT_CHUNK * ceil(static_cast<double>(buffer.size()) / static_cast<double>(OUTPUT_CHUNK)));
+	if(finished)
+		return {};
+	return buffer.WriteView();
 }
 
 
 
+void AsyncAudioSupplier::CommitSamples(size_t count)
+{
+	buffer.Commit(count);
+}
+
+
+
+size_t AsyncAudioSupplier::AddBufferData(const sample_t *samples, size_t count)
+{
+	size_t added = 0;
+	while(added < count)
+	{
+		span<sample_t> space = BufferSpace();
+		if(space.empty())
+			break;
+		size_t size = min(space.size(), count - added);
+		copy_n(samples + added, size, space.begin());
+		CommitSamples(size);
+		added += size;
+	}
+	return added;
+}
+
+
+
+void AsyncAudioSupplier::FinishBuffer()
+{
+	// Chunks are only ever read whole, so the partial chunk at the end of the buffer
+	// is always followed by enough space to complete it.
+	size_t padding = (OUTPUT_CHUNK - buffer.Size() % OUTPUT_CHUNK) % OUTPUT_CHUNK;
+	while(padding)
+	{
+		span<sample_t> space = buffer.WriteView();
+		size_t size = min(space.size(), padding);
+		fill_n(space.begin(), size, 0);
+		buffer.Commit(size);
+		padding -= size;
+	}
+	finished = true;
+}
+
+
 
 size_t AsyncAudioSupplier::ReadInput(char *output, size_t bytesToRead)
 {
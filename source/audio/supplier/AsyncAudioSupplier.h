@@ -17,14 +17,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AudioSupplier.h"
 
-#include <condition_variable>
+#include "../../SpscRingBuffer.h"
+
+#include <atomic>
 #include <iostream>
 #include <memory>
-#include <thread>
+#include <span>
 
 
 
 /// Generic implementation for async suppliers that stream data decoded on another thread.
+/// Rather than each supplier having a thread of its own, all of them share a few
+/// decoder threads, which decode each supplier's data whenever there is space for it.
 class AsyncAudioSupplier : public AudioSupplier {
 public:
 	explicit AsyncAudioSupplier(std::shared_ptr<std::iostream> data, bool looping = false);
@@ -33,20 +37,32 @@ public:
 	// Inherited pure virtual methods
 	size_t MaxChunks() const override;
 	size_t AvailableChunks() const override;
-	std::vector<sample_t> NextDataChunk() override;
+	void NextDataChunk(std::vector<sample_t> &chunk) override;
+	/// Hands out each chunk in place in the output buffer.
+	std::span<const sample_t> PeekChunk(std::vector<sample_t> &chunk) override;
+	void ReleaseChunk() override;
 
 
 protected:
-	void StartAudioThread();
-	/// This is the entry point for the decoding thread.
+	/// Have the decoder threads start filling the output buffer.
+	void StartDecoding();
+	/// Stop decoding, waiting for any decoder thread that is working on this supplier.
+	/// Suppliers whose decoder state is destroyed before this class must call this in their destructor.
+	void StopDecoding();
+	/// Decode as much data as the output buffer has space for. This is called on one of the decoder
+	/// threads, and never on more than one at once. Once all the input has been decoded, call FinishBuffer().
 	virtual void Decode() = 0;
 
-	void AwaitBufferSpace();
-	/// Adds data to the output buffer, then clears the given sample vector.
-	/// If the supplier is done, pads the output buffer to a full chunk with silence.
-	void AddBufferData(std::vector<sample_t> &samples);
-	/// Pads the buffer to a full output chunk with silence.
-	void PadBuffer();
+	/// Gets the space at the end of the output buffer that decoded samples can be written into directly.
+	/// If the buffer is full, this is empty.
+	std::span<sample_t> BufferSpace();
+	/// Adds the given number of samples from the start of the buffer space to the output.
+	void CommitSamples(size_t count);
+	/// Copies as many of the given samples into the output buffer as there is space for.
+	/// Returns the number of samples that were added.
+	size_t AddBufferData(const sample_t *samples, size_t count);
+	/// Pads the buffer to a full output chunk with silence. No more samples can be added after this.
+	void FinishBuffer();
 
 	/// Reads file input. Returns the number of bytes read.
 	/// The returned byte count is only less than the requested number if the end of the input was reached.
@@ -55,20 +71,28 @@ protected:
 
 
 protected:
-	bool done = false;
+	/// Whether there is no more input to decode, or the supplier is being destroyed.
+	std::atomic<bool> done = false;
 	const bool looping;
 
 	std::shared_ptr<std::iostream> data;
 
 
+private:
+	/// The threads that decode the data of every supplier.
+	class Decoders;
+
+
 private:
 	/// The number of chunks to queue up in the buffer.
 	static constexpr size_t BUFFER_CHUNK_SIZE = 3;
-	/// The decoded data.
-	std::vector<sample_t> buffer;
-
-	// Sync management
-	std::thread audioThread;
-	std::mutex bufferMutex;
-	std::condition_variable bufferCondition;
+	/// The decoded data. Because it only ever gives out whole chunks, and holds a whole number
+	/// of them, each chunk is stored in one piece.
+	SpscRingBuffer<sample_t> buffer;
+	/// Whether all of the decoded data has been added to the buffer.
+	std::atomic<bool> finished = false;
+	/// Whether this supplier is waiting for a decoder thread, or being decoded by one.
+	std::atomic<bool> isScheduled = false;
+	/// Whether a chunk has been handed out by PeekChunk() that has not been released yet.
+	bool isPeeked = false;
 };
@@ -49,21 +49,39 @@ void AudioSupplier::Set3x(bool is3x)
 
 
 
+// Gets the next chunk of audio samples. By default, they are written into the given chunk.
+span<const AudioSupplier::sample_t> AudioSupplier::PeekChunk(vector<sample_t> &chunk)
+{
+	NextDataChunk(chunk);
+	return chunk;
+}
+
+
+
+void AudioSupplier::ReleaseChunk()
+{
+}
+
+
+
 void AudioSupplier::NextChunk(ALuint buffer, bool spatial)
 {
 	if(AvailableChunks())
 	{
-		vector<sample_t> samples = NextDataChunk();
+		chunk.resize(OUTPUT_CHUNK);
+		span<const sample_t> samples = PeekChunk(chunk);
 		// Spatial audio is mono, but we get stereo data by default.
 		// (This difference is due to a limitation in OpenAL.)
 		if(spatial)
 		{
-			for(size_t i = 0; i < samples.size() / 2; ++i)
-				samples[i] = (static_cast<int>(samples[2 * i]) + static_cast<int>(samples[2 * i + 1])) / 2;
-			samples.resize(samples.size() / 2);
+			size_t size = samples.size() / 2;
+			for(size_t i = 0; i < size; ++i)
+				chunk[i] = (static_cast<int>(samples[2 * i]) + static_cast<int>(samples[2 * i + 1])) / 2;
+			alBufferData(buffer, FORMAT_SPATIAL, chunk.data(), sizeof(sample_t) * size, SAMPLE_RATE);
 		}
-		alBufferData(buffer, spatial ? FORMAT_SPATIAL : FORMAT, samples.data(),
-			sizeof(sample_t) * samples.size(), SAMPLE_RATE);
+		else
+			alBufferData(buffer, FORMAT, samples.data(), sizeof(sample_t) * samples.size(), SAMPLE_RATE);
+		ReleaseChunk();
 	}
 	else
 		SetSilence(buffer, OUTPUT_CHUNK);
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 
@@ -45,9 +46,16 @@ public:
 	virtual size_t MaxChunks() const = 0;
 	/// The number of chunks currently ready for access via NextChunk().
 	virtual size_t AvailableChunks() const = 0;
-	/// Gets the next, fixed-size chunk of audio samples. If there is no available chunk, a silence chunk is returned.
-	/// This returns the raw samples that would be put into an OpenAL buffer via a NextChunk() call.
-	virtual std::vector<sample_t> NextDataChunk() = 0;
+	/// Fills the given chunk, which must hold OUTPUT_CHUNK samples, with the next chunk of audio samples.
+	/// If there is no available chunk, it is filled with silence.
+	/// These are the raw samples that would be put into an OpenAL buffer via a NextChunk() call.
+	virtual void NextDataChunk(std::vector<sample_t> &chunk) = 0;
+	/// Gets the next chunk of audio samples without copying them, if the supplier already holds them in one piece.
+	/// Otherwise, the chunk is written into the given one, which must hold OUTPUT_CHUNK samples, like NextDataChunk().
+	/// The samples are only valid until ReleaseChunk() is called, which must be done once they have been used.
+	virtual std::span<const sample_t> PeekChunk(std::vector<sample_t> &chunk);
+	/// Removes the chunk given by the last PeekChunk() call from the supplier's queue.
+	virtual void ReleaseChunk();
 
 	/// Configures 3x audio playback.
 	virtual void Set3x(bool is3x);
@@ -86,4 +94,9 @@ protected:
 
 	/// The index of the first sample to be processed
 	size_t currentSample = 0;
+
+
+private:
+	/// The samples for NextChunk(), which are kept so that they do not need to be reallocated for every chunk.
+	std::vector<sample_t> chunk;
 };
@@ -17,6 +17,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../../Logger.h"
 
+#include <algorithm>
+#include <span>
 #include <utility>
 
 using namespace std;
@@ -26,7 +28,15 @@ using namespace std;
 FlacSupplier::FlacSupplier(shared_ptr<iostream> data, bool looping)
 	: AsyncAudioSupplier(std::move(data), looping)
 {
-	StartAudioThread();
+	init();
+	StartDecoding();
+}
+
+
+
+FlacSupplier::~FlacSupplier()
+{
+	StopDecoding();
 }
 
 
@@ -36,13 +46,22 @@ FLAC__StreamDecoderWriteStatus FlacSupplier::write_callback(const FLAC__Frame *f
 	const size_t channels = frame->header.channels;
 	const size_t blocksize = frame->header.blocksize;
 
-	AwaitBufferSpace();
-	static vector<sample_t> samples;
-	for(size_t i = 0; i < blocksize; ++i)
-		for(size_t ch = 0; ch < channels; ++ch)
-			samples.push_back(static_cast<sample_t>(buffer[ch][i]));
+	// Write the samples straight into the output buffer, and keep any that do not fit for later.
+	const size_t total = blocksize * channels;
+	size_t i = 0;
+	while(i < total)
+	{
+		span<sample_t> space = BufferSpace();
+		if(space.empty())
+			break;
+		size_t count = min(space.size(), total - i);
+		for(size_t j = 0; j < count; ++j, ++i)
+			space[j] = static_cast<sample_t>(buffer[i % channels][i / channels]);
+		CommitSamples(count);
+	}
+	for( ; i < total; ++i)
+		pending.push_back(static_cast<sample_t>(buffer[i % channels][i / channels]));
 
-	AddBufferData(samples);
 	/// Allow looping back to the beginning of the file on the next read.
 	return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
@@ -78,7 +97,6 @@ void FlacSupplier::error_callback(FLAC__StreamDecoderErrorStatus status)
 {
 	Logger::Log("FLAC error " + string(FLAC__StreamDecoderErrorStatusString[status]), Logger::Level::WARNING);
 	done = true;
-	PadBuffer();
 }
 
 
@@ -126,11 +144,33 @@ bool FlacSupplier::eof_callback()
 
 void FlacSupplier::Decode()
 {
-	init();
-	do {
-		lastReadWasEof = false;
-		process_until_end_of_stream();
-		reset();
-	} while(!done && lastReadWasEof);
-	finish();
+	// Only decode another frame once everything from the last one has been written.
+	while(WritePending())
+	{
+		// A looping file starts over once the decoder reaches its end.
+		const FLAC__StreamDecoderState state = get_state();
+		if(state == FLAC__STREAM_DECODER_END_OF_STREAM && lastReadWasEof && !done)
+		{
+			reset();
+			lastReadWasEof = false;
+		}
+		else if(state >= FLAC__STREAM_DECODER_END_OF_STREAM || !process_single())
+		{
+			FinishBuffer();
+			break;
+		}
+	}
+}
+
+
+
+bool FlacSupplier::WritePending()
+{
+	pendingWritten += AddBufferData(pending.data() + pendingWritten, pending.size() - pendingWritten);
+	if(pendingWritten < pending.size())
+		return false;
+
+	pending.clear();
+	pendingWritten = 0;
+	return true;
 }
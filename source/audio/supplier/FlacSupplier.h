@@ -19,6 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <FLAC++/decoder.h>
 
+#include <vector>
+
 
 
 /// Streams audio from a FLAC file.
@@ -27,6 +29,7 @@ class FlacSupplier : protected FLAC::Decoder::Stream, public AsyncAudioSupplier
 // otherwise the FLAC::Decoder::Stream may free the resources with the decoder thread running.
 public:
 	explicit FlacSupplier(std::shared_ptr<std::iostream> data, bool looping = false);
+	~FlacSupplier() override;
 
 
 private:
@@ -45,11 +48,18 @@ private:
 	FLAC__StreamDecoderLengthStatus length_callback(FLAC__uint64 *stream_length) override;
 	bool eof_callback() override;
 
-	/// This is the entry point for the decoding thread.
+	/// Decodes frames into the output buffer until it is full.
 	void Decode() override;
 
+	/// Writes as many of the samples left over from the last frame into the output buffer as there is space for.
+	/// Returns false if the buffer filled up before all of them were written.
+	bool WritePending();
+
 
 private:
 	/// If the last read reached the end of the file, we may have to loop back by resetting the decoder.
 	bool lastReadWasEof = false;
+	/// The samples of the last frame that did not fit in the output buffer, and how many of them have since been written.
+	std::vector<sample_t> pending;
+	size_t pendingWritten = 0;
 };
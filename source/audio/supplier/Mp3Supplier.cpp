@@ -15,11 +15,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Mp3Supplier.h"
 
-#include <mad.h>
-
-#include <array>
-#include <cmath>
+#include <algorithm>
 #include <cstring>
+#include <span>
 #include <utility>
 
 using namespace std;
@@ -29,39 +27,97 @@ using namespace std;
 Mp3Supplier::Mp3Supplier(shared_ptr<iostream> data, bool looping)
 	: AsyncAudioSupplier(std::move(data), looping)
 {
-	StartAudioThread();
+	// Initialize the decoder.
+	mad_stream_init(&stream);
+	mad_frame_init(&frame);
+	mad_synth_init(&synth);
+
+	StartDecoding();
+}
+
+
+
+Mp3Supplier::~Mp3Supplier()
+{
+	// The decoder must not be running when its objects are cleaned up.
+	StopDecoding();
+
+	mad_synth_finish(&synth);
+	mad_frame_finish(&frame);
+	mad_stream_finish(&stream);
 }
 
 
 
 void Mp3Supplier::Decode()
 {
-	// This vector will store the input from the file.
-	array<unsigned char, INPUT_CHUNK> input{};
-	vector<sample_t> samples;
-	// Objects for MP3 decoding:
-	mad_stream stream;
-	mad_frame frame;
-	mad_synth synth;
+	// Finish writing out each frame before decoding the next one, and stop once
+	// the buffer is full. The rest of the frame is written out next time.
+	while(WriteFrame())
+		if(!DecodeFrame())
+		{
+			FinishBuffer();
+			break;
+		}
+}
 
-	// Initialize the decoder.
-	mad_stream_init(&stream);
-	mad_frame_init(&frame);
-	mad_synth_init(&synth);
 
-	// Loop until we are done.
+
+bool Mp3Supplier::WriteFrame()
+{
+	// If the source is mono, read both output channels from the left input.
+	// Otherwise, read two separate input channels.
+	const bool stereo = synth.pcm.channels > 1;
+	const unsigned total = 2 * synth.pcm.length;
+	while(written < total)
+	{
+		// Convert the decoded audio straight into the output buffer.
+		span<sample_t> space = BufferSpace();
+		if(space.empty())
+			return false;
+
+		size_t count = min<size_t>(space.size(), total - written);
+		for(size_t i = 0; i < count; ++i, ++written)
+		{
+			// We alternate what channel we read from for each sample.
+			mad_fixed_t sample = synth.pcm.samples[stereo && (written & 1)][written / 2];
+
+			// Clip and scale the sample to 16 bits.
+			sample += (1L << (MAD_F_FRACBITS - 16));
+			sample = max(-MAD_F_ONE, min(MAD_F_ONE - 1, sample));
+			space[i] = sample >> (MAD_F_FRACBITS + 1 - 16);
+		}
+		CommitSamples(count);
+	}
+	return true;
+}
+
+
+
+bool Mp3Supplier::DecodeFrame()
+{
+	// Whether the last read came up empty. When a looping file reaches its end,
+	// the next read starts over from the beginning, but if that is empty too,
+	// nothing more can be decoded.
+	bool wasEmpty = false;
 	while(true)
 	{
-		// If the "next" buffer has filled up, wait until it is retrieved.
-		// Generally try to queue up two chunks worth of samples in it, just
-		// in case NextChunk() gets called twice in rapid succession.
-		AwaitBufferSpace();
-		// Check if we're done.
-		if(done)
+		// Decode the next frame of the current input block, if there is one.
+		if(stream.buffer)
 		{
-			PadBuffer();
-			break;
+			if(!mad_frame_decode(&frame, &stream))
+			{
+				// Convert the decoded audio into a PCM signal.
+				mad_synth_frame(&synth, &frame);
+				written = 0;
+				return true;
+			}
+			// For recoverable errors, keep going. Otherwise, this block is used up.
+			if(MAD_RECOVERABLE(stream.error))
+				continue;
 		}
+		if(done)
+			return false;
 
 		// See if any input data is left undecoded in the stream. Typically
 		// this is because the last block of input contained a fraction of a
@@ -70,66 +126,24 @@ void Mp3Supplier::Decode()
 		if(stream.next_frame && stream.next_frame < stream.bufend)
 			remainder = stream.bufend - stream.next_frame;
 		if(remainder)
-			memcpy(input.data(), stream.next_frame, remainder);
+			memmove(input.data(), stream.next_frame, remainder);
 
 		// Now, read a chunk of data from the file.
 		size_t read = ReadInput(reinterpret_cast<char *>(input.data() + remainder), INPUT_CHUNK - remainder);
 
-		// If there is nothing to decode, return to the top of this loop.
-		if(!(read + remainder))
+		if(!read)
 		{
-			if(done)
-			{
-				AddBufferData(samples);
-				break;
-			}
-			continue;
+			if(wasEmpty)
+				return false;
+			wasEmpty = true;
+			// If there is nothing to decode, try again unless the input has ended.
+			if(!remainder)
+				continue;
 		}
+		else
+			wasEmpty = false;
 
 		// Hand the input to the stream decoder.
 		mad_stream_buffer(&stream, &input.front(), read + remainder);
-
-		// Loop through the decoded result for that input block.
-		while(true)
-		{
-			// Decode the next frame, and check if there is an error.
-			if(mad_frame_decode(&frame, &stream))
-			{
-				// For recoverable errors, keep going.
-				if(MAD_RECOVERABLE(stream.error))
-					continue;
-				else
-					break;
-			}
-			// Convert the decoded audio into a PCM signal.
-			mad_synth_frame(&synth, &frame);
-
-			// If the source is mono, read both output channels from the left input.
-			// Otherwise, read two separate input channels.
-			mad_fixed_t *channels[2] = {
-				synth.pcm.samples[0],
-				synth.pcm.samples[synth.pcm.channels > 1]
-			};
-
-			// We'll alternate what channel we read from each time through the loop.
-			bool channel = false;
-			for(unsigned i = 0; i < 2 * synth.pcm.length; ++i)
-			{
-				// Read the next sample from the next channel.
-				mad_fixed_t sample = *channels[channel]++;
-				channel = !channel;
-
-				// Clip and scale the sample to 16 bits.
-				sample += (1L << (MAD_F_FRACBITS - 16));
-				sample = max(-MAD_F_ONE, min(MAD_F_ONE - 1, sample));
-				samples.emplace_back(sample >> (MAD_F_FRACBITS + 1 - 16));
-			}
-		}
-		AddBufferData(samples);
 	}
-
-	// Clean up.
-	mad_synth_finish(&synth);
-	mad_frame_finish(&frame);
-	mad_stream_finish(&stream);
 }
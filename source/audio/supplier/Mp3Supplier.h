@@ -17,15 +17,37 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AsyncAudioSupplier.h"
 
+#include <mad.h>
+
+#include <array>
+
 
 
 /// Streams audio from an MP3 file.
 class Mp3Supplier : public AsyncAudioSupplier {
 public:
 	explicit Mp3Supplier(std::shared_ptr<std::iostream> data, bool looping = false);
+	~Mp3Supplier() override;
 
 
 private:
-	/// This is the entry point for the decoding thread.
+	/// Decodes frames into the output buffer until it is full.
 	void Decode() override;
+
+	/// Writes as much of the last decoded frame into the output buffer as there is space for.
+	/// Returns false if the buffer filled up before the whole frame was written.
+	bool WriteFrame();
+	/// Decodes the next frame, reading more input if needed. Returns false if there is no more input.
+	bool DecodeFrame();
+
+
+private:
+	/// The input from the file.
+	std::array<unsigned char, INPUT_CHUNK> input{};
+	// Objects for MP3 decoding:
+	mad_stream stream;
+	mad_frame frame;
+	mad_synth synth;
+	/// How many samples of the last decoded frame have been written to the output buffer.
+	unsigned written = 0;
 };
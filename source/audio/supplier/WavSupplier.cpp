@@ -15,17 +15,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "WavSupplier.h"
 
-#include "../Sound.h"
-
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 using namespace std;
 
 
 
-WavSupplier::WavSupplier(const Sound &sound, bool is3x, bool looping)
-	: AudioSupplier(is3x, looping), sound(sound), wasStarted(false)
+WavSupplier::WavSupplier(shared_ptr<const vector<sample_t>> buffer, shared_ptr<const vector<sample_t>> buffer3x,
+		bool is3x, bool looping)
+	: AudioSupplier(is3x, looping), buffer(std::move(buffer)), buffer3x(std::move(buffer3x)), wasStarted(false)
 {
 }
 
@@ -38,7 +38,7 @@ size_t WavSupplier::MaxChunks() const
 	else if(wasStarted && !currentSample)
 		return 0;
 	else
-		return ceil(((is3x ? sound.Buffer3x() : sound.Buffer()).size() - currentSample) / static_cast<float>(OUTPUT_CHUNK));
+		return ceil(((is3x ? *buffer3x : *buffer).size() - currentSample) / static_cast<float>(OUTPUT_CHUNK));
 }
 
 
@@ -50,12 +50,14 @@ size_t WavSupplier::AvailableChunks() const
 
 
 
-vector<AudioSupplier::sample_t> WavSupplier::NextDataChunk()
+void WavSupplier::NextDataChunk(vector<sample_t> &chunk)
 {
-	vector<sample_t> samples(OUTPUT_CHUNK);
 	// If we are at the beginning of the buffer and it was already played, this is a loop.
 	if(!currentSample && wasStarted && !isLooping)
-		return samples;
+	{
+		fill(chunk.begin(), chunk.end(), 0);
+		return;
+	}
 
 	size_t currentSampleCount = 0;
 	do {
@@ -65,12 +67,13 @@ vector<AudioSupplier::sample_t> WavSupplier::NextDataChunk()
 			is3x = nextPlaybackIs3x;
 			wasStarted = true;
 		}
-		const vector<sample_t> &input = is3x ? sound.Buffer3x() : sound.Buffer();
-		size_t readChunk = min(input.size() - currentSample, samples.size() - currentSampleCount);
-		std::copy_n(input.begin() + currentSample, readChunk, samples.begin() + currentSampleCount);
+		const vector<sample_t> &input = is3x ? *buffer3x : *buffer;
+		size_t readChunk = min(input.size() - currentSample, chunk.size() - currentSampleCount);
+		std::copy_n(input.begin() + currentSample, readChunk, chunk.begin() + currentSampleCount);
 		currentSampleCount += readChunk;
 		currentSample = (currentSample + readChunk) % input.size();
-	} while(currentSampleCount < samples.size() && isLooping);
-	return samples;
+	} while(currentSampleCount < chunk.size() && isLooping);
+	// Pad the end of a sound that does not loop with silence.
+	fill(chunk.begin() + currentSampleCount, chunk.end(), 0);
 }
 
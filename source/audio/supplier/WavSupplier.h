@@ -17,22 +17,25 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AudioSupplier.h"
 
-class Sound;
+#include <memory>
+#include <vector>
 
 
 
 /// A sync buffered supplier for waveform files. The audio is supplied in a single chunk.
 class WavSupplier : public AudioSupplier {
 public:
-	WavSupplier(const Sound &sound, bool is3x, bool looping = false);
+	WavSupplier(std::shared_ptr<const std::vector<sample_t>> buffer,
+		std::shared_ptr<const std::vector<sample_t>> buffer3x, bool is3x, bool looping = false);
 
 	// Inherited pure virtual methods
 	size_t MaxChunks() const override;
 	size_t AvailableChunks() const override;
-	std::vector<sample_t> NextDataChunk() override;
+	void NextDataChunk(std::vector<sample_t> &chunk) override;
 
 
 private:
-	const Sound &sound;
+	std::shared_ptr<const std::vector<sample_t>> buffer;
+	std::shared_ptr<const std::vector<sample_t>> buffer3x;
 	bool wasStarted;
 };
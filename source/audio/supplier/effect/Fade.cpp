@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Fade.h"
 
+#include <algorithm>
+
 using namespace std;
 
 
@@ -65,44 +67,73 @@ size_t Fade::AvailableChunks() const
 
 
 
-vector<AudioSupplier::sample_t> Fade::NextDataChunk()
+void Fade::NextDataChunk(vector<sample_t> &chunk)
 {
-	vector<sample_t> result;
 	if(!primarySource && fadeProgress.empty())
 		// With no input sources, output silence.
-		result = vector<sample_t>(OUTPUT_CHUNK);
+		fill(chunk.begin(), chunk.end(), 0);
 	else if(primarySource && fadeProgress.empty())
 		// With only primary input (nothing to blend with), output primary.
-		result = primarySource->NextDataChunk();
+		primarySource->NextDataChunk(chunk);
 	else // fade sources
 	{
 		// Generate the faded background.
-		vector<sample_t> faded = std::get<0>(fadeProgress[0])->NextDataChunk();
+		backgroundChunk.resize(chunk.size());
+		sourceChunk.resize(chunk.size());
+		std::get<0>(fadeProgress[0])->NextDataChunk(backgroundChunk);
 		for(size_t i = 1; i < fadeProgress.size(); ++i)
 		{
-			vector<sample_t> other = std::get<0>(fadeProgress[i])->NextDataChunk();
+			std::get<0>(fadeProgress[i])->NextDataChunk(sourceChunk);
 			auto &[source, fade, fadePerFrame] = fadeProgress[i - 1];
-			CrossFade(faded, other, fade, fadePerFrame);
-			faded = std::move(other);
+			CrossFade(backgroundChunk, sourceChunk, fade, fadePerFrame);
+			backgroundChunk.swap(sourceChunk);
 		}
 
 		// Get the foreground data.
 		if(primarySource)
-			result = primarySource->NextDataChunk();
+			primarySource->NextDataChunk(chunk);
 		else
-			result.resize(OUTPUT_CHUNK); // silence
+			fill(chunk.begin(), chunk.end(), 0); // silence
 
 		// The final blend.
 		auto &[source, fade, fadePerFrame] = fadeProgress.back();
-		CrossFade(faded, result, fade, fadePerFrame);
+		CrossFade(backgroundChunk, chunk, fade, fadePerFrame);
 	}
 
-	// Clean up the finished sources.
+	RemoveFinishedSources();
+}
+
+
+
+// If only the primary source is playing, its chunks are passed along without being copied.
+span<const AudioSupplier::sample_t> Fade::PeekChunk(vector<sample_t> &chunk)
+{
+	isForwarding = primarySource && fadeProgress.empty();
+	if(isForwarding)
+		return primarySource->PeekChunk(chunk);
+
+	NextDataChunk(chunk);
+	return chunk;
+}
+
+
+
+void Fade::ReleaseChunk()
+{
+	if(!isForwarding)
+		return;
+	isForwarding = false;
+	primarySource->ReleaseChunk();
+	RemoveFinishedSources();
+}
+
+
+
+void Fade::RemoveFinishedSources()
+{
 	if(primarySource && !primarySource->MaxChunks())
 		primarySource.reset();
 	erase_if(fadeProgress, [](const auto &faded){ return !std::get<1>(faded) || !std::get<0>(faded)->MaxChunks(); });
-
-	return result;
 }
 
 
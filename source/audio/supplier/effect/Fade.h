@@ -43,10 +43,16 @@ public:
 	// Inherited pure virtual methods
 	size_t MaxChunks() const override;
 	size_t AvailableChunks() const override;
-	std::vector<sample_t> NextDataChunk() override;
+	void NextDataChunk(std::vector<sample_t> &chunk) override;
+	/// If only the primary source is playing, its chunks are passed along without being copied.
+	std::span<const sample_t> PeekChunk(std::vector<sample_t> &chunk) override;
+	void ReleaseChunk() override;
 
 
 private:
+	/// Removes the sources that have finished playing or fading out.
+	void RemoveFinishedSources();
+
 	/// Cross-fades two sources. The faded result is stored in the fadeIn input.
 	static void CrossFade(const std::vector<sample_t> &fadeOut, std::vector<sample_t> &fadeIn, size_t &fade,
 		size_t fadePerFrame);
@@ -57,4 +63,10 @@ private:
 	std::vector<std::tuple<std::unique_ptr<AudioSupplier>, size_t, size_t>> fadeProgress;
 	/// The primary source; this one is not faded out by itself, but can be cross-faded with the other sources.
 	std::unique_ptr<AudioSupplier> primarySource;
+	/// Whether the last chunk given out by PeekChunk() came from the primary source.
+	bool isForwarding = false;
+
+	/// The chunks of the fading sources, which are kept so that they do not need to be reallocated for every chunk.
+	std::vector<sample_t> backgroundChunk;
+	std::vector<sample_t> sourceChunk;
 };
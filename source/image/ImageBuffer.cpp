@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ImageBuffer.h"
 
 #include "../Files.h"
+#include "../FileView.h"
 #include "ImageFileData.h"
 #include "../Logger.h"
 
@@ -23,10 +24,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <jpeglib.h>
 #include <png.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 using namespace std;
@@ -74,6 +77,15 @@ ImageBuffer::ImageBuffer(int frames)
 
 
 
+// Take over the other buffer's pixels, leaving it empty.
+ImageBuffer::ImageBuffer(ImageBuffer &&other) noexcept
+	: width(other.width), height(other.height), frames(other.frames), pixels(other.pixels)
+{
+	other.pixels = nullptr;
+}
+
+
+
 ImageBuffer::~ImageBuffer()
 {
 	Clear();
@@ -222,17 +234,28 @@ int ImageBuffer::Read(const ImageFileData &data, int frame, bool onlyDimensions)
 
 
 namespace {
+	// The part of a PNG file that libpng has not read yet.
+	class PNGInput {
+	public:
+		string_view data;
+	};
+
 	void ReadPNGInput(png_structp pngStruct, png_bytep outBytes, png_size_t byteCountToRead)
 	{
-		static_cast<iostream *>(png_get_io_ptr(pngStruct))->read(reinterpret_cast<char *>(outBytes), byteCountToRead);
+		string_view &data = static_cast<PNGInput *>(png_get_io_ptr(pngStruct))->data;
+		if(byteCountToRead > data.size())
+			png_error(pngStruct, "Unexpected end of file");
+		copy_n(data.data(), byteCountToRead, outBytes);
+		data.remove_prefix(byteCountToRead);
 	}
 
 	bool ReadPNG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool onlyDimensions)
 	{
 		// Open the file, and make sure it really is a PNG.
-		shared_ptr<iostream> file = Files::Open(path.string());
-		if(!file)
+		const FileView file = Files::Map(path);
+		if(file.Empty())
 			return false;
+		PNGInput input{file.Data()};
 
 		// Set up libpng.
 		png_struct *png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
@@ -252,7 +275,7 @@ namespace {
 			return false;
 		}
 
-		png_set_read_fn(png, file.get(), ReadPNGInput);
+		png_set_read_fn(png, &input, ReadPNGInput);
 		png_set_sig_bytes(png, 0);
 
 		png_read_info(png, info);
@@ -335,8 +358,8 @@ namespace {
 
 	bool ReadJPG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool onlyDimensions)
 	{
-		string data = Files::Read(path);
-		if(data.empty())
+		const FileView file = Files::Map(path);
+		if(file.Empty())
 			return false;
 
 		jpeg_decompress_struct cinfo;
@@ -347,7 +370,7 @@ namespace {
 		jpeg_create_decompress(&cinfo);
 #pragma GCC diagnostic pop
 
-		jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char *>(data.data()), data.size());
+		jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char *>(file.Data().data()), file.Size());
 		jpeg_read_header(&cinfo, true);
 		cinfo.out_color_space = JCS_EXT_RGBA;
 
@@ -420,9 +443,10 @@ namespace {
 		}
 		// Maintenance note: this is where decoder defaults should be overwritten (codec, exif/xmp, etc.)
 
-		string data = Files::Read(path);
-		avifResult result = avifDecoderSetIOMemory(decoder.get(), reinterpret_cast<const uint8_t *>(data.c_str()),
-			data.size());
+		// The decoder reads straight from the file's contents while decoding.
+		const FileView file = Files::Map(path);
+		avifResult result = avifDecoderSetIOMemory(decoder.get(), reinterpret_cast<const uint8_t *>(file.Data().data()),
+			file.Size());
 		if(result != AVIF_RESULT_OK)
 		{
 			Logger::Log("Could not read file: " + path.generic_string(), Logger::Level::WARNING);
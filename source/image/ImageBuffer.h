@@ -42,6 +42,8 @@ public:
 	// of them. So, it must be Allocate()d later.
 	ImageBuffer(int frames = 1);
 	ImageBuffer(const ImageBuffer &) = delete;
+	// Take over the other buffer's pixels, leaving it empty.
+	ImageBuffer(ImageBuffer &&other) noexcept;
 	~ImageBuffer();
 
 	ImageBuffer &operator=(const ImageBuffer &) = delete;
@@ -289,17 +289,30 @@ void ImageSet::LoadDimensions(Sprite *sprite) noexcept(false)
 // Create the sprite and optionally upload the image data to the GPU. After this is
 // called, the internal image buffers and mask vector will be cleared, but
 // the paths are saved in case the sprite needs to be loaded again.
-void ImageSet::Upload(Sprite *sprite, bool enableUpload)
+void ImageSet::Upload(Sprite *sprite, bool enableUpload, bool mayShareTexture)
 {
 	// Clear all the buffers if we are not uploading the image data.
 	if(!enableUpload)
 		for(ImageBuffer &it : buffer)
 			it.Clear();
 
-	// Load the frames (this will clear the buffers).
-	sprite->AddFrames(buffer[0], buffer[1], noReduction);
+	// Load the frames (this will clear the buffers). Sprites with a swizzle mask
+	// are never packed into a shared texture, since their mask is not.
+	sprite->AddFrames(buffer[0], buffer[1], noReduction,
+		mayShareTexture && !buffer[2].Pixels() && !buffer[3].Pixels());
 	sprite->AddSwizzleMaskFrames(buffer[2], buffer[3], noReduction);
 
 	GameData::GetMaskManager().SetMasks(sprite, std::move(masks));
 	masks.clear();
 }
+
+
+
+// Create the sprite, but leave the image data to be uploaded a part at a time.
+void ImageSet::Stage(Sprite *sprite)
+{
+	sprite->StageFrames(buffer[0], buffer[1], buffer[2], buffer[3], noReduction);
+
+	GameData::GetMaskManager().SetMasks(sprite, std::move(masks));
+	masks.clear();
+}
@@ -60,8 +60,13 @@ public:
 	void LoadDimensions(Sprite *sprite) noexcept(false);
 	// Create the sprite and optionally upload the image data to the GPU. After this is
 	// called, the internal image buffers and mask vector will be cleared, but
-	// the paths are saved in case the sprite needs to be loaded again.
-	void Upload(Sprite *sprite, bool enableUpload);
+	// the paths are saved in case the sprite needs to be loaded again. Sprites that
+	// will stay loaded may share a texture with others, if they are small enough.
+	void Upload(Sprite *sprite, bool enableUpload, bool mayShareTexture = false);
+	// Create the sprite like Upload() does, but only copy the image data to the
+	// GPU as the sprite's UploadStaged() is called, so that a large image can be
+	// spread over several frames.
+	void Stage(Sprite *sprite);
 
 
 private:
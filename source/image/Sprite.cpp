@@ -19,25 +19,75 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ImageBuffer.h"
 #include "../Logger.h"
 #include "../Preferences.h"
+#include "../shader/RenderStatistics.h"
+#include "SpriteAtlas.h"
 
 #include "../opengl.h"
 
 #include <SDL2/SDL.h>
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 using namespace std;
 
 namespace {
-	void AddBuffer(const string &name, ImageBuffer &buffer, uint32_t *target, bool noReduction)
+	// Sprites that are no larger than this, and that have no more than this
+	// many frames, can be packed into an atlas texture along with others.
+	const int MAX_PACKED_SIZE = 256;
+	const int MAX_PACKED_FRAMES = 4;
+	const int ATLAS_SIZE = 1024;
+
+	// An atlas texture, with one layer for each frame of the sprites in it.
+	// All the sprites in an atlas have the same number of frames, since the
+	// shaders find the next frame of an animation by wrapping around.
+	class Atlas {
+	public:
+		SpriteAtlas layout;
+		uint32_t texture;
+		int frames;
+	};
+	vector<Atlas> atlases;
+
+	// Each pixel of a texture takes up four bytes.
+	const int64_t BYTES_PER_PIXEL = 4;
+
+	// An image that is being copied into its texture a few rows at a time.
+	class StagedTexture {
+	public:
+		StagedTexture(ImageBuffer &buffer, uint32_t texture, int64_t bytes, bool isSwizzleMask)
+			: buffer(std::move(buffer)), texture(texture), bytes(bytes), isSwizzleMask(isSwizzleMask) {}
+
+		ImageBuffer buffer;
+		uint32_t texture;
+		// How much texture memory the texture takes up.
+		int64_t bytes;
+		bool isSwizzleMask;
+		// The next frame and row of the image to copy.
+		int frame = 0;
+		int row = 0;
+	};
+	// The textures of each sprite that are still being copied.
+	map<const Sprite *, vector<StagedTexture>> staged;
+	// The staged rows are copied through this pixel buffer, if it is supported.
+	GLuint pixelBuffer = 0;
+
+
+	// Check whether this sprite is large enough to require size reduction.
+	void ReduceSize(ImageBuffer &buffer, bool noReduction)
 	{
-		// Check whether this sprite is large enough to require size reduction.
 		Preferences::LargeGraphicsReduction setting = Preferences::GetLargeGraphicsReduction();
 		if(!noReduction && (setting == Preferences::LargeGraphicsReduction::ALL
 				|| (setting == Preferences::LargeGraphicsReduction::LARGEST_ONLY
 				&& buffer.Width() * buffer.Height() >= 1000000)))
 			buffer.ShrinkToHalfSize();
+	}
 
-		// Upload the images as a single array texture.
-		int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
+
+	// Create a texture and set how it is sampled.
+	void CreateTexture(int type, uint32_t *target)
+	{
 		glGenTextures(1, target);
 		glBindTexture(type, *target);
 
@@ -49,6 +99,66 @@ namespace {
 		glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		if(type == GL_TEXTURE_3D)
 			glTexParameteri(type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	}
+
+
+	// Copy the given frames into an atlas with room for them, if they are small
+	// enough to be packed, and record which part of the atlas they cover.
+	bool PackBuffer(ImageBuffer &buffer, uint32_t *target, float rect[4])
+	{
+		int width = buffer.Width();
+		int height = buffer.Height();
+		int frames = buffer.Frames();
+		if(!OpenGL::HasTexture2DArraySupport() || width > MAX_PACKED_SIZE || height > MAX_PACKED_SIZE
+				|| frames > MAX_PACKED_FRAMES)
+			return false;
+
+		int x = 0;
+		int y = 0;
+		auto it = find_if(atlases.begin(), atlases.end(), [&](Atlas &atlas) {
+			return atlas.frames == frames && atlas.layout.Place(width, height, x, y);
+		});
+		if(it == atlases.end())
+		{
+			it = atlases.insert(atlases.end(), Atlas{SpriteAtlas(ATLAS_SIZE), 0, frames});
+			it->layout.Place(width, height, x, y);
+			CreateTexture(GL_TEXTURE_2D_ARRAY, &it->texture);
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
+				ATLAS_SIZE, ATLAS_SIZE, frames, // width, height, depth,
+				0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); // border, input format, data type, data.
+			// Atlases are never deleted, so their memory stays in use.
+			RenderStatistics::AddTextureMemory(BYTES_PER_PIXEL * ATLAS_SIZE * ATLAS_SIZE * frames);
+		}
+		else
+			glBindTexture(GL_TEXTURE_2D_ARRAY, it->texture);
+
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, x, y, 0, // target, mipmap level, x, y, z offsets,
+			width, height, frames, // width, height, depth,
+			GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // input format, data type, data.
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+		RenderStatistics::AddUpload(BYTES_PER_PIXEL * width * height * frames);
+
+		*target = it->texture;
+		rect[0] = static_cast<float>(x) / ATLAS_SIZE;
+		rect[1] = static_cast<float>(y) / ATLAS_SIZE;
+		rect[2] = static_cast<float>(width) / ATLAS_SIZE;
+		rect[3] = static_cast<float>(height) / ATLAS_SIZE;
+
+		// Free the ImageBuffer memory.
+		buffer.Clear();
+		return true;
+	}
+
+
+	// Upload the given buffer into a new texture, and return how many bytes of
+	// texture memory it takes up. If the buffer is to be staged, the texture is
+	// only given room for it, and the buffer is not cleared.
+	int64_t AddBuffer(const string &name, ImageBuffer &buffer, uint32_t *target, bool isStaged = false)
+	{
+		int64_t bytes = 0;
+		// Upload the images as a single array texture.
+		int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
+		CreateTexture(type, target);
 
 #ifndef ES_GLES
 		// Check if the texture can be uploaded by using a proxy target,
@@ -85,7 +195,11 @@ namespace {
 			// Upload the image data.
 			glTexImage3D(type, 0, GL_RGBA8, // target, mipmap level, internal format,
 				buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-				0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+				0, GL_RGBA, GL_UNSIGNED_BYTE, isStaged ? nullptr : buffer.Pixels()); // border, input format, data type, data.
+			bytes = BYTES_PER_PIXEL * buffer.Width() * buffer.Height() * buffer.Frames();
+			if(!isStaged)
+				RenderStatistics::AddUpload(bytes);
+			RenderStatistics::AddTextureMemory(bytes);
 #ifndef ES_GLES
 		}
 		else
@@ -98,7 +212,92 @@ namespace {
 		glBindTexture(type, 0);
 
 		// Free the ImageBuffer memory.
-		buffer.Clear();
+		if(!isStaged)
+			buffer.Clear();
+		return bytes;
+	}
+
+
+	// Copy as many rows of the staged image into its texture as the budget
+	// allows. At least one row is always copied, so that it is sure to finish.
+	// Returns true once every row has been copied.
+	bool CopyRows(StagedTexture &image, int64_t &budget)
+	{
+		const ImageBuffer &buffer = image.buffer;
+		if(image.frame >= buffer.Frames() || budget <= 0)
+			return image.frame >= buffer.Frames();
+
+		int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
+		glBindTexture(type, image.texture);
+		if(!pixelBuffer && OpenGL::HasPixelBufferSupport())
+			glGenBuffers(1, &pixelBuffer);
+		if(pixelBuffer)
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+
+		const int64_t rowBytes = BYTES_PER_PIXEL * buffer.Width();
+		while(image.frame < buffer.Frames() && budget > 0)
+		{
+			int rows = clamp<int64_t>(budget / rowBytes, 1, buffer.Height() - image.row);
+			int64_t bytes = rows * rowBytes;
+			const uint32_t *data = buffer.Begin(image.row, image.frame);
+			// Once the rows are in a pixel buffer, the driver can copy them into
+			// the texture in the background instead of before this returns.
+			if(pixelBuffer)
+			{
+				glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, data, GL_STREAM_DRAW);
+				data = nullptr;
+			}
+			glTexSubImage3D(type, 0, 0, image.row, image.frame, // target, mipmap level, x, y, z offsets,
+				buffer.Width(), rows, 1, // width, height, depth,
+				GL_RGBA, GL_UNSIGNED_BYTE, data); // input format, data type, data.
+			RenderStatistics::AddUpload(bytes);
+			budget -= bytes;
+
+			image.row += rows;
+			if(image.row == buffer.Height())
+			{
+				image.row = 0;
+				++image.frame;
+			}
+		}
+
+		if(pixelBuffer)
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glBindTexture(type, 0);
+		return image.frame >= buffer.Frames();
+	}
+
+
+	// Stop tracking the staged images of the given sprite. Once nothing is
+	// left to copy, the pixel buffer is freed as well.
+	void EraseStaged(map<const Sprite *, vector<StagedTexture>>::iterator it)
+	{
+		staged.erase(it);
+		if(staged.empty() && pixelBuffer)
+		{
+			glDeleteBuffers(1, &pixelBuffer);
+			pixelBuffer = 0;
+		}
+	}
+
+
+	// Stop copying any staged images for the given sprite, and delete the
+	// textures they were being copied into. Returns how many bytes of texture
+	// memory were freed.
+	int64_t DeleteStaged(const Sprite *sprite)
+	{
+		auto it = staged.find(sprite);
+		if(it == staged.end())
+			return 0;
+		int64_t bytes = 0;
+		for(StagedTexture &image : it->second)
+		{
+			glDeleteTextures(1, &image.texture);
+			bytes += image.bytes;
+		}
+		RenderStatistics::RemoveTextureMemory(bytes);
+		EraseStaged(it);
+		return bytes;
 	}
 }
 
@@ -136,7 +335,7 @@ bool Sprite::HasDimensions() const
 
 
 // Add the given frames, optionally uploading them. The given buffers will be cleared afterwards.
-void Sprite::AddFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noReduction)
+void Sprite::AddFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noReduction, bool mayShareTexture)
 {
 	isLoaded = true;
 	// The 1x image determines the dimensions of the sprite's size.
@@ -149,13 +348,12 @@ void Sprite::AddFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noRedu
 		return;
 
 	// Only use the 2x resolution image if it is provided.
-	if(buffer2x.Pixels())
-	{
-		AddBuffer(name, buffer2x, &texture, noReduction);
-		buffer1x.Clear();
-	}
-	else
-		AddBuffer(name, buffer1x, &texture, noReduction);
+	ImageBuffer &buffer = buffer2x.Pixels() ? buffer2x : buffer1x;
+	ReduceSize(buffer, noReduction);
+	sharesTexture = mayShareTexture && PackBuffer(buffer, &texture, textureRect);
+	if(!sharesTexture)
+		textureMemory += AddBuffer(name, buffer, &texture);
+	buffer1x.Clear();
 }
 
 
@@ -163,25 +361,80 @@ void Sprite::AddFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noRedu
 // Upload the given frames. The given buffers will be cleared afterwards.
 void Sprite::AddSwizzleMaskFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noReduction)
 {
-	if(!swizzleMaskFrames)
-	{
-		swizzleMaskFrames = buffer1x.Frames();
-		if(swizzleMaskFrames > 1 && swizzleMaskFrames < frames)
-			swizzleMaskFrames = 1;
-	}
+	SetSwizzleMaskFrames(buffer1x);
 
 	// Do nothing if the buffer is empty.
 	if(!buffer1x.Pixels())
 		return;
 
 	// Only use the 2x resolution image if it is provided.
-	if(buffer2x.Pixels())
+	ImageBuffer &buffer = buffer2x.Pixels() ? buffer2x : buffer1x;
+	ReduceSize(buffer, noReduction);
+	textureMemory += AddBuffer(name, buffer, &swizzleMask);
+	buffer1x.Clear();
+}
+
+
+
+// Add the given frames and swizzle mask frames, but only make room for them in the textures.
+void Sprite::StageFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, ImageBuffer &mask1x, ImageBuffer &mask2x,
+	bool noReduction)
+{
+	// If an earlier upload of this sprite has not finished yet, start over.
+	textureMemory -= DeleteStaged(this);
+
+	width = buffer1x.Width();
+	height = buffer1x.Height();
+	frames = buffer1x.Frames();
+	SetSwizzleMaskFrames(mask1x);
+
+	vector<StagedTexture> textures;
+	auto stage = [this, noReduction, &textures](ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool isSwizzleMask)
 	{
-		AddBuffer(name, buffer2x, &swizzleMask, noReduction);
+		if(buffer1x.Pixels())
+		{
+			// Only use the 2x resolution image if it is provided.
+			ImageBuffer &buffer = buffer2x.Pixels() ? buffer2x : buffer1x;
+			ReduceSize(buffer, noReduction);
+			uint32_t target = 0;
+			int64_t bytes = AddBuffer(name, buffer, &target, true);
+			textureMemory += bytes;
+			textures.emplace_back(buffer, target, bytes, isSwizzleMask);
+			// If the texture could not be created, there is nothing to copy into it.
+			if(!bytes)
+				textures.back().frame = textures.back().buffer.Frames();
+		}
 		buffer1x.Clear();
-	}
+		buffer2x.Clear();
+	};
+	stage(buffer1x, buffer2x, false);
+	stage(mask1x, mask2x, true);
+
+	if(textures.empty())
+		isLoaded = true;
 	else
-		AddBuffer(name, buffer1x, &swizzleMask, noReduction);
+		staged[this] = std::move(textures);
+}
+
+
+
+// Copy as much of the staged image data into the textures as the budget allows.
+bool Sprite::UploadStaged(int64_t &budget)
+{
+	auto it = staged.find(this);
+	if(it == staged.end())
+		return true;
+
+	for(StagedTexture &image : it->second)
+		if(!CopyRows(image, budget))
+			return false;
+
+	// Now that all the data is in place, the textures can be drawn.
+	for(const StagedTexture &image : it->second)
+		(image.isSwizzleMask ? swizzleMask : texture) = image.texture;
+	isLoaded = true;
+	EraseStaged(it);
+	return true;
 }
 
 
@@ -196,16 +449,25 @@ bool Sprite::IsLoaded() const
 // Free up all textures loaded for this sprite.
 void Sprite::Unload()
 {
-	if(texture)
-	{
+	textureMemory -= DeleteStaged(this);
+
+	// A shared texture is left for the other sprites that are packed into it.
+	// Its space is not reused, but sprites that may be unloaded do not share.
+	if(texture && !sharesTexture)
 		glDeleteTextures(1, &texture);
-		texture = 0;
-	}
+	texture = 0;
+	sharesTexture = false;
+	textureRect[0] = 0.f;
+	textureRect[1] = 0.f;
+	textureRect[2] = 1.f;
+	textureRect[3] = 1.f;
 	if(swizzleMask)
 	{
 		glDeleteTextures(1, &swizzleMask);
 		swizzleMask = 0;
 	}
+	RenderStatistics::RemoveTextureMemory(textureMemory);
+	textureMemory = 0;
 	isLoaded = false;
 	// Dimension and frame information is retained.
 }
@@ -255,6 +517,7 @@ Point Sprite::Center() const
 // Get the texture index.
 uint32_t Sprite::Texture() const
 {
+	lastUsed.store(RenderStatistics::Frames(), memory_order_relaxed);
 	return texture;
 }
 
@@ -265,3 +528,38 @@ uint32_t Sprite::SwizzleMask() const
 {
 	return swizzleMask;
 }
+
+
+
+// Get the part of the texture that this sprite covers.
+const float *Sprite::TextureRect() const
+{
+	return textureRect;
+}
+
+
+
+int64_t Sprite::TextureMemory() const
+{
+	return textureMemory;
+}
+
+
+
+// Get the last frame in which this sprite was drawn.
+int64_t Sprite::LastUsed() const
+{
+	return lastUsed.load(memory_order_relaxed);
+}
+
+
+
+void Sprite::SetSwizzleMaskFrames(const ImageBuffer &buffer1x)
+{
+	if(!swizzleMaskFrames)
+	{
+		swizzleMaskFrames = buffer1x.Frames();
+		if(swizzleMaskFrames > 1 && swizzleMaskFrames < frames)
+			swizzleMaskFrames = 1;
+	}
+}
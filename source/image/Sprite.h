@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Point.h"
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 
@@ -25,9 +26,10 @@ class ImageBuffer;
 
 
 // Class representing a drawable sprite. A sprite can have multiple frames, for
-// animation. Each frame is stored in a separate OpenGL texture object. This may
-// not be as efficient as sprite sheets, but with modern graphics cards it will
-// not matter much and it makes working with the graphics a lot simpler.
+// animation, which are stored as the layers of an OpenGL array texture. Small
+// sprites with only a few frames may instead be packed into a texture that is
+// shared with other sprites, so that they can be drawn together; in that case,
+// the sprite only covers part of each layer of the texture.
 class Sprite {
 public:
 	explicit Sprite(const std::string &name = "");
@@ -44,8 +46,18 @@ public:
 
 	// Add the given frames, optionally uploading them. The given buffers will be cleared afterwards.
 	// Receive both the 1x and 2x buffers. If the 2x buffer is not empty, then it will be used.
-	void AddFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noReduction);
+	// If the sprite may share a texture with others, it is packed into one if it is small enough.
+	void AddFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noReduction, bool mayShareTexture = false);
 	void AddSwizzleMaskFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noReduction);
+	// Add the given frames and swizzle mask frames in the same way, but only make
+	// room for them in the textures. The image data is copied in by UploadStaged(),
+	// and the sprite is not loaded until all of it has been.
+	void StageFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, ImageBuffer &mask1x, ImageBuffer &mask2x,
+		bool noReduction);
+	// Copy as much of the staged image data into the textures as the given number
+	// of bytes allows, and subtract what was copied from it. Returns true once
+	// all of the data has been copied.
+	bool UploadStaged(int64_t &budget);
 	// Whether the textures for this sprite have been uploaded yet.
 	bool IsLoaded() const;
 	// Free up all textures loaded for this sprite.
@@ -64,9 +76,21 @@ public:
 	// shifting of corner to center coordinates.
 	Point Center() const;
 
-	// Get the texture index.
+	// Get the texture index. This also records that the sprite is being drawn.
 	uint32_t Texture() const;
 	uint32_t SwizzleMask() const;
+	// Get the part of the texture that this sprite covers: the left and top
+	// edges, followed by the width and height, in texture coordinates.
+	const float *TextureRect() const;
+
+	// Get how much texture memory this sprite's own textures take up, in bytes.
+	int64_t TextureMemory() const;
+	// Get the last frame in which this sprite was drawn.
+	int64_t LastUsed() const;
+
+
+private:
+	void SetSwizzleMaskFrames(const ImageBuffer &buffer1x);
 
 
 private:
@@ -74,7 +98,14 @@ private:
 
 	uint32_t texture{};
 	uint32_t swizzleMask{};
+	float textureRect[4] = {0.f, 0.f, 1.f, 1.f};
+	// Whether the texture is shared with other sprites, and so belongs to them as well.
+	bool sharesTexture = false;
 	bool isLoaded = false;
+	// How much texture memory this sprite's own textures take up, in bytes.
+	int64_t textureMemory = 0;
+	// Sprites may be drawn from several threads at once.
+	mutable std::atomic<int64_t> lastUsed = 0;
 
 	float width = 0.f;
 	float height = 0.f;
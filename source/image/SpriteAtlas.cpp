@@ -0,0 +1,62 @@
+/* SpriteAtlas.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SpriteAtlas.h"
+
+using namespace std;
+
+
+
+SpriteAtlas::SpriteAtlas(int size)
+	: size(size)
+{
+}
+
+
+
+// The width and height of the atlas, in pixels.
+int SpriteAtlas::Size() const
+{
+	return size;
+}
+
+
+
+// Find room for a rectangle of the given size. Returns false if there is none.
+bool SpriteAtlas::Place(int width, int height, int &x, int &y)
+{
+	if(width <= 0 || height <= 0 || width > size || height > size)
+		return false;
+
+	// Use whichever shelf with room for this rectangle wastes the least height.
+	Shelf *best = nullptr;
+	for(Shelf &shelf : shelves)
+		if(shelf.height >= height && size - shelf.width >= width && (!best || shelf.height < best->height))
+			best = &shelf;
+
+	// If no shelf has room, start a new one below the others.
+	if(!best)
+	{
+		if(size - bottom < height)
+			return false;
+		best = &shelves.emplace_back(Shelf{bottom, height, 0});
+		bottom += height;
+	}
+
+	x = best->width;
+	y = best->top;
+	best->width += width;
+	return true;
+}
@@ -0,0 +1,55 @@
+/* SpriteAtlas.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+
+
+// The layout of an atlas texture, into which the frames of many small sprites
+// are packed so that they can all be drawn without binding another texture.
+// Each sprite is given a rectangle of the atlas, and the rectangles are
+// arranged in rows ("shelves") whose height is that of the first sprite that
+// was placed in them. Space is never given back, since the sprites that are
+// packed into atlases stay loaded for as long as the game is running.
+class SpriteAtlas {
+public:
+	explicit SpriteAtlas(int size);
+
+	// The width and height of the atlas, in pixels.
+	int Size() const;
+
+	// Find room for a rectangle of the given size, and give the position of its
+	// top left corner. Returns false if the atlas does not have room for it.
+	bool Place(int width, int height, int &x, int &y);
+
+
+private:
+	class Shelf {
+	public:
+		int top;
+		int height;
+		// How much of the width of this shelf is in use.
+		int width;
+	};
+
+
+private:
+	int size;
+	std::vector<Shelf> shelves;
+	// The bottom of the lowest shelf.
+	int bottom = 0;
+};
@@ -17,14 +17,20 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ImageSet.h"
 #include "../Preferences.h"
+#include "../shader/RenderStatistics.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
 #include "../TaskQueue.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -56,6 +62,23 @@ namespace {
 	// Scenes remain loaded for only one in-game day before they're culled, as they are not commonly requested.
 	// Most scenes are only ever used in a single conversation, for example.
 	set<const Sprite *> loadedScenes;
+	// The most texture memory that deferred images may use, in bytes, or 0 for no
+	// limit. If there is a limit, loaded sprites are only culled once it is exceeded,
+	// starting with those that have gone the longest without being used.
+	int64_t memoryLimit = 0;
+	// How often to check how much texture memory is in use, and how many frames
+	// a sprite must go without being used before it can be culled.
+	const int MEMORY_CHECK_FRAMES = 60;
+	const int MIN_UNUSED_FRAMES = 60 * 10;
+	// The last frame in which each sprite was asked to be loaded. Sprites are
+	// usually asked for before they are drawn, such as those in the system the
+	// player is about to jump to or the thumbnails of a shop's stock, so this
+	// counts as using them.
+	map<const Sprite *, int64_t> lastRequested;
+	// Deferred sprites are asked for by the engine's calculation thread while the
+	// main thread may be culling them, so any access to the maps of loaded sprites
+	// or to lastRequested must hold this lock.
+	mutex loadedMutex;
 	// Missions and events can add new sprites to the player's current area that may need to be loaded.
 	// The code that makes these changes may not have access to the TaskQueue in UI, so they
 	// instead send a message to the SpriteLoadManager to tell the current Panel to recheck which
@@ -83,6 +106,62 @@ namespace {
 		queue.Run({}, [name = sprite->Name()] { SpriteSet::Modify(name)->Unload(); });
 	}
 
+	// Unload the given sprite right away, and stop tracking it, so that it will
+	// be loaded again the next time it is asked for. The loadedMutex must be held.
+	void ForgetSprite(const Sprite *sprite)
+	{
+		preloadedLandscapes.erase(sprite);
+		loadedStellarObjects.erase(sprite);
+		loadedThumbnails.erase(sprite);
+		loadedScenes.erase(sprite);
+		lastRequested.erase(sprite);
+		SpriteSet::Modify(sprite->Name())->Unload();
+	}
+
+	// Unload the loaded sprites that have gone the longest without being drawn
+	// or asked for, until deferred images use no more texture memory than they
+	// are allowed. Other images always stay loaded, so they do not count. The
+	// loadedMutex must be held.
+	void FreeUnusedSprites()
+	{
+		// Sprites that are still being loaded cannot be unloaded yet, but the
+		// memory they have been given counts towards the limit.
+		int64_t total = 0;
+		vector<pair<int64_t, const Sprite *>> loaded;
+		auto add = [&total, &loaded](const Sprite *sprite) -> void {
+			total += sprite->TextureMemory();
+			if(!sprite->IsLoaded())
+				return;
+			auto it = lastRequested.find(sprite);
+			int64_t last = sprite->LastUsed();
+			if(it != lastRequested.end())
+				last = max(last, it->second);
+			loaded.emplace_back(last, sprite);
+		};
+		for(const auto &it : preloadedLandscapes)
+			add(it.first);
+		for(const auto &it : loadedStellarObjects)
+			add(it.first);
+		for(const auto &it : loadedThumbnails)
+			add(it.first);
+		for(const Sprite *sprite : loadedScenes)
+			add(sprite);
+		if(total <= memoryLimit)
+			return;
+
+		const int64_t frame = RenderStatistics::Frames();
+		sort(loaded.begin(), loaded.end());
+		for(const auto &[last, sprite] : loaded)
+		{
+			// Never unload a sprite that has been used recently, since it is likely
+			// to be used again soon.
+			if(total <= memoryLimit || frame - last < MIN_UNUSED_FRAMES)
+				break;
+			total -= sprite->TextureMemory();
+			ForgetSprite(sprite);
+		}
+	}
+
 	// Functions for queueing the loading of sprites at game start.
 	void LoadSpriteQueued(TaskQueue &queue, const shared_ptr<ImageSet> &image);
 	// Loads a sprite from the image queue, recursively.
@@ -119,7 +198,9 @@ namespace {
 			queue.Run([image] { image->Load(); },
 				[image, sprite, &queue]
 				{
-					image->Upload(sprite, !preventSpriteUpload);
+					// Sprites that are not deferred are never unloaded, so they can be
+					// packed into textures that they share with other sprites.
+					image->Upload(sprite, !preventSpriteUpload, true);
 					++spritesLoaded;
 
 					// Start loading the next image in the queue, if any.
@@ -177,6 +258,8 @@ void SpriteLoadManager::FindDeferredFolders()
 		deferredFolders = {"land", "thumbnail", "outfit", "scene", "star", "planet"};
 	else
 		deferredFolders = {"land"};
+
+	memoryLimit = static_cast<int64_t>(Preferences::GetTextureMemoryLimit()) * 1024 * 1024;
 }
 
 
@@ -199,7 +282,25 @@ double SpriteLoadManager::Progress()
 void SpriteLoadManager::LoadSprite(TaskQueue &queue, const shared_ptr<ImageSet> &image)
 {
 	queue.Run([image] { image->Load(); },
-		[image] { image->Upload(SpriteSet::Modify(image->Name()), !preventSpriteUpload); });
+		[image, &queue]
+		{
+			Sprite *sprite = SpriteSet::Modify(image->Name());
+			if(preventSpriteUpload)
+			{
+				image->Upload(sprite, false);
+				return;
+			}
+			// These images can be large, and are loaded while the game is running,
+			// so spread copying them to the GPU over as many frames as it takes. If the
+			// queue goes away first, free what was staged so it can be loaded again later.
+			image->Stage(sprite);
+			queue.RunUpload([sprite](int64_t &budget) { return sprite->UploadStaged(budget); },
+				[sprite]
+				{
+					lock_guard lock(loadedMutex);
+					ForgetSprite(sprite);
+				});
+		});
 }
 
 
@@ -218,6 +319,10 @@ void SpriteLoadManager::LoadDeferred(TaskQueue &queue, const Sprite *sprite)
 	if(!sprite || dit == deferred.end())
 		return;
 
+	lock_guard lock(loadedMutex);
+	if(memoryLimit)
+		lastRequested[sprite] = RenderStatistics::Frames();
+
 	const string &name = sprite->Name();
 	const shared_ptr<ImageSet> &image = dit->second;
 	if(name.starts_with("land/"))
@@ -234,6 +339,11 @@ void SpriteLoadManager::LoadDeferred(TaskQueue &queue, const Sprite *sprite)
 
 void SpriteLoadManager::CullOldImages(TaskQueue &queue)
 {
+	// If there is a memory limit, images are only culled once it is exceeded.
+	if(memoryLimit)
+		return;
+
+	lock_guard lock(loadedMutex);
 	auto Cull = [&queue](map<const Sprite *, int> &loadedSprites) -> void {
 		for(auto it = loadedSprites.begin(); it != loadedSprites.end(); )
 		{
@@ -258,6 +368,17 @@ void SpriteLoadManager::CullOldImages(TaskQueue &queue)
 
 
 
+void SpriteLoadManager::Step()
+{
+	if(memoryLimit && !(RenderStatistics::Frames() % MEMORY_CHECK_FRAMES))
+	{
+		lock_guard lock(loadedMutex);
+		FreeUnusedSprites();
+	}
+}
+
+
+
 void SpriteLoadManager::SetRecheckThumbnails()
 {
 	recheckThumbnails = true;
@@ -309,12 +430,13 @@ void SpriteLoadManager::LoadLandscape(TaskQueue &queue, const Sprite *sprite, co
 
 	// This sprite is not currently preloaded. Check to see whether we already
 	// have the maximum number of sprites loaded, in which case the oldest one
-	// must be unloaded to make room for this one.
+	// must be unloaded to make room for this one. If there is a memory limit,
+	// that decides when landscapes are unloaded instead.
 	pit = preloadedLandscapes.begin();
 	while(pit != preloadedLandscapes.end())
 	{
 		++pit->second;
-		if(pit->second >= LANDSCAPE_LIMIT)
+		if(pit->second >= LANDSCAPE_LIMIT && !memoryLimit)
 		{
 			UnloadSprite(queue, pit->first);
 			pit = preloadedLandscapes.erase(pit);
@@ -45,6 +45,10 @@ public:
 	static void LoadDeferred(TaskQueue &queue, const Sprite *sprite);
 	// Cull old stellar objects and thumbnails that haven't been seen in a while.
 	static void CullOldImages(TaskQueue &queue);
+	// If deferred images are using more texture memory than they are allowed to, unload
+	// those that have gone the longest without being drawn. This must be called
+	// on the main thread once per frame.
+	static void Step();
 
 	// Changes can be made by missions or events that cause new assets to appear.
 	// When this happens, a class can signal to the SpriteLoadManager than a panel
@@ -53,6 +53,6 @@ Sprite *SpriteSet::Modify(const string &name)
 
 	auto it = sprites.find(name);
 	if(it == sprites.end())
-		it = sprites.emplace(name, Sprite(name)).first;
+		it = sprites.try_emplace(name, name).first;
 	return &it->second;
 }
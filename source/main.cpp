@@ -15,7 +15,9 @@ You should have received a copy of the GNU General Public License along with
 this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "AllocationCounter.h"
 #include "audio/Audio.h"
+#include "Benchmark.h"
 #include "Command.h"
 #include "Conversation.h"
 #include "CustomEvents.h"
@@ -41,7 +43,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Preferences.h"
 #include "PrintData.h"
 #include "Random.h"
+#include "shader/RenderStatistics.h"
+#include "SavedGameIndex.h"
+#include "SaveWriter.h"
 #include "Screen.h"
+#include "image/SpriteLoadManager.h"
 #include "image/SpriteSet.h"
 #include "shader/SpriteShader.h"
 #include "TaskQueue.h"
@@ -108,6 +114,8 @@ int main(int argc, char *argv[])
 	bool checkAssets = false;
 	bool printTests = false;
 	bool printData = false;
+	bool runBenchmark = false;
+	bool runRenderBenchmark = false;
 	bool noTestMute = false;
 	uint64_t nWorkerThreads = 0;
 	string testToRunName;
@@ -119,7 +127,7 @@ int main(int argc, char *argv[])
 	{
 		hasErrors |= level != Logger::Level::INFO;
 		Files::LogErrorToFile(errorMessage);
-	});
+	}, &Files::FlushErrorLog);
 
 	for(const char *const *it = argv + 1; *it; ++it)
 	{
@@ -157,11 +165,13 @@ int main(int argc, char *argv[])
 	if(nWorkerThreads)
 		TaskQueue::SetWorkerThreadCount(nWorkerThreads);
 	printData = PrintData::IsPrintDataArgument(argv);
+	runBenchmark = Benchmark::IsBenchmarkArgument(argv);
+	runRenderBenchmark = Benchmark::IsRenderBenchmarkArgument(argv);
 	Files::Init(argv);
 
 	// Whether we are running an integration test.
 	const bool isTesting = !testToRunName.empty();
-	bool isConsoleOnly = loadOnly || printTests || printData;
+	bool isConsoleOnly = loadOnly || printTests || printData || runBenchmark;
 
 	Logger::Session logSession{isConsoleOnly || isTesting};
 
@@ -197,6 +207,11 @@ int main(int argc, char *argv[])
 			PrintTestsTable();
 			return 0;
 		}
+		if(runBenchmark)
+		{
+			Benchmark::Run(argv);
+			return 0;
+		}
 
 		if(loadOnly || checkAssets)
 		{
@@ -224,9 +239,12 @@ int main(int argc, char *argv[])
 			// then check the default state of the universe.
 			if(!player.LoadRecent())
 				GameData::CheckReferences();
+			// Make sure that every error has been counted.
+			Logger::Flush();
 			cout << "Parse completed with " << (hasErrors ? "at least one" : "no") << " error(s)." << endl;
 			if(checkAssets)
 				Audio::Quit();
+			SavedGameIndex::Shutdown();
 			return hasErrors;
 		}
 		assert(!isConsoleOnly && "Attempting to use UI when only data was loaded!");
@@ -262,6 +280,8 @@ int main(int argc, char *argv[])
 		CustomEvents::Init();
 		// This is the main loop where all the action begins.
 		GameLoop(player, queue, conversation, testToRunName, debugMode);
+		if(runRenderBenchmark)
+			Benchmark::PrintRenderStatistics();
 	}
 	catch(Test::known_failure_tag)
 	{
@@ -269,6 +289,8 @@ int main(int argc, char *argv[])
 	}
 	catch(const exception &error)
 	{
+		SaveWriter::Shutdown();
+		SavedGameIndex::Shutdown();
 		Audio::Quit();
 		GameWindow::ExitWithError(error.what(), !isTesting);
 		return 1;
@@ -281,6 +303,9 @@ int main(int argc, char *argv[])
 	Preferences::Save();
 	PluginManager::Save();
 
+	// Finish writing any saved games before exiting.
+	SaveWriter::Shutdown();
+	SavedGameIndex::Shutdown();
 	Audio::Quit();
 	GameWindow::Quit();
 
@@ -406,6 +431,13 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 		chrono::steady_clock::duration gpuLoadSum{};
 		string gpuLoadString;
 		string memoryString;
+		// How many allocations had been made at the last load cache update.
+		size_t allocationStart = AllocationCounter::Count();
+		string allocationString;
+		// The rendering statistics at the last load cache update, and the
+		// averages since then, which are shown in debug mode.
+		RenderStatistics::Counts renderStart = RenderStatistics::Total();
+		Information renderInfo;
 		bool isPerformanceDisplayReady = false;
 		int step = 0;
 		int drawStep = 0;
@@ -493,10 +525,16 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 				performanceInfo.SetString("cpu", cpuLoadString);
 				performanceInfo.SetString("gpu", gpuLoadString);
 				performanceInfo.SetString("mem", memoryString);
+				performanceInfo.SetString("alloc", allocationString);
 				if(isPerformanceDisplayReady)
 					performanceInfo.SetCondition("ready");
 				static const Interface &performanceDisplay = *GameData::Interfaces().Get("performance info");
 				performanceDisplay.Draw(performanceInfo);
+				if(debugMode && isPerformanceDisplayReady)
+				{
+					static const Interface &renderDisplay = *GameData::Interfaces().Get("render info");
+					renderDisplay.Draw(renderInfo);
+				}
 				if(drawStep == 60)
 				{
 					drawStep = 0;
@@ -532,6 +570,24 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 #endif
 					// bytes / (1024 * 1024) = megabytes
 					memoryString = "MEM: " + Format::Number(virtualMemoryUse / 1048576., 2, false) + " MB";
+					// The average number of allocations per drawn frame, in all threads.
+					size_t allocationCount = AllocationCounter::Count();
+					allocationString = "ALLOC: " + Format::Number((allocationCount - allocationStart) / 60., 0, false)
+						+ " / frame";
+					allocationStart = allocationCount;
+					// The average amount of work given to the GPU per drawn frame.
+					const RenderStatistics::Counts &renderTotal = RenderStatistics::Total();
+					auto average = [](int64_t end, int64_t start) { return Format::Number((end - start) / 60., 0, false); };
+					renderInfo.SetString("draws", "DRAW: " + average(renderTotal.drawCalls, renderStart.drawCalls)
+						+ " / " + average(renderTotal.triangles, renderStart.triangles) + " tri");
+					renderInfo.SetString("binds", "BIND: " + average(renderTotal.textureBinds, renderStart.textureBinds)
+						+ " / " + average(renderTotal.uniformUpdates, renderStart.uniformUpdates) + " uni");
+					renderInfo.SetString("uploads", "UPLD: " + average(renderTotal.bufferUploads, renderStart.bufferUploads)
+						+ " / " + Format::Number((renderTotal.uploadedBytes - renderStart.uploadedBytes) / (60. * 1024.), 1, false)
+						+ " KB");
+					renderInfo.SetString("vram", "VRAM: "
+						+ Format::Number(RenderStatistics::TextureMemory() / 1048576., 1, false) + " MB");
+					renderStart = renderTotal;
 					isPerformanceDisplayReady = true;
 				}
 			}
@@ -541,10 +597,16 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 				drawStep = 0;
 				cpuLoadSum = {};
 				gpuLoadSum = {};
+				allocationStart = AllocationCounter::Count();
+				renderStart = RenderStatistics::Total();
 				isPerformanceDisplayReady = false;
 			}
 
 			GameWindow::Step();
+			RenderStatistics::EndFrame();
+			TaskQueue::ResetUploadBudget();
+			SpriteLoadManager::Step();
+			Interface::FreeUnusedBuffers();
 
 			// Lock the game loop to 60 FPS.
 			timer.Wait();
@@ -603,6 +665,10 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 				(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
 
 				GameWindow::Step();
+				RenderStatistics::EndFrame();
+				TaskQueue::ResetUploadBudget();
+				SpriteLoadManager::Step();
+				Interface::FreeUnusedBuffers();
 
 				// When we perform automated testing, then we run the game by default as quickly as possible.
 				// Except when not in headless mode so that the user can follow along.
@@ -639,6 +705,7 @@ void PrintHelp()
 	cerr << "    --tq-threads <number>: sets the number of threads used for the internal queue of tasks."
 		" Not specifying this will use a default depending on your system. Has to be at least 1." << endl;
 	PrintData::Help();
+	Benchmark::Help();
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
 	cerr << "Home page: <https://endless-sky.github.io>" << endl;
@@ -80,7 +80,26 @@ bool OpenGL::HasTexture2DArraySupport()
 
 
 
+bool OpenGL::HasInstancingSupport()
+{
+#if defined(__APPLE__) || defined(ES_GLES)
+	return hasOpenGL3Support;
+#else
+	// Instanced vertex attributes are only core in OpenGL 3.3 and later.
+	return hasOpenGL3Support && GLEW_VERSION_3_3;
+#endif
+}
+
+
+
 bool OpenGL::HasClearBufferSupport()
 {
 	return hasOpenGL3Support;
 }
+
+
+
+bool OpenGL::HasPixelBufferSupport()
+{
+	return hasOpenGL3Support;
+}
@@ -38,5 +38,7 @@ public:
 	static bool HasAdaptiveVSyncSupport();
 	static bool HasVaoSupport();
 	static bool HasTexture2DArraySupport();
+	static bool HasInstancingSupport();
 	static bool HasClearBufferSupport();
+	static bool HasPixelBufferSupport();
 };
@@ -20,19 +20,25 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Screen.h"
 #include "../image/Sprite.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace std;
 
 namespace {
-	void Push(vector<float> &v, const Point &pos, float s, float t, float frame, float alpha)
+	const size_t FLOATS_PER_VERTEX = 10;
+	const size_t VERTICES_PER_OBJECT = 6;
+	const size_t FLOATS_PER_OBJECT = FLOATS_PER_VERTEX * VERTICES_PER_OBJECT;
+
+	float *Push(float *v, const Point &pos, float s, float t, float frame, float alpha, const float *texRect)
 	{
-		v.push_back(pos.X());
-		v.push_back(pos.Y());
-		v.push_back(s);
-		v.push_back(t);
-		v.push_back(frame);
-		v.push_back(alpha);
+		*v++ = pos.X();
+		*v++ = pos.Y();
+		*v++ = s;
+		*v++ = t;
+		*v++ = frame;
+		*v++ = alpha;
+		return copy_n(texRect, 4, v);
 	}
 }
 
@@ -41,7 +47,10 @@ namespace {
 // Clear the list, also setting the global time step for animation.
 void BatchDrawList::Clear(int step, double zoom)
 {
+	// Clearing the vectors keeps their memory, so nothing needs to be
+	// allocated for the next frame's objects.
 	data.clear();
+	objects.clear();
 	this->step = step;
 	this->zoom = zoom;
 }
@@ -84,10 +93,29 @@ bool BatchDrawList::AddVisual(const Body &visual)
 // Draw all the items in this list.
 void BatchDrawList::Draw() const
 {
+	// Group the objects by texture. Sorting by index as well keeps the objects
+	// with each texture in the order they were added.
+	order.clear();
+	for(const auto &[sprite, index] : objects)
+		order.emplace_back(sprite->Texture(), index);
+	sort(order.begin(), order.end());
+
+	sorted.resize(data.size());
+	ranges.clear();
+	float *out = sorted.data();
+	for(const auto &[texture, index] : order)
+	{
+		if(ranges.empty() || ranges.back().sprite->Texture() != texture)
+			ranges.push_back(Range{objects[index].first, static_cast<size_t>(out - sorted.data()) / FLOATS_PER_VERTEX, 0});
+		ranges.back().count += VERTICES_PER_OBJECT;
+		out = copy_n(data.begin() + index * FLOATS_PER_OBJECT, FLOATS_PER_OBJECT, out);
+	}
+
 	BatchShader::Bind();
 
-	for(const pair<const Sprite *const, vector<float>> &it : data)
-		BatchShader::Add(it.first, it.second);
+	BatchShader::Upload(sorted);
+	for(const Range &range : ranges)
+		BatchShader::Add(range.sprite, range.first, range.count);
 
 	BatchShader::Unbind();
 }
@@ -122,8 +150,11 @@ bool BatchDrawList::Add(const Body &body, Point position, float clip)
 	if(Cull(body, position))
 		return false;
 
-	// Get the data vector for this particular sprite.
-	vector<float> &v = data[body.GetSprite()];
+	// Make room for this object's vertices at the end of the data.
+	size_t index = objects.size();
+	objects.emplace_back(body.GetSprite(), index);
+	data.resize(data.size() + FLOATS_PER_OBJECT);
+	float *v = &data[index * FLOATS_PER_OBJECT];
 	// The sprite frame is the same for every vertex.
 	float frame = body.GetFrame(step);
 
@@ -144,15 +175,16 @@ bool BatchDrawList::Add(const Body &body, Point position, float clip)
 	Point bottomRight = bottomLeft + uw;
 
 	float alpha = body.Alpha(center);
+	const float *texRect = body.GetSprite()->TextureRect();
 
 	// Push two copies of the first and last vertices to mark the break between
 	// the sprites.
-	Push(v, topLeft, 0.f, 1.f, frame, alpha);
-	Push(v, topLeft, 0.f, 1.f, frame, alpha);
-	Push(v, topRight, 1.f, 1.f, frame, alpha);
-	Push(v, bottomLeft, 0.f, 1.f - clip, frame, alpha);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha);
+	v = Push(v, topLeft, 0.f, 1.f, frame, alpha, texRect);
+	v = Push(v, topLeft, 0.f, 1.f, frame, alpha, texRect);
+	v = Push(v, topRight, 1.f, 1.f, frame, alpha, texRect);
+	v = Push(v, bottomLeft, 0.f, 1.f - clip, frame, alpha, texRect);
+	v = Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha, texRect);
+	Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha, texRect);
 
 	return true;
 }
@@ -17,7 +17,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Point.h"
 
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 class Body;
@@ -26,7 +28,8 @@ class Sprite;
 
 
 // This class collects a set of OpenGL draw commands to issue and groups them by
-// sprite, so all instances of each sprite can be drawn with a single command.
+// texture, so all instances of each sprite, and of any other sprites packed into
+// the same texture, can be drawn with a single command.
 class BatchDrawList {
 public:
 	// Clear the list, also setting the global time step for animation.
@@ -56,7 +59,24 @@ private:
 
 	// Each sprite consists of six vertices (four vertices to form a quad and
 	// two dummy vertices to mark the break in between them). Each of those
-	// vertices has six attributes: (x, y) position in pixels, (s, t) texture
-	// coordinates, the index of the sprite frame, and the alpha value.
-	std::map<const Sprite *, std::vector<float>> data;
+	// vertices has ten attributes: (x, y) position in pixels, (s, t) texture
+	// coordinates, the index of the sprite frame, the alpha value, and the part
+	// of the texture that the sprite covers. The vertices of each object are
+	// stored in the order they were added.
+	std::vector<float> data;
+	// The sprite of each object, and the index of its vertices in the data.
+	std::vector<std::pair<const Sprite *, uint32_t>> objects;
+
+	// When drawing, the objects are grouped by texture, so that each texture
+	// only needs one draw command. These are only used while drawing, but they
+	// are kept so that their memory is reused from one frame to the next.
+	class Range {
+	public:
+		const Sprite *sprite;
+		size_t first;
+		size_t count;
+	};
+	mutable std::vector<std::pair<uint32_t, uint32_t>> order;
+	mutable std::vector<float> sorted;
+	mutable std::vector<Range> ranges;
 };
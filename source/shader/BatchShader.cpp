@@ -16,10 +16,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "BatchShader.h"
 
 #include "../GameData.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 #include "../image/Sprite.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace {
@@ -31,13 +34,16 @@ namespace {
 	GLint vertI;
 	GLint texCoordI;
 	GLint alphaI;
+	GLint texRectI;
 
 	GLuint vao;
 	GLuint vbo;
+	// The size of the vertex buffer's storage, which only ever grows.
+	size_t capacity = 0;
 
 	void EnableAttribArrays()
 	{
-		constexpr auto stride = 6 * sizeof(float);
+		constexpr auto stride = 10 * sizeof(float);
 		glEnableVertexAttribArray(vertI);
 		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, stride, nullptr);
 		// The 3 texture fields (s, t, frame) come after the x,y pixel fields.
@@ -48,6 +54,10 @@ namespace {
 		auto alphaOffset = reinterpret_cast<const GLvoid *>(5 * sizeof(float));
 		glEnableVertexAttribArray(alphaI);
 		glVertexAttribPointer(alphaI, 1, GL_FLOAT, GL_FALSE, stride, alphaOffset);
+		// The part of the texture that the sprite covers.
+		auto texRectOffset = reinterpret_cast<const GLvoid *>(6 * sizeof(float));
+		glEnableVertexAttribArray(texRectI);
+		glVertexAttribPointer(texRectI, 4, GL_FLOAT, GL_FALSE, stride, texRectOffset);
 	}
 }
 
@@ -66,10 +76,11 @@ void BatchShader::Init()
 	vertI = shader->Attrib("vert");
 	texCoordI = shader->Attrib("texCoord");
 	alphaI = shader->Attrib("alpha");
+	texRectI = shader->Attrib("texRect");
 
 	// Make sure we're using texture 0.
 	glUseProgram(shader->Object());
-	glUniform1i(shader->Uniform("tex"), 0);
+	RenderStatistics::SetUniform(glUniform1i, shader->Uniform("tex"), 0);
 	glUseProgram(0);
 
 	// Generate the buffer for uploading the batch vertex data.
@@ -107,27 +118,40 @@ void BatchShader::Bind()
 
 	// Set up the screen scale.
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 }
 
 
 
-void BatchShader::Add(const Sprite *sprite, const vector<float> &data)
+void BatchShader::Upload(const vector<float> &data)
+{
+	// Orphan the buffer's previous contents, so that the driver can give it new
+	// storage instead of waiting for any draws that are still using the old one.
+	size_t size = sizeof(float) * data.size();
+	capacity = max(capacity, size);
+	glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, data.data());
+	RenderStatistics::AddUpload(size);
+}
+
+
+
+void BatchShader::Add(const Sprite *sprite, size_t first, size_t count)
 {
 	// Do nothing if there are no sprites to draw.
-	if(data.empty())
+	if(!count)
 		return;
 
 	// First, bind the proper texture.
 	glBindTexture(OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D, sprite->Texture());
 	// The shader also needs to know how many frames the texture has.
-	glUniform1f(frameCountI, sprite->Frames());
-
-	// Upload the vertex data.
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
+	RenderStatistics::SetUniform(glUniform1f, frameCountI, sprite->Frames());
+	RenderStatistics::AddTextureBinds();
 
-	// Draw all the vertices.
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, data.size() / 6);
+	// Draw all the vertices. Each vertex after the first two adds a triangle to
+	// the strip, although some of them are only there to join the sprites.
+	glDrawArrays(GL_TRIANGLE_STRIP, first, count);
+	RenderStatistics::AddDrawCall(count > 2 ? count - 2 : 0);
 }
 
 
@@ -140,6 +164,7 @@ void BatchShader::Unbind()
 		glDisableVertexAttribArray(vertI);
 		glDisableVertexAttribArray(texCoordI);
 		glDisableVertexAttribArray(alphaI);
+		glDisableVertexAttribArray(texRectI);
 	}
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	if(OpenGL::HasVaoSupport())
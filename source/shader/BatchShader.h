@@ -15,20 +15,27 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 class Sprite;
 
 
 
-// Class for drawing sprites in a batch. The input to each draw command is a
-// sprite and the vertex data.
+// Class for drawing sprites in a batch. The vertex data for everything that
+// is to be drawn is uploaded at once, and then each draw command is a sprite
+// and the range of that data to draw with it.
 class BatchShader {
 public:
 	// Initialize the shaders.
 	static void Init();
 
 	static void Bind();
-	static void Add(const Sprite *sprite, const std::vector<float> &data);
+	// Upload the vertex data for all the sprites that will be drawn before the
+	// shader is unbound.
+	static void Upload(const std::vector<float> &data);
+	// Draw the given range of the uploaded vertices using the given sprite's
+	// texture, which may be shared by other sprites drawn in the same range.
+	static void Add(const Sprite *sprite, size_t first, size_t count);
 	static void Unbind();
 };
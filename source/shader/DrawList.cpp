@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../image/Sprite.h"
 #include "SpriteShader.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace std;
@@ -95,13 +96,7 @@ bool DrawList::AddSwizzled(const Body &body, const Swizzle *swizzle, double cloa
 // Draw all the items in this list.
 void DrawList::Draw() const
 {
-	SpriteShader::Bind();
-
-	bool withBlur = Preferences::Has("Render motion blur");
-	for(const SpriteShader::Item &item : items)
-		SpriteShader::Add(item, withBlur);
-
-	SpriteShader::Unbind();
+	SpriteShader::Draw(items, Preferences::Has("Render motion blur"));
 }
 
 
@@ -135,6 +130,7 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, const
 
 	item.texture = body.GetSprite()->Texture();
 	item.swizzleMask = body.GetSprite()->SwizzleMask();
+	copy_n(body.GetSprite()->TextureRect(), 4, item.texRect);
 	item.frame = body.GetFrame(step);
 	item.frameCount = body.GetSprite()->Frames();
 	item.uniqueSwizzleMaskFrames = body.GetSprite()->SwizzleMaskFrames() > 1;
@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Color.h"
 #include "../GameData.h"
 #include "../Rectangle.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 
@@ -108,17 +109,18 @@ void FillShader::Fill(const Point &center, const Point &size, const Color &color
 	}
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 
 	GLfloat centerV[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
-	glUniform2fv(centerI, 1, centerV);
+	RenderStatistics::SetUniform(glUniform2fv, centerI, 1, centerV);
 
 	GLfloat sizeV[2] = {static_cast<float>(size.X()), static_cast<float>(size.Y())};
-	glUniform2fv(sizeI, 1, sizeV);
+	RenderStatistics::SetUniform(glUniform2fv, sizeI, 1, sizeV);
 
-	glUniform4fv(colorI, 1, color.Get());
+	RenderStatistics::SetUniform(glUniform4fv, colorI, 1, color.Get());
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderStatistics::AddDrawCall(2);
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
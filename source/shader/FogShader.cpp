@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../GameData.h"
 #include "../PlayerInfo.h"
 #include "../Point.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 #include "../System.h"
@@ -80,7 +81,7 @@ void FogShader::Init()
 	vertI = shader->Attrib("vert");
 
 	glUseProgram(shader->Object());
-	glUniform1i(shader->Uniform("tex"), 0);
+	RenderStatistics::SetUniform(glUniform1i, shader->Uniform("tex"), 0);
 	glUseProgram(0);
 
 	// Generate the vertex data for drawing sprites.
@@ -211,6 +212,7 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 			glBindTexture(GL_TEXTURE_2D, texture);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, columns, rows, GL_RED, GL_UNSIGNED_BYTE, data);
 		}
+		RenderStatistics::AddUpload(columns * rows);
 	}
 	else
 		glBindTexture(GL_TEXTURE_2D, texture);
@@ -228,14 +230,16 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 	GLfloat corner[2] = {
 		static_cast<float>(left - .5 * GRID * zoom) / (.5f * Screen::Width()),
 		static_cast<float>(top - .5 * GRID * zoom) / (-.5f * Screen::Height())};
-	glUniform2fv(cornerI, 1, corner);
+	RenderStatistics::SetUniform(glUniform2fv, cornerI, 1, corner);
 	GLfloat dimensions[2] = {
 		GRID * static_cast<float>(zoom) * (columns + 1.f) / (.5f * Screen::Width()),
 		GRID * static_cast<float>(zoom) * (rows + 1.f) / (-.5f * Screen::Height())};
-	glUniform2fv(dimensionsI, 1, dimensions);
+	RenderStatistics::SetUniform(glUniform2fv, dimensionsI, 1, dimensions);
+	RenderStatistics::AddTextureBinds();
 
 	// Call the shader program to draw the image.
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderStatistics::AddDrawCall(2);
 
 	// Clean up.
 	if(OpenGL::HasVaoSupport())
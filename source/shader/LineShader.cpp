@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Color.h"
 #include "../GameData.h"
 #include "../Point.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 
@@ -136,22 +137,23 @@ void LineShader::DrawGradient(const Point &from, const Point &to, float width,
 	}
 
 	GLfloat scale[2] = {static_cast<GLfloat>(Screen::Width()), static_cast<GLfloat>(Screen::Height())};
-	glUniform2fv(scaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 
 	GLfloat start[2] = {static_cast<float>(from.X()), static_cast<float>(from.Y())};
-	glUniform2fv(startI, 1, start);
+	RenderStatistics::SetUniform(glUniform2fv, startI, 1, start);
 
 	GLfloat end[2] = {static_cast<float>(to.X()), static_cast<float>(to.Y())};
-	glUniform2fv(endI, 1, end);
+	RenderStatistics::SetUniform(glUniform2fv, endI, 1, end);
 
-	glUniform1f(widthI, width);
+	RenderStatistics::SetUniform(glUniform1f, widthI, width);
 
-	glUniform4fv(fromColorI, 1, fromColor.Get());
-	glUniform4fv(toColorI, 1, toColor.Get());
+	RenderStatistics::SetUniform(glUniform4fv, fromColorI, 1, fromColor.Get());
+	RenderStatistics::SetUniform(glUniform4fv, toColorI, 1, toColor.Get());
 
-	glUniform1i(capI, static_cast<GLint>(roundCap));
+	RenderStatistics::SetUniform(glUniform1i, capI, static_cast<GLint>(roundCap));
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderStatistics::AddDrawCall(2);
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
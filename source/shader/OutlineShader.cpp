@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Color.h"
 #include "../GameData.h"
 #include "../Point.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 #include "../image/Sprite.h"
@@ -33,6 +34,7 @@ namespace {
 	GLint frameI;
 	GLint frameCountI;
 	GLint colorI;
+	GLint texRectI;
 
 	GLint vertI;
 	GLint vertTexCoordI;
@@ -66,11 +68,12 @@ void OutlineShader::Init()
 	frameI = shader->Uniform("frame");
 	frameCountI = shader->Uniform("frameCount");
 	colorI = shader->Uniform("color");
+	texRectI = shader->Uniform("texRect");
 	vertI = shader->Attrib("vert");
 	vertTexCoordI = shader->Attrib("vertTexCoord");
 
 	glUseProgram(shader->Object());
-	glUniform1i(shader->Uniform("tex"), 0);
+	RenderStatistics::SetUniform(glUniform1i, shader->Uniform("tex"), 0);
 	glUseProgram(0);
 
 	// Generate the vertex data for drawing sprites.
@@ -115,15 +118,15 @@ void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &si
 	}
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 
 	GLfloat off[2] = {
 		static_cast<float>(.5 / size.X()),
 		static_cast<float>(.5 / size.Y())};
-	glUniform2fv(offI, 1, off);
+	RenderStatistics::SetUniform(glUniform2fv, offI, 1, off);
 
-	glUniform1f(frameI, frame);
-	glUniform1f(frameCountI, sprite->Frames());
+	RenderStatistics::SetUniform(glUniform1f, frameI, frame);
+	RenderStatistics::SetUniform(glUniform1f, frameCountI, sprite->Frames());
 
 	Point uw = unit * size.X();
 	Point uh = unit * size.Y();
@@ -133,17 +136,20 @@ void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &si
 		static_cast<float>(-uh.X()),
 		static_cast<float>(-uh.Y())
 	};
-	glUniformMatrix2fv(transformI, 1, false, transform);
+	RenderStatistics::SetUniform(glUniformMatrix2fv, transformI, 1, false, transform);
 
 	GLfloat position[2] = {
 		static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
+	RenderStatistics::SetUniform(glUniform2fv, positionI, 1, position);
 
-	glUniform4fv(colorI, 1, color.Get());
+	RenderStatistics::SetUniform(glUniform4fv, colorI, 1, color.Get());
+	RenderStatistics::SetUniform(glUniform4fv, texRectI, 1, sprite->TextureRect());
 
 	glBindTexture(OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D, sprite->Texture());
+	RenderStatistics::AddTextureBinds();
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderStatistics::AddDrawCall(2);
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Color.h"
 #include "../GameData.h"
 #include "../Point.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 
@@ -116,7 +117,7 @@ void PointerShader::Bind()
 	}
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 }
 
 
@@ -125,19 +126,20 @@ void PointerShader::Add(const Point &center, const Point &angle,
 	float width, float height, float offset, const Color &color)
 {
 	GLfloat c[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
-	glUniform2fv(centerI, 1, c);
+	RenderStatistics::SetUniform(glUniform2fv, centerI, 1, c);
 
 	GLfloat a[2] = {static_cast<float>(angle.X()), static_cast<float>(angle.Y())};
-	glUniform2fv(angleI, 1, a);
+	RenderStatistics::SetUniform(glUniform2fv, angleI, 1, a);
 
 	GLfloat size[2] = {width, height};
-	glUniform2fv(sizeI, 1, size);
+	RenderStatistics::SetUniform(glUniform2fv, sizeI, 1, size);
 
-	glUniform1f(offsetI, offset);
+	RenderStatistics::SetUniform(glUniform1f, offsetI, offset);
 
-	glUniform4fv(colorI, 1, color.Get());
+	RenderStatistics::SetUniform(glUniform4fv, colorI, 1, color.Get());
 
 	glDrawArrays(GL_TRIANGLES, 0, 3);
+	RenderStatistics::AddDrawCall(1);
 }
 
 
@@ -0,0 +1,132 @@
+/* RenderStatistics.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "RenderStatistics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+
+using namespace std;
+
+namespace {
+	RenderStatistics::Counts current;
+	RenderStatistics::Counts lastFrame;
+	RenderStatistics::Counts peak;
+	RenderStatistics::Counts total;
+	// The frame number is also read by the threads that draw sprites.
+	atomic<int64_t> frames = 0;
+	int64_t textureMemory = 0;
+}
+
+
+
+// Count a draw call with the given number of triangles.
+void RenderStatistics::AddDrawCall(int64_t triangles) noexcept
+{
+	++current.drawCalls;
+	current.triangles += triangles;
+}
+
+
+
+void RenderStatistics::AddTextureBinds(int64_t count) noexcept
+{
+	current.textureBinds += count;
+}
+
+
+
+void RenderStatistics::AddUniformUpdates(int64_t count) noexcept
+{
+	current.uniformUpdates += count;
+}
+
+
+
+// Count data being uploaded to a buffer or a texture.
+void RenderStatistics::AddUpload(int64_t bytes) noexcept
+{
+	++current.bufferUploads;
+	current.uploadedBytes += bytes;
+}
+
+
+
+void RenderStatistics::AddTextureMemory(int64_t bytes) noexcept
+{
+	textureMemory += bytes;
+}
+
+
+
+void RenderStatistics::RemoveTextureMemory(int64_t bytes) noexcept
+{
+	textureMemory -= bytes;
+}
+
+
+
+// Finish counting the current frame.
+void RenderStatistics::EndFrame() noexcept
+{
+	lastFrame = current;
+	current = Counts();
+	frames.fetch_add(1, memory_order_relaxed);
+
+	for(int64_t Counts::*count : {&Counts::drawCalls, &Counts::triangles, &Counts::textureBinds,
+			&Counts::uniformUpdates, &Counts::bufferUploads, &Counts::uploadedBytes})
+	{
+		peak.*count = max(peak.*count, lastFrame.*count);
+		total.*count += lastFrame.*count;
+	}
+}
+
+
+
+const RenderStatistics::Counts &RenderStatistics::LastFrame() noexcept
+{
+	return lastFrame;
+}
+
+
+
+// Get the largest count of each kind in any one frame.
+const RenderStatistics::Counts &RenderStatistics::Peak() noexcept
+{
+	return peak;
+}
+
+
+
+const RenderStatistics::Counts &RenderStatistics::Total() noexcept
+{
+	return total;
+}
+
+
+
+int64_t RenderStatistics::Frames() noexcept
+{
+	return frames.load(memory_order_relaxed);
+}
+
+
+
+int64_t RenderStatistics::TextureMemory() noexcept
+{
+	return textureMemory;
+}
@@ -0,0 +1,78 @@
+/* RenderStatistics.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+
+
+// Counts of how much work is given to the GPU while drawing: how many draw
+// calls are made, how many triangles they draw, and how often textures,
+// uniforms and buffers are changed. The counts for the frame being drawn are
+// added up until EndFrame() is called, and then kept as the counts for the
+// last frame as well as being added to the totals since the game started.
+// This also tracks how much texture memory is currently in use by sprites.
+// All of these functions must only be called from the thread that draws.
+class RenderStatistics {
+public:
+	class Counts {
+	public:
+		int64_t drawCalls = 0;
+		int64_t triangles = 0;
+		int64_t textureBinds = 0;
+		int64_t uniformUpdates = 0;
+		int64_t bufferUploads = 0;
+		int64_t uploadedBytes = 0;
+	};
+
+
+public:
+	// Count a draw call with the given number of triangles.
+	static void AddDrawCall(int64_t triangles) noexcept;
+	static void AddTextureBinds(int64_t count = 1) noexcept;
+	static void AddUniformUpdates(int64_t count) noexcept;
+	// Set a uniform by calling the given glUniform function with the given
+	// arguments, and count it as a uniform update.
+	template<class Function, class ...Args>
+	static void SetUniform(Function function, Args ...args);
+	// Count data being uploaded to a buffer or a texture.
+	static void AddUpload(int64_t bytes) noexcept;
+	// Keep track of the memory used by sprite textures as they are uploaded
+	// and unloaded.
+	static void AddTextureMemory(int64_t bytes) noexcept;
+	static void RemoveTextureMemory(int64_t bytes) noexcept;
+
+	// Finish counting the current frame.
+	static void EndFrame() noexcept;
+
+	static const Counts &LastFrame() noexcept;
+	// Get the largest count of each kind in any one frame.
+	static const Counts &Peak() noexcept;
+	static const Counts &Total() noexcept;
+	// Get the number of frames that have been finished. This may be called from any thread.
+	static int64_t Frames() noexcept;
+	static int64_t TextureMemory() noexcept;
+};
+
+
+
+template<class Function, class ...Args>
+void RenderStatistics::SetUniform(Function function, Args ...args)
+{
+	function(args...);
+	AddUniformUpdates(1);
+}
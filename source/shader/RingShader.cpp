@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../GameData.h"
 #include "../pi.h"
 #include "../Point.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 
@@ -130,7 +131,7 @@ void RingShader::Bind()
 	}
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 }
 
 
@@ -147,17 +148,18 @@ void RingShader::Add(const Point &pos, float radius, float width, float fraction
 	const Color &color, float dash, float startAngle)
 {
 	GLfloat position[2] = {static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
+	RenderStatistics::SetUniform(glUniform2fv, positionI, 1, position);
 
-	glUniform1f(radiusI, radius);
-	glUniform1f(widthI, width);
-	glUniform1f(angleI, fraction * 2. * PI);
-	glUniform1f(startAngleI, startAngle * TO_RAD);
-	glUniform1f(dashI, dash ? 2. * PI / dash : 0.);
+	RenderStatistics::SetUniform(glUniform1f, radiusI, radius);
+	RenderStatistics::SetUniform(glUniform1f, widthI, width);
+	RenderStatistics::SetUniform(glUniform1f, angleI, fraction * 2. * PI);
+	RenderStatistics::SetUniform(glUniform1f, startAngleI, startAngle * TO_RAD);
+	RenderStatistics::SetUniform(glUniform1f, dashI, dash ? 2. * PI / dash : 0.);
 
-	glUniform4fv(colorI, 1, color.Get());
+	RenderStatistics::SetUniform(glUniform4fv, colorI, 1, color.Get());
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderStatistics::AddDrawCall(2);
 }
 
 
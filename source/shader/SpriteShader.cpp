@@ -16,11 +16,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteShader.h"
 
 #include "../GameData.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "Shader.h"
 #include "../image/Sprite.h"
 #include "../Swizzle.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
 using namespace std;
 
 namespace {
@@ -37,6 +42,7 @@ namespace {
 	GLint blurI;
 	GLint clipI;
 	GLint alphaI;
+	GLint texRectI;
 	GLint swizzleMatrixI;
 	GLint useSwizzleI;
 
@@ -50,6 +56,162 @@ namespace {
 		glEnableVertexAttribArray(vertI);
 		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 	}
+
+	// The instanced shader draws many copies of the sprite quad at once, each
+	// with its own position, transform, etc. It is only available if the
+	// OpenGL version supports instanced vertex attributes.
+	const Shader *instancedShader = nullptr;
+	GLint instancedScaleI;
+	GLint instancedTexI;
+	GLint instancedSwizzleMaskI;
+	GLint instancedUseSwizzleMaskI;
+	GLint instancedFrameCountI;
+	GLint instancedUniqueSwizzleMaskFramesI;
+	GLint instancedSwizzleMatrixI;
+	GLint instancedUseSwizzleI;
+
+	GLint instancedVertI;
+	GLint instancedPositionI;
+	GLint instancedTransformI;
+	GLint instancedBlurI;
+	GLint instancedFrameI;
+	GLint instancedClipI;
+	GLint instancedAlphaI;
+	GLint instancedTexRectI;
+
+	GLuint instancedVao;
+	GLuint instanceVbo;
+	size_t instanceCapacity = 0;
+
+	// The attributes of one item that are passed to the instanced shader.
+	class Instance {
+	public:
+		float position[2];
+		float transform[4];
+		float blur[2];
+		float frame;
+		float clip;
+		float alpha;
+		float texRect[4];
+	};
+
+	// A group of items that use the same textures and swizzle, and so can be
+	// drawn with a single draw call.
+	class Run {
+	public:
+		const SpriteShader::Item *first = nullptr;
+		// The screen area that the items in this run may cover.
+		float left = 0.f;
+		float top = 0.f;
+		float right = 0.f;
+		float bottom = 0.f;
+		size_t count = 0;
+		size_t offset = 0;
+	};
+
+	// How many runs an item may be moved back past to join a run that it can
+	// be drawn with. This keeps the cost of grouping the items linear.
+	const size_t MAX_LOOK_BACK = 32;
+
+	// These are reused from one frame to the next, to avoid reallocating them.
+	vector<Run> runs;
+	vector<size_t> itemRuns;
+	vector<Instance> instances;
+
+
+	bool CanDrawTogether(const SpriteShader::Item &a, const SpriteShader::Item &b)
+	{
+		return a.texture == b.texture && a.swizzleMask == b.swizzleMask && a.swizzle == b.swizzle
+			&& a.frameCount == b.frameCount && a.uniqueSwizzleMaskFrames == b.uniqueSwizzleMaskFrames;
+	}
+
+
+	// Start a run containing only the given item. Its screen area is found the
+	// same way that the vertex shader finds the corners of the sprite.
+	Run StartRun(const SpriteShader::Item &item, const float blur[2])
+	{
+		float width = .5f + abs(blur[0]);
+		float height = .5f + abs(blur[1]);
+		float x = width * abs(item.transform[0]) + height * abs(item.transform[2]);
+		float y = width * abs(item.transform[1]) + height * abs(item.transform[3]);
+
+		Run bounds;
+		bounds.first = &item;
+		bounds.left = item.position[0] - x;
+		bounds.top = item.position[1] - y;
+		bounds.right = item.position[0] + x;
+		bounds.bottom = item.position[1] + y;
+		return bounds;
+	}
+
+
+	void SetInstanceAttribs(size_t offset)
+	{
+		const char *base = reinterpret_cast<const char *>(offset * sizeof(Instance));
+		glVertexAttribPointer(instancedPositionI, 2, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			base + offsetof(Instance, position));
+		glVertexAttribPointer(instancedTransformI, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			base + offsetof(Instance, transform));
+		glVertexAttribPointer(instancedBlurI, 2, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			base + offsetof(Instance, blur));
+		glVertexAttribPointer(instancedFrameI, 1, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			base + offsetof(Instance, frame));
+		glVertexAttribPointer(instancedClipI, 1, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			base + offsetof(Instance, clip));
+		glVertexAttribPointer(instancedAlphaI, 1, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			base + offsetof(Instance, alpha));
+		glVertexAttribPointer(instancedTexRectI, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			base + offsetof(Instance, texRect));
+	}
+
+
+	void InitInstanced()
+	{
+		instancedShader = GameData::Shaders().Get("spriteInstanced");
+		if(!OpenGL::HasInstancingSupport() || !instancedShader->Object())
+		{
+			instancedShader = nullptr;
+			return;
+		}
+		instancedScaleI = instancedShader->Uniform("scale");
+		instancedTexI = instancedShader->Uniform("tex");
+		instancedSwizzleMaskI = instancedShader->Uniform("swizzleMask");
+		instancedUseSwizzleMaskI = instancedShader->Uniform("useSwizzleMask");
+		instancedFrameCountI = instancedShader->Uniform("frameCount");
+		instancedUniqueSwizzleMaskFramesI = instancedShader->Uniform("uniqueSwizzleMaskFrames");
+		instancedSwizzleMatrixI = instancedShader->Uniform("swizzleMatrix");
+		instancedUseSwizzleI = instancedShader->Uniform("useSwizzle");
+		instancedVertI = instancedShader->Attrib("vert");
+		instancedPositionI = instancedShader->Attrib("position");
+		instancedTransformI = instancedShader->Attrib("transform");
+		instancedBlurI = instancedShader->Attrib("blur");
+		instancedFrameI = instancedShader->Attrib("frame");
+		instancedClipI = instancedShader->Attrib("clip");
+		instancedAlphaI = instancedShader->Attrib("alpha");
+		instancedTexRectI = instancedShader->Attrib("texRect");
+
+		glGenVertexArrays(1, &instancedVao);
+		glBindVertexArray(instancedVao);
+
+		// The corners of the quad are shared by every instance.
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glEnableVertexAttribArray(instancedVertI);
+		glVertexAttribPointer(instancedVertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+		// Everything else advances once per instance.
+		glGenBuffers(1, &instanceVbo);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		for(GLint attrib : {instancedPositionI, instancedTransformI, instancedBlurI, instancedFrameI,
+				instancedClipI, instancedAlphaI, instancedTexRectI})
+		{
+			glEnableVertexAttribArray(attrib);
+			glVertexAttribDivisor(attrib, 1);
+		}
+		SetInstanceAttribs(0);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
 }
 
 // Initialize the shaders.
@@ -68,6 +230,7 @@ void SpriteShader::Init()
 	blurI = shader->Uniform("blur");
 	clipI = shader->Uniform("clip");
 	alphaI = shader->Uniform("alpha");
+	texRectI = shader->Uniform("texRect");
 	swizzleMatrixI = shader->Uniform("swizzleMatrix");
 	swizzleMaskI = shader->Uniform("swizzleMask");
 	useSwizzleMaskI = shader->Uniform("useSwizzleMask");
@@ -99,6 +262,8 @@ void SpriteShader::Init()
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
+
+	InitInstanced();
 }
 
 
@@ -125,6 +290,7 @@ SpriteShader::Item SpriteShader::Prepare(const Sprite *sprite, const Point &posi
 	Item item;
 	item.texture = sprite->Texture();
 	item.swizzleMask = sprite->SwizzleMask();
+	copy_n(sprite->TextureRect(), 4, item.texRect);
 	item.frame = frame;
 	item.frameCount = sprite->Frames();
 	item.uniqueSwizzleMaskFrames = sprite->SwizzleMaskFrames() > 1;
@@ -159,7 +325,7 @@ void SpriteShader::Bind()
 	}
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 }
 
 
@@ -168,18 +334,18 @@ void SpriteShader::Add(const Item &item, bool withBlur)
 {
 	if(item.swizzle)
 	{
-		glUniform1i(swizzleMaskI, 1);
+		RenderStatistics::SetUniform(glUniform1i, swizzleMaskI, 1);
 		// Don't mask full color swizzles that always apply to the whole ship sprite.
-		glUniform1i(useSwizzleMaskI, item.swizzle->OverrideMask() ? 0 : item.swizzleMask);
+		RenderStatistics::SetUniform(glUniform1i, useSwizzleMaskI, item.swizzle->OverrideMask() ? 0 : item.swizzleMask);
 
 		// Set the color swizzle.
-		glUniformMatrix4fv(swizzleMatrixI, 1, GL_FALSE, item.swizzle->MatrixPtr());
-		glUniform1i(useSwizzleI, !item.swizzle->IsIdentity());
+		RenderStatistics::SetUniform(glUniformMatrix4fv, swizzleMatrixI, 1, GL_FALSE, item.swizzle->MatrixPtr());
+		RenderStatistics::SetUniform(glUniform1i, useSwizzleI, !item.swizzle->IsIdentity());
 	}
 	else
-		glUniform1i(useSwizzleI, 0);
+		RenderStatistics::SetUniform(glUniform1i, useSwizzleI, 0);
 
-	glUniform1i(texI, 0);
+	RenderStatistics::SetUniform(glUniform1i, texI, 0);
 	int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
 	glBindTexture(type, item.texture);
 
@@ -187,18 +353,21 @@ void SpriteShader::Add(const Item &item, bool withBlur)
 	glBindTexture(type, item.swizzleMask);
 	glActiveTexture(GL_TEXTURE0);
 
-	glUniform1f(frameI, item.frame);
-	glUniform1f(frameCountI, item.frameCount);
-	glUniform1i(uniqueSwizzleMaskFramesI, item.uniqueSwizzleMaskFrames);
-	glUniform2fv(positionI, 1, item.position);
-	glUniformMatrix2fv(transformI, 1, false, item.transform);
+	RenderStatistics::SetUniform(glUniform1f, frameI, item.frame);
+	RenderStatistics::SetUniform(glUniform1f, frameCountI, item.frameCount);
+	RenderStatistics::SetUniform(glUniform1i, uniqueSwizzleMaskFramesI, item.uniqueSwizzleMaskFrames);
+	RenderStatistics::SetUniform(glUniform2fv, positionI, 1, item.position);
+	RenderStatistics::SetUniform(glUniformMatrix2fv, transformI, 1, false, item.transform);
 	// Special case: check if the blur should be applied or not.
 	static const float UNBLURRED[2] = {0.f, 0.f};
-	glUniform2fv(blurI, 1, withBlur ? item.blur : UNBLURRED);
-	glUniform1f(clipI, item.clip);
-	glUniform1f(alphaI, item.alpha);
+	RenderStatistics::SetUniform(glUniform2fv, blurI, 1, withBlur ? item.blur : UNBLURRED);
+	RenderStatistics::SetUniform(glUniform1f, clipI, item.clip);
+	RenderStatistics::SetUniform(glUniform1f, alphaI, item.alpha);
+	RenderStatistics::SetUniform(glUniform4fv, texRectI, 1, item.texRect);
+	RenderStatistics::AddTextureBinds(2);
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderStatistics::AddDrawCall(2);
 }
 
 
@@ -206,7 +375,7 @@ void SpriteShader::Add(const Item &item, bool withBlur)
 void SpriteShader::Unbind()
 {
 	// Reset the swizzle.
-	glUniform1i(useSwizzleI, 0);
+	RenderStatistics::SetUniform(glUniform1i, useSwizzleI, 0);
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
@@ -217,3 +386,133 @@ void SpriteShader::Unbind()
 	}
 	glUseProgram(0);
 }
+
+
+
+// Draw all the given items, in order, combining them into as few draw calls as possible.
+void SpriteShader::Draw(const vector<Item> &items, bool withBlur)
+{
+	if(!instancedShader)
+	{
+		Bind();
+		for(const Item &item : items)
+			Add(item, withBlur);
+		Unbind();
+		return;
+	}
+	if(items.empty())
+		return;
+
+	// Group the items into runs that can be drawn together. An item can only
+	// be moved back to join an earlier run if it does not overlap anything that
+	// was going to be drawn between that run and the item.
+	static const float UNBLURRED[2] = {0.f, 0.f};
+	runs.clear();
+	itemRuns.clear();
+	for(const Item &item : items)
+	{
+		Run bounds = StartRun(item, withBlur ? item.blur : UNBLURRED);
+		size_t index = runs.size();
+		size_t stop = runs.size() - min(runs.size(), MAX_LOOK_BACK);
+		for(size_t i = runs.size(); i-- > stop; )
+		{
+			const Run &run = runs[i];
+			if(CanDrawTogether(*run.first, item))
+			{
+				index = i;
+				break;
+			}
+			if(bounds.left < run.right && bounds.right > run.left && bounds.top < run.bottom && bounds.bottom > run.top)
+				break;
+		}
+
+		if(index == runs.size())
+			runs.push_back(bounds);
+		else
+		{
+			Run &run = runs[index];
+			run.left = min(run.left, bounds.left);
+			run.top = min(run.top, bounds.top);
+			run.right = max(run.right, bounds.right);
+			run.bottom = max(run.bottom, bounds.bottom);
+		}
+		++runs[index].count;
+		itemRuns.push_back(index);
+	}
+
+	// Lay out the attributes of every item, run by run, keeping the items in
+	// each run in their original order.
+	size_t offset = 0;
+	for(Run &run : runs)
+	{
+		run.offset = offset;
+		offset += run.count;
+		run.count = 0;
+	}
+	instances.resize(items.size());
+	for(size_t i = 0; i < items.size(); ++i)
+	{
+		const Item &item = items[i];
+		Run &run = runs[itemRuns[i]];
+		Instance &instance = instances[run.offset + run.count++];
+		copy(item.position, item.position + 2, instance.position);
+		copy(item.transform, item.transform + 4, instance.transform);
+		const float *blur = withBlur ? item.blur : UNBLURRED;
+		copy(blur, blur + 2, instance.blur);
+		instance.frame = item.frame;
+		instance.clip = item.clip;
+		instance.alpha = item.alpha;
+		copy(item.texRect, item.texRect + 4, instance.texRect);
+	}
+
+	glUseProgram(instancedShader->Object());
+	glBindVertexArray(instancedVao);
+
+	// Upload all the instances at once. Orphaning the buffer first means the
+	// driver does not need to wait for any draws still using its old contents.
+	size_t size = instances.size() * sizeof(Instance);
+	instanceCapacity = max(size, instanceCapacity);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, instances.data());
+	RenderStatistics::AddUpload(size);
+
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	RenderStatistics::SetUniform(glUniform2fv, instancedScaleI, 1, scale);
+	RenderStatistics::SetUniform(glUniform1i, instancedTexI, 0);
+	RenderStatistics::SetUniform(glUniform1i, instancedSwizzleMaskI, 1);
+
+	int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
+	for(const Run &run : runs)
+	{
+		const Item &item = *run.first;
+		if(item.swizzle)
+		{
+			// Don't mask full color swizzles that always apply to the whole ship sprite.
+			RenderStatistics::SetUniform(glUniform1i, instancedUseSwizzleMaskI,
+				item.swizzle->OverrideMask() ? 0 : item.swizzleMask);
+			RenderStatistics::SetUniform(glUniformMatrix4fv, instancedSwizzleMatrixI, 1, GL_FALSE,
+				item.swizzle->MatrixPtr());
+			RenderStatistics::SetUniform(glUniform1i, instancedUseSwizzleI, !item.swizzle->IsIdentity());
+		}
+		else
+			RenderStatistics::SetUniform(glUniform1i, instancedUseSwizzleI, 0);
+
+		glBindTexture(type, item.texture);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(type, item.swizzleMask);
+		glActiveTexture(GL_TEXTURE0);
+
+		RenderStatistics::SetUniform(glUniform1f, instancedFrameCountI, item.frameCount);
+		RenderStatistics::SetUniform(glUniform1i, instancedUniqueSwizzleMaskFramesI, item.uniqueSwizzleMaskFrames);
+		RenderStatistics::AddTextureBinds(2);
+
+		SetInstanceAttribs(run.offset);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(run.count));
+		RenderStatistics::AddDrawCall(2 * run.count);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
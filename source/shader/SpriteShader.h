@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Swizzle.h"
 
 #include <cstdint>
+#include <vector>
 
 class Sprite;
 
@@ -35,6 +36,8 @@ public:
 	public:
 		uint32_t texture = 0;
 		uint32_t swizzleMask = 0;
+		// The part of the texture that the sprite covers, if it shares it.
+		float texRect[4] = {0.f, 0.f, 1.f, 1.f};
 		const Swizzle *swizzle = nullptr;
 		float frame = 0.f;
 		float frameCount = 1.f;
@@ -63,4 +66,10 @@ public:
 	static void Bind();
 	static void Add(const Item &item, bool withBlur = false);
 	static void Unbind();
+
+	// Draw all the given items, in order. Where instanced drawing is supported,
+	// items that use the same textures and swizzle are drawn together, as long
+	// as that does not change how any items that overlap are layered. That
+	// includes different sprites that were packed into the same texture.
+	static void Draw(const std::vector<Item> &items, bool withBlur = false);
 };
@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../pi.h"
 #include "../Preferences.h"
 #include "../Random.h"
+#include "RenderStatistics.h"
 #include "../Screen.h"
 #include "../image/Sprite.h"
 #include "../image/SpriteSet.h"
@@ -30,7 +31,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
-#include <numeric>
 
 using namespace std;
 
@@ -51,6 +51,19 @@ namespace {
 	const double STAR_ZOOM = 0.70;
 	const double HAZE_ZOOM = 0.90;
 
+	// Each star is drawn as two triangles. Each of their corners is an angle
+	// around the star's center.
+	const float CORNERS[6] = {
+		static_cast<float>(0. * PI),
+		static_cast<float>(.5 * PI),
+		static_cast<float>(1.5 * PI),
+		static_cast<float>(.5 * PI),
+		static_cast<float>(1.5 * PI),
+		static_cast<float>(1. * PI)
+	};
+	// Each star has a position, a size, and an index and count for its tile.
+	const int FLOATS_PER_STAR = 5;
+
 	void AddHaze(DrawList &drawList, const vector<Body> &haze,
 		const Point &topLeft, const Point &bottomRight, double transparency)
 	{
@@ -206,6 +219,10 @@ void StarField::Draw(const Point &blur, const System *system) const
 			EnableAttribArrays();
 		}
 
+		const int width = widthMod + 1;
+		RenderStatistics::SetUniform(glUniform1f, periodI, width);
+		RenderStatistics::SetUniform(glUniform1f, densityI, density);
+		RenderStatistics::SetUniform(glUniform1f, layersI, layers);
 		for(int pass = 1; pass <= layers; pass++)
 		{
 			// Modify zoom for the first parallax layer.
@@ -220,15 +237,16 @@ void StarField::Draw(const Point &blur, const System *system) const
 
 			float baseZoom = static_cast<float>(2. * zoom);
 			GLfloat scale[2] = {baseZoom / Screen::Width(), -baseZoom / Screen::Height()};
-			glUniform2fv(scaleI, 1, scale);
+			RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
 
 			GLfloat rotate[4] = {
 				static_cast<float>(unit.Y()), static_cast<float>(-unit.X()),
 				static_cast<float>(unit.X()), static_cast<float>(unit.Y())};
-			glUniformMatrix2fv(rotateI, 1, false, rotate);
+			RenderStatistics::SetUniform(glUniformMatrix2fv, rotateI, 1, false, rotate);
 
-			glUniform1f(elongationI, length * zoom);
-			glUniform1f(brightnessI, min(1., pow(zoom, .5)));
+			RenderStatistics::SetUniform(glUniform1f, elongationI, length * zoom);
+			RenderStatistics::SetUniform(glUniform1f, brightnessI, min(1., pow(zoom, .5)));
+			RenderStatistics::SetUniform(glUniform1f, passI, pass);
 
 			// Stars this far beyond the border may still overlap the screen.
 			double borderX = fabs(blur.X()) + 1.;
@@ -242,23 +260,26 @@ void StarField::Draw(const Point &blur, const System *system) const
 			minX &= ~(TILE_SIZE - 1l);
 			minY &= ~(TILE_SIZE - 1l);
 
-			for(int gy = minY; gy < maxY; gy += TILE_SIZE)
-			{
-				for(int gx = minX; gx < maxX; gx += TILE_SIZE)
+			// Draw as many copies of the whole pattern as it takes to cover those
+			// bounds. Each copy starts at the same point within the pattern.
+			GLfloat start[2] = {static_cast<float>(minX & widthMod), static_cast<float>(minY & widthMod)};
+			RenderStatistics::SetUniform(glUniform2fv, startI, 1, start);
+			for(int gy = minY; gy < maxY; gy += width)
+				for(int gx = minX; gx < maxX; gx += width)
 				{
 					Point off = Point(gx, gy) - pos;
 					GLfloat translate[2] = {
 						static_cast<float>(off.X()),
 						static_cast<float>(off.Y())
 					};
-					glUniform2fv(translateI, 1, translate);
+					RenderStatistics::SetUniform(glUniform2fv, translateI, 1, translate);
 
-					int index = (gx & widthMod) / TILE_SIZE + ((gy & widthMod) / TILE_SIZE) * tileCols;
-					int first = tileIndex[index];
-					int count = (tileIndex[index + 1] - first) * density / layers;
-					glDrawArrays(GL_TRIANGLES, 6 * (first + (pass - 1) * count), 6 * (count / pass));
+					if(isInstanced)
+						glDrawArraysInstanced(GL_TRIANGLES, 0, 6, stars);
+					else
+						glDrawArrays(GL_TRIANGLES, 0, 6 * stars);
+					RenderStatistics::AddDrawCall(2 * stars);
 				}
-			}
 		}
 		if(OpenGL::HasVaoSupport())
 			glBindVertexArray(0);
@@ -267,6 +288,7 @@ void StarField::Draw(const Point &blur, const System *system) const
 			glDisableVertexAttribArray(offsetI);
 			glDisableVertexAttribArray(sizeI);
 			glDisableVertexAttribArray(cornerI);
+			glDisableVertexAttribArray(tileI);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		}
 		glUseProgram(0);
@@ -305,8 +327,9 @@ void StarField::Draw(const Point &blur, const System *system) const
 
 void StarField::EnableAttribArrays() const
 {
-	// Connect the xy to the "vert" attribute of the vertex shader.
-	constexpr auto stride = 4 * sizeof(GLfloat);
+	// Each star's position, size, and place within its tile are either given
+	// once per instance, or repeated along with each of its corners.
+	const GLsizei stride = (FLOATS_PER_STAR + !isInstanced) * sizeof(GLfloat);
 	glEnableVertexAttribArray(offsetI);
 	glVertexAttribPointer(offsetI, 2, GL_FLOAT, GL_FALSE,
 		stride, nullptr);
@@ -315,9 +338,25 @@ void StarField::EnableAttribArrays() const
 	glVertexAttribPointer(sizeI, 1, GL_FLOAT, GL_FALSE,
 		stride, reinterpret_cast<const GLvoid *>(2 * sizeof(GLfloat)));
 
-	glEnableVertexAttribArray(cornerI);
-	glVertexAttribPointer(cornerI, 1, GL_FLOAT, GL_FALSE,
+	glEnableVertexAttribArray(tileI);
+	glVertexAttribPointer(tileI, 2, GL_FLOAT, GL_FALSE,
 		stride, reinterpret_cast<const GLvoid *>(3 * sizeof(GLfloat)));
+
+	glEnableVertexAttribArray(cornerI);
+	if(isInstanced)
+	{
+		glVertexAttribDivisor(offsetI, 1);
+		glVertexAttribDivisor(sizeI, 1);
+		glVertexAttribDivisor(tileI, 1);
+
+		glBindBuffer(GL_ARRAY_BUFFER, cornerVbo);
+		glVertexAttribPointer(cornerI, 1, GL_FLOAT, GL_FALSE,
+			sizeof(GLfloat), nullptr);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	}
+	else
+		glVertexAttribPointer(cornerI, 1, GL_FLOAT, GL_FALSE,
+			stride, reinterpret_cast<const GLvoid *>(FLOATS_PER_STAR * sizeof(GLfloat)));
 }
 
 
@@ -335,6 +374,15 @@ void StarField::SetUpGraphics()
 		glBindVertexArray(vao);
 	}
 
+	// Instancing needs the corners to be in a buffer of their own.
+	isInstanced = OpenGL::HasInstancingSupport();
+	if(isInstanced)
+	{
+		glGenBuffers(1, &cornerVbo);
+		glBindBuffer(GL_ARRAY_BUFFER, cornerVbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(CORNERS), CORNERS, GL_STATIC_DRAW);
+	}
+
 	// make and bind the VBO
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -342,12 +390,18 @@ void StarField::SetUpGraphics()
 	offsetI = shader->Attrib("offset");
 	sizeI = shader->Attrib("size");
 	cornerI = shader->Attrib("corner");
+	tileI = shader->Attrib("tile");
 
 	scaleI = shader->Uniform("scale");
 	rotateI = shader->Uniform("rotate");
 	elongationI = shader->Uniform("elongation");
 	translateI = shader->Uniform("translate");
 	brightnessI = shader->Uniform("brightness");
+	periodI = shader->Uniform("period");
+	startI = shader->Uniform("start");
+	densityI = shader->Uniform("density");
+	layersI = shader->Uniform("layers");
+	passI = shader->Uniform("pass");
 }
 
 
@@ -359,10 +413,10 @@ void StarField::MakeStars(int stars, int width)
 		return;
 
 	widthMod = width - 1;
+	this->stars = stars;
 
-	tileCols = (width / TILE_SIZE);
-	tileIndex.clear();
-	tileIndex.resize(static_cast<size_t>(tileCols) * tileCols, 0);
+	int tileCols = (width / TILE_SIZE);
+	vector<int> tileCount(static_cast<size_t>(tileCols) * tileCols, 0);
 
 	vector<int> off;
 	static const int MAX_OFF = 50;
@@ -380,10 +434,10 @@ void StarField::MakeStars(int stars, int width)
 			off.push_back(y);
 		}
 
-	// Generate random points in a temporary vector.
-	// Keep track of how many fall into each tile, for sorting out later.
+	// Generate random points in a temporary vector. Keep track of how many fall
+	// into each tile, and which of those stars each one is.
 	vector<int> temp;
-	temp.reserve(2 * stars);
+	temp.reserve(3 * stars);
 
 	int x = Random::Int(width);
 	int y = Random::Int(width);
@@ -397,53 +451,39 @@ void StarField::MakeStars(int stars, int width)
 			x &= widthMod;
 			y &= widthMod;
 		}
+		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
 		temp.push_back(x);
 		temp.push_back(y);
-		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
-		++tileIndex[index];
+		temp.push_back(tileCount[index]++);
 	}
 
-	// Accumulate item counts so that tileIndex[i] is the index in the array of
-	// the first star that falls within tile i, and tileIndex.back() == stars.
-	tileIndex.insert(tileIndex.begin(), 0);
-	tileIndex.pop_back();
-	partial_sum(tileIndex.begin(), tileIndex.end(), tileIndex.begin());
-
-	// Each star consists of six vertices, each with four data elements.
-	vector<GLfloat> data(6 * 4 * stars, 0.f);
+	// Each star has the same data for each of its six vertices, unless they are
+	// instances of the same six corners.
+	const int copies = isInstanced ? 1 : 6;
+	vector<GLfloat> data;
+	data.reserve(copies * (FLOATS_PER_STAR + !isInstanced) * stars);
 	for(auto it = temp.begin(); it != temp.end(); )
 	{
 		// Figure out what tile this star is in.
 		int x = *it++;
 		int y = *it++;
+		int rank = *it++;
 		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
 
 		// Randomize its sub-pixel position and its size / brightness.
 		int random = Random::Int(4096);
-		float fx = (x & (TILE_SIZE - 1)) + (random & 15) * 0.0625f;
-		float fy = (y & (TILE_SIZE - 1)) + (random >> 8) * 0.0625f;
+		float fx = x + (random & 15) * 0.0625f;
+		float fy = y + (random >> 8) * 0.0625f;
 		float size = (((random >> 4) & 15) + 20) * 0.0625f;
 
 		// Fill in the data array.
-		auto dataIt = data.begin() + 6 * 4 * tileIndex[index]++;
-		const float CORNER[6] = {
-			static_cast<float>(0. * PI),
-			static_cast<float>(.5 * PI),
-			static_cast<float>(1.5 * PI),
-			static_cast<float>(.5 * PI),
-			static_cast<float>(1.5 * PI),
-			static_cast<float>(1. * PI)
-		};
-		for(float corner : CORNER)
+		for(int i = 0; i < copies; ++i)
 		{
-			*dataIt++ = fx;
-			*dataIt++ = fy;
-			*dataIt++ = size;
-			*dataIt++ = corner;
+			data.insert(data.end(), {fx, fy, size, static_cast<float>(rank), static_cast<float>(tileCount[index])});
+			if(!isInstanced)
+				data.push_back(CORNERS[i]);
 		}
 	}
-	// Adjust the tile indices so that tileIndex[i] is the start of tile i.
-	tileIndex.insert(tileIndex.begin(), 0);
 
 	glBufferData(GL_ARRAY_BUFFER, sizeof(data.front()) * data.size(), data.data(), GL_STATIC_DRAW);
 
@@ -34,7 +34,9 @@ class System;
 // so that some parts will be much denser than others, which is visually more
 // interesting than if the stars were evenly spread out in perfectly random
 // noise. If the view is moving, the stars are elongated in a motion blur to
-// match the motion; otherwise they would seem to jitter around.
+// match the motion; otherwise they would seem to jitter around. Each star knows
+// which tile of the pattern it is in, so the vertex shader decides which stars
+// to draw for each parallax layer, and the whole pattern is drawn at once.
 class StarField {
 public:
 	void Init(int stars, int width);
@@ -55,8 +57,7 @@ private:
 
 private:
 	int widthMod;
-	int tileCols;
-	std::vector<int> tileIndex;
+	int stars = 0;
 
 	// Constants from an Interface that modify the starfield's behavior.
 	double fixedZoom = 1.;
@@ -77,14 +78,24 @@ private:
 	const Shader *shader;
 	GLuint vao;
 	GLuint vbo;
+	// If instancing is supported, each star is drawn as an instance of these
+	// corners. Otherwise, every star has its own copy of them.
+	GLuint cornerVbo;
+	bool isInstanced = false;
 
 	GLuint offsetI;
 	GLuint sizeI;
 	GLuint cornerI;
+	GLuint tileI;
 
 	GLuint scaleI;
 	GLuint rotateI;
 	GLuint elongationI;
 	GLuint translateI;
 	GLuint brightnessI;
+	GLuint periodI;
+	GLuint startI;
+	GLuint densityI;
+	GLuint layersI;
+	GLuint passI;
 };
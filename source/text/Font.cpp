@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../image/ImageFileData.h"
 #include "../Point.h"
 #include "../Preferences.h"
+#include "../shader/RenderStatistics.h"
 #include "../Screen.h"
 #include "Truncate.h"
 
@@ -37,20 +38,49 @@ namespace {
 	bool showUnderlines = false;
 	const int KERN = 2;
 
-	/// Shared VAO and VBO quad (0,0) -> (1,1)
+	// Each glyph is drawn as two triangles, and each of their corners has an
+	// (x, y) position and (s, t) texture coordinates.
+	const int FLOATS_PER_VERTEX = 4;
+	const GLfloat CORNERS[6][2] = {{0.f, 0.f}, {0.f, 1.f}, {1.f, 0.f}, {1.f, 0.f}, {0.f, 1.f}, {1.f, 1.f}};
+	// Once this many strings have been cached, the cache is started over.
+	const size_t MAX_CACHED_STRINGS = 2000;
+	// The vertex buffer is never made smaller than this, in bytes.
+	const size_t MIN_BUFFER_SIZE = 1 << 18;
+
+	// Shared VAO and VBO that the glyphs of every string are streamed into.
 	GLuint vao = 0;
 	GLuint vbo = 0;
+	// The size of the buffer's storage, and how much of it has been filled.
+	size_t capacity = 0;
+	size_t used = 0;
 
 	GLint colorI = 0;
 	GLint scaleI = 0;
-	GLint glyphSizeI = 0;
-	GLint glyphI = 0;
-	GLint aspectI = 0;
 	GLint positionI = 0;
 
 	GLint vertI;
 	GLint cornerI;
 
+	// Copy glyph vertices into the vertex buffer after the ones that were drawn
+	// before them, and return the index of the first one. Only once the buffer
+	// is full are its old contents orphaned, so the driver does not need to wait
+	// for earlier draw calls that are still using them.
+	GLint Stream(const GLfloat *data, size_t count)
+	{
+		size_t size = count * sizeof(GLfloat);
+		if(used + size > capacity)
+		{
+			capacity = max({capacity, size, MIN_BUFFER_SIZE});
+			glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+			used = 0;
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, used, size, data);
+		RenderStatistics::AddUpload(size);
+		GLint first = used / (FLOATS_PER_VERTEX * sizeof(GLfloat));
+		used += size;
+		return first;
+	}
+
 	void EnableAttribArrays()
 	{
 		// Connect the xy to the "vert" attribute of the vertex shader.
@@ -80,6 +110,10 @@ void Font::Load(const filesystem::path &imagePath)
 	if(!image.Read(ImageFileData(imagePath)))
 		return;
 
+	// Anything laid out with the old glyphs is no longer valid.
+	glyphCache.clear();
+	truncationCache.clear();
+
 	LoadTexture(image);
 	CalculateAdvances(image);
 	SetUpShader(image.Width() / GLYPHS, image.Height());
@@ -97,17 +131,9 @@ void Font::Draw(const DisplayText &text, const Point &point, const Color &color)
 
 void Font::DrawAliased(const DisplayText &text, double x, double y, const Color &color) const
 {
-	int width = -1;
-	const string truncText = TruncateText(text, width);
-	const auto &layout = text.GetLayout();
-	if(width >= 0)
-	{
-		if(layout.align == Alignment::CENTER)
-			x += (layout.width - width) / 2;
-		else if(layout.align == Alignment::RIGHT)
-			x += layout.width - width;
-	}
-	DrawAliased(truncText, x, y, color);
+	int shift = 0;
+	const string &truncText = Truncated(text, shift);
+	DrawAliased(truncText, x + shift, y, color);
 }
 
 
@@ -121,86 +147,43 @@ void Font::Draw(const string &str, const Point &point, const Color &color) const
 
 void Font::DrawAliased(const string &str, double x, double y, const Color &color) const
 {
-	glUseProgram(shader->Object());
-	glBindTexture(GL_TEXTURE_2D, texture);
-	if(OpenGL::HasVaoSupport())
-		glBindVertexArray(vao);
-	else
-	{
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		EnableAttribArrays();
-	}
-
-	glUniform4fv(colorI, 1, color.Get());
+	const vector<GLfloat> &glyphs = Glyphs(str);
+	DrawGlyphs(glyphs.data(), glyphs.size(), x - 1., y, color);
+}
 
-	// Update the scale, only if the screen size has changed.
-	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
-	{
-		screenWidth = Screen::Width();
-		screenHeight = Screen::Height();
-		scale[0] = 2.f / screenWidth;
-		scale[1] = -2.f / screenHeight;
-	}
-	glUniform2fv(scaleI, 1, scale);
-	glUniform2f(glyphSizeI, glyphWidth, glyphHeight);
 
-	GLfloat textPos[2] = {
-		static_cast<float>(x - 1.),
-		static_cast<float>(y)};
-	int previous = 0;
-	bool isAfterSpace = true;
-	bool underlineChar = false;
-	const int underscoreGlyph = max(0, min(GLYPHS - 1, '_' - 32));
 
-	for(char c : str)
+// Add the glyph quads for drawing the given text at the given point.
+void Font::AddGlyphs(const string &str, const Point &point, vector<GLfloat> &glyphs) const
+{
+	const vector<GLfloat> &cached = Glyphs(str);
+	const GLfloat offset[2] = {
+		static_cast<float>(round(point.X()) - 1.),
+		static_cast<float>(round(point.Y()))};
+	size_t start = glyphs.size();
+	glyphs.insert(glyphs.end(), cached.begin(), cached.end());
+	for(size_t i = start; i < glyphs.size(); i += FLOATS_PER_VERTEX)
 	{
-		if(c == '_')
-		{
-			underlineChar = showUnderlines;
-			continue;
-		}
-
-		int glyph = Glyph(c, isAfterSpace);
-		if(c != '"' && c != '\'')
-			isAfterSpace = !glyph;
-		if(!glyph)
-		{
-			textPos[0] += space;
-			continue;
-		}
-
-		glUniform1i(glyphI, glyph);
-		glUniform1f(aspectI, 1.f);
+		glyphs[i] += offset[0];
+		glyphs[i + 1] += offset[1];
+	}
+}
 
-		textPos[0] += advance[previous * GLYPHS + glyph] + KERN;
-		glUniform2fv(positionI, 1, textPos);
 
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-		if(underlineChar)
-		{
-			glUniform1i(glyphI, underscoreGlyph);
-			glUniform1f(aspectI, static_cast<float>(advance[glyph * GLYPHS] + KERN)
-				/ (advance[underscoreGlyph * GLYPHS] + KERN));
-
-			glUniform2fv(positionI, 1, textPos);
+void Font::AddGlyphs(const DisplayText &text, const Point &point, vector<GLfloat> &glyphs) const
+{
+	int shift = 0;
+	const string &truncText = Truncated(text, shift);
+	AddGlyphs(truncText, Point(round(point.X()) + shift, point.Y()), glyphs);
+}
 
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-			underlineChar = false;
-		}
 
-		previous = glyph;
-	}
 
-	if(OpenGL::HasVaoSupport())
-		glBindVertexArray(0);
-	else
-	{
-		glDisableVertexAttribArray(vertI);
-		glDisableVertexAttribArray(cornerI);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	}
-	glUseProgram(0);
+// Draw a list of glyph quads, offset by the given point.
+void Font::DrawGlyphs(const vector<GLfloat> &glyphs, const Point &point, const Color &color) const
+{
+	DrawGlyphs(glyphs.data(), glyphs.size(), round(point.X()), round(point.Y()), color);
 }
 
 
@@ -242,6 +225,13 @@ void Font::ShowUnderlines(bool show) noexcept
 
 
 
+bool Font::UnderlinesShown() noexcept
+{
+	return showUnderlines;
+}
+
+
+
 int Font::Glyph(char c, bool isAfterSpace) noexcept
 {
 	// Curly quotes.
@@ -346,7 +336,7 @@ void Font::SetUpShader(float glyphW, float glyphH)
 		cornerI = shader->Attrib("corner");
 
 		glUseProgram(shader->Object());
-		glUniform1i(shader->Uniform("tex"), 0);
+		RenderStatistics::SetUniform(glUniform1i, shader->Uniform("tex"), 0);
 		glUseProgram(0);
 
 		// Create the VAO and VBO.
@@ -359,14 +349,6 @@ void Font::SetUpShader(float glyphW, float glyphH)
 		glGenBuffers(1, &vbo);
 		glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-		GLfloat vertices[] = {
-				0.f, 0.f, 0.f, 0.f,
-				0.f, 1.f, 0.f, 1.f,
-				1.f, 0.f, 1.f, 0.f,
-				1.f, 1.f, 1.f, 1.f
-		};
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
 		if(OpenGL::HasVaoSupport())
 			EnableAttribArrays();
 
@@ -376,9 +358,6 @@ void Font::SetUpShader(float glyphW, float glyphH)
 
 		colorI = shader->Uniform("color");
 		scaleI = shader->Uniform("scale");
-		glyphSizeI = shader->Uniform("glyphSize");
-		glyphI = shader->Uniform("glyph");
-		aspectI = shader->Uniform("aspect");
 		positionI = shader->Uniform("position");
 	}
 
@@ -389,6 +368,165 @@ void Font::SetUpShader(float glyphW, float glyphH)
 
 
 
+// Get the glyph quads for drawing the given string, laying them out if this
+// string has not been drawn recently.
+const vector<GLfloat> &Font::Glyphs(const string &str) const
+{
+	// Underlines change which glyphs are drawn, so the cache is only good for
+	// as long as they are either shown or hidden.
+	if(cacheUnderlines != showUnderlines)
+	{
+		glyphCache.clear();
+		cacheUnderlines = showUnderlines;
+	}
+
+	auto it = glyphCache.find(str);
+	if(it != glyphCache.end())
+		return it->second;
+
+	if(glyphCache.size() >= MAX_CACHED_STRINGS)
+		glyphCache.clear();
+	vector<GLfloat> &glyphs = glyphCache[str];
+	LayOutGlyphs(str, glyphs);
+	return glyphs;
+}
+
+
+
+void Font::LayOutGlyphs(const string &str, vector<GLfloat> &glyphs) const
+{
+	// Add a quad for the given glyph, stretched horizontally by the given
+	// amount, with its top left corner at the given position.
+	auto addQuad = [this, &glyphs](int glyph, float aspect, float x, float y)
+	{
+		for(const GLfloat *corner : CORNERS)
+		{
+			glyphs.push_back(aspect * (corner[0] * glyphWidth) + x);
+			glyphs.push_back(corner[1] * glyphHeight + y);
+			glyphs.push_back((static_cast<float>(glyph) + corner[0]) / GLYPHS);
+			glyphs.push_back(corner[1]);
+		}
+	};
+
+	float x = 0.f;
+	int previous = 0;
+	bool isAfterSpace = true;
+	bool underlineChar = false;
+	const int underscoreGlyph = max(0, min(GLYPHS - 1, '_' - 32));
+
+	for(char c : str)
+	{
+		if(c == '_')
+		{
+			underlineChar = showUnderlines;
+			continue;
+		}
+
+		int glyph = Glyph(c, isAfterSpace);
+		if(c != '"' && c != '\'')
+			isAfterSpace = !glyph;
+		if(!glyph)
+		{
+			x += space;
+			continue;
+		}
+
+		x += advance[previous * GLYPHS + glyph] + KERN;
+		addQuad(glyph, 1.f, x, 0.f);
+
+		if(underlineChar)
+		{
+			addQuad(underscoreGlyph, static_cast<float>(advance[glyph * GLYPHS] + KERN)
+				/ (advance[underscoreGlyph * GLYPHS] + KERN), x, 0.f);
+			underlineChar = false;
+		}
+
+		previous = glyph;
+	}
+}
+
+
+
+// Get the string to draw for the given text, and how far to shift it to align it.
+const string &Font::Truncated(const DisplayText &text, int &shift) const
+{
+	const Layout &layout = text.GetLayout();
+	auto it = truncationCache.find(text.GetText());
+	if(it == truncationCache.end() || it->second.layout.width != layout.width
+		|| it->second.layout.align != layout.align || it->second.layout.truncate != layout.truncate)
+	{
+		if(it == truncationCache.end())
+		{
+			if(truncationCache.size() >= MAX_CACHED_STRINGS)
+				truncationCache.clear();
+			it = truncationCache.emplace(text.GetText(), Truncation()).first;
+		}
+		Truncation &truncation = it->second;
+		truncation.layout = layout;
+		int width = -1;
+		truncation.text = TruncateText(text, width);
+		truncation.shift = 0;
+		if(width >= 0)
+		{
+			if(layout.align == Alignment::CENTER)
+				truncation.shift = (layout.width - width) / 2;
+			else if(layout.align == Alignment::RIGHT)
+				truncation.shift = layout.width - width;
+		}
+	}
+	shift = it->second.shift;
+	return it->second.text;
+}
+
+
+
+void Font::DrawGlyphs(const GLfloat *glyphs, size_t count, double x, double y, const Color &color) const
+{
+	if(!count)
+		return;
+
+	glUseProgram(shader->Object());
+	glBindTexture(GL_TEXTURE_2D, texture);
+	if(OpenGL::HasVaoSupport())
+		glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	if(!OpenGL::HasVaoSupport())
+		EnableAttribArrays();
+
+	RenderStatistics::SetUniform(glUniform4fv, colorI, 1, color.Get());
+
+	// Update the scale, only if the screen size has changed.
+	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
+	{
+		screenWidth = Screen::Width();
+		screenHeight = Screen::Height();
+		scale[0] = 2.f / screenWidth;
+		scale[1] = -2.f / screenHeight;
+	}
+	RenderStatistics::SetUniform(glUniform2fv, scaleI, 1, scale);
+
+	GLfloat position[2] = {static_cast<float>(x), static_cast<float>(y)};
+	RenderStatistics::SetUniform(glUniform2fv, positionI, 1, position);
+
+	RenderStatistics::AddTextureBinds();
+
+	GLint first = Stream(glyphs, count);
+	glDrawArrays(GL_TRIANGLES, first, count / FLOATS_PER_VERTEX);
+	RenderStatistics::AddDrawCall(count / (3 * FLOATS_PER_VERTEX));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if(OpenGL::HasVaoSupport())
+		glBindVertexArray(0);
+	else
+	{
+		glDisableVertexAttribArray(vertI);
+		glDisableVertexAttribArray(cornerI);
+	}
+	glUseProgram(0);
+}
+
+
+
 int Font::WidthRawString(const char *str, char after) const noexcept
 {
 	int width = 0;
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "Layout.h"
 #include "../shader/Shader.h"
 
 #include "../opengl.h"
@@ -22,6 +23,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <functional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class Color;
 class DisplayText;
@@ -33,7 +36,10 @@ class Point;
 // Class for drawing text in OpenGL. Each font is based on a single image with
 // glyphs for each character in ASCII order (not counting control characters).
 // The kerning between characters is automatically adjusted to look good. At the
-// moment only plain ASCII characters are supported, not Unicode.
+// moment only plain ASCII characters are supported, not Unicode. Each string is
+// turned into a list of glyph quads that is drawn with a single draw call, and
+// the quads for recently drawn strings are kept so that text that is drawn
+// every frame does not need to be laid out again.
 class Font {
 public:
 	Font() noexcept = default;
@@ -48,6 +54,13 @@ public:
 	void Draw(const std::string &str, const Point &point, const Color &color) const;
 	void DrawAliased(const std::string &str, double x, double y, const Color &color) const;
 
+	// Add the glyph quads for drawing the given text at the given point to a
+	// list of them, so that many strings can be drawn with one draw call.
+	void AddGlyphs(const std::string &str, const Point &point, std::vector<GLfloat> &glyphs) const;
+	void AddGlyphs(const DisplayText &text, const Point &point, std::vector<GLfloat> &glyphs) const;
+	// Draw a list of glyph quads, offset by the given point.
+	void DrawGlyphs(const std::vector<GLfloat> &glyphs, const Point &point, const Color &color) const;
+
 	// Determine the string's width, without considering formatting.
 	int Width(const std::string &str, char after = ' ') const;
 	// Get the width of the text while accounting for the desired layout and truncation strategy.
@@ -58,6 +71,7 @@ public:
 	int Space() const noexcept;
 
 	static void ShowUnderlines(bool show) noexcept;
+	static bool UnderlinesShown() noexcept;
 
 
 private:
@@ -66,6 +80,15 @@ private:
 	void CalculateAdvances(ImageBuffer &image);
 	void SetUpShader(float glyphW, float glyphH);
 
+	// Get the glyph quads for drawing the given string, with its top left
+	// corner at (1, 0).
+	const std::vector<GLfloat> &Glyphs(const std::string &str) const;
+	void LayOutGlyphs(const std::string &str, std::vector<GLfloat> &glyphs) const;
+	// Get the string to draw for the given text, after truncating it, and how
+	// far it should be shifted to the right to align it.
+	const std::string &Truncated(const DisplayText &text, int &shift) const;
+	void DrawGlyphs(const GLfloat *glyphs, size_t count, double x, double y, const Color &color) const;
+
 	int WidthRawString(const char *str, char after = ' ') const noexcept;
 
 	std::string TruncateText(const DisplayText &text, int &width) const;
@@ -91,4 +114,17 @@ private:
 	static const int GLYPHS = 98;
 	int advance[GLYPHS * GLYPHS] = {};
 	int widthEllipses = 0;
+
+	// The glyph quads of recently drawn strings, and whether underlines were
+	// shown when they were laid out.
+	mutable std::unordered_map<std::string, std::vector<GLfloat>> glyphCache;
+	mutable bool cacheUnderlines = false;
+	// The result of truncating recently drawn text to fit its layout.
+	class Truncation {
+	public:
+		Layout layout;
+		std::string text;
+		int shift = 0;
+	};
+	mutable std::unordered_map<std::string, Truncation> truncationCache;
 };
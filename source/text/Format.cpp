@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Format.h"
 
 #include "../Preferences.h"
+#include "TextTemplate.h"
 
 #include <algorithm>
 #include <array>
@@ -23,7 +24,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cmath>
 #include <cstring>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace std;
@@ -194,6 +199,30 @@ namespace {
 		}
 	}
 
+	// Text that has substitutions made into it is often the same text over and
+	// over (e.g. the same job being offered many times), so remember how each
+	// piece of text was scanned for placeholders. If too many different texts
+	// are seen, start over rather than keeping all of them.
+	constexpr size_t MAX_CACHED_TEMPLATES = 4096;
+
+	shared_ptr<const TextTemplate> CachedTemplate(const string &source)
+	{
+		static mutex cacheMutex;
+		// The keys point into the text held by each template.
+		static unordered_map<string_view, shared_ptr<const TextTemplate>> cache;
+
+		lock_guard<mutex> lock(cacheMutex);
+		auto it = cache.find(source);
+		if(it != cache.end())
+			return it->second;
+
+		if(cache.size() >= MAX_CACHED_TEMPLATES)
+			cache.clear();
+		auto result = make_shared<const TextTemplate>(source);
+		cache.emplace(result->Text(), result);
+		return result;
+	}
+
 	string StringSubstituter(const string &source,
 			function<const string *(const string &)> SubstitutionFor)
 	{
@@ -801,13 +830,11 @@ double Format::Parse(const string &str)
 
 string Format::Replace(const string &source, const map<string, string> &keys)
 {
-	auto SubstitutionFor = [&](const string &key) -> const string *
-	{
-		auto found = keys.find(key);
-		return (found == keys.end()) ? nullptr : &found->second;
-	};
+	// Most text does not have anything to substitute.
+	if(source.find('<') == string::npos)
+		return source;
 
-	return StringSubstituter(source, SubstitutionFor);
+	return CachedTemplate(source)->Replace(keys);
 }
 
 
@@ -0,0 +1,106 @@
+/* TextTemplate.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TextTemplate.h"
+
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+
+
+TextTemplate::TextTemplate(string text)
+	: text(std::move(text))
+{
+	// Each '<' may be the start of a placeholder that ends at the next '>'.
+	// If there is no '>' after it, there cannot be any more placeholders.
+	unordered_map<string_view, size_t> keyIndex;
+	size_t left = this->text.find('<');
+	while(left != string::npos)
+	{
+		size_t right = this->text.find('>', left);
+		if(right == string::npos)
+			break;
+
+		++right;
+		string_view key(this->text.data() + left, right - left);
+		auto it = keyIndex.emplace(key, keys.size()).first;
+		if(it->second == keys.size())
+			keys.emplace_back(key);
+		placeholders.push_back(Placeholder{left, right, it->second});
+
+		left = this->text.find('<', left + 1);
+	}
+}
+
+
+
+// Get the original text, without any substitutions.
+const string &TextTemplate::Text() const
+{
+	return text;
+}
+
+
+
+// Check if the text has anything that might be substituted.
+bool TextTemplate::HasPlaceholders() const
+{
+	return !placeholders.empty();
+}
+
+
+
+// Replace each placeholder that is one of the given keys with its value.
+string TextTemplate::Replace(const map<string, string> &keys) const
+{
+	if(placeholders.empty())
+		return text;
+
+	// Look up each distinct key only once, even if it appears many times.
+	vector<const string *> values(this->keys.size(), nullptr);
+	for(size_t i = 0; i < values.size(); ++i)
+	{
+		auto it = keys.find(this->keys[i]);
+		if(it != keys.end())
+			values[i] = &it->second;
+	}
+
+	// Figure out exactly how long the result will be, so that it only has to
+	// be allocated once.
+	size_t length = text.length();
+	size_t start = 0;
+	for(const Placeholder &placeholder : placeholders)
+		if(placeholder.start >= start && values[placeholder.key])
+		{
+			length += values[placeholder.key]->length() - (placeholder.end - placeholder.start);
+			start = placeholder.end;
+		}
+
+	string result;
+	result.reserve(length);
+	start = 0;
+	for(const Placeholder &placeholder : placeholders)
+		if(placeholder.start >= start && values[placeholder.key])
+		{
+			result.append(text, start, placeholder.start - start);
+			result.append(*values[placeholder.key]);
+			start = placeholder.end;
+		}
+	result.append(text, start, string::npos);
+	return result;
+}
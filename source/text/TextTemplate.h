@@ -0,0 +1,60 @@
+/* TextTemplate.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+
+
+// A piece of text containing "<key>" placeholders, which has been scanned ahead
+// of time so that substituting a set of keys into it only requires looking up
+// each distinct key once and copying the text into a single output buffer.
+class TextTemplate {
+public:
+	TextTemplate() = default;
+	explicit TextTemplate(std::string text);
+
+	// Get the original text, without any substitutions.
+	const std::string &Text() const;
+	// Check if the text has anything that might be substituted.
+	bool HasPlaceholders() const;
+
+	// Replace each placeholder that is one of the given keys with its value.
+	// This gives the same result as Format::Replace().
+	std::string Replace(const std::map<std::string, std::string> &keys) const;
+
+
+private:
+	// A possible placeholder: any '<' and the next '>' after it. Placeholders
+	// may overlap, e.g. in "<a<b>". If one is substituted, any others that
+	// start inside of it are skipped.
+	class Placeholder {
+	public:
+		size_t start;
+		size_t end;
+		// Which of the distinct keys this placeholder is.
+		size_t key;
+	};
+
+
+private:
+	std::string text;
+	std::vector<std::string> keys;
+	std::vector<Placeholder> placeholders;
+};
@@ -33,7 +33,7 @@ WrappedText::WrappedText(const Font &font)
 
 void WrappedText::SetAlignment(Alignment align)
 {
-	alignment = align;
+	Change(alignment, align);
 }
 
 
@@ -41,6 +41,9 @@ void WrappedText::SetAlignment(Alignment align)
 // Set the truncate mode.
 void WrappedText::SetTruncate(Truncate trunc)
 {
+	// This only changes how the text is drawn, not how it is wrapped.
+	if(truncate != trunc)
+		hasGlyphs = false;
 	truncate = trunc;
 }
 
@@ -56,7 +59,7 @@ int WrappedText::WrapWidth() const
 
 void WrappedText::SetWrapWidth(int width)
 {
-	wrapWidth = width;
+	Change(wrapWidth, width);
 }
 
 
@@ -66,9 +69,9 @@ void WrappedText::SetWrapWidth(int width)
 // and the alignment separately.
 void WrappedText::SetFont(const Font &font)
 {
-	this->font = &font;
+	Change(this->font, &font);
 
-	space = font.Space();
+	Change(space, font.Space());
 	SetTabWidth(4 * space);
 	SetLineHeight(font.Height() * 120 / 100);
 	SetParagraphBreak(font.Height() * 40 / 100);
@@ -86,7 +89,7 @@ int WrappedText::TabWidth() const
 
 void WrappedText::SetTabWidth(int width)
 {
-	tabWidth = width;
+	Change(tabWidth, width);
 }
 
 
@@ -101,7 +104,7 @@ int WrappedText::LineHeight() const
 
 void WrappedText::SetLineHeight(int height)
 {
-	lineHeight = height;
+	Change(lineHeight, height);
 }
 
 
@@ -116,7 +119,7 @@ int WrappedText::ParagraphBreak() const
 
 void WrappedText::SetParagraphBreak(int height)
 {
-	paragraphBreak = height;
+	Change(paragraphBreak, height);
 }
 
 
@@ -125,6 +128,8 @@ void WrappedText::SetParagraphBreak(int height)
 // always begin at (0, 0).
 void WrappedText::Wrap(const string &str)
 {
+	if(isWrapped && str == source)
+		return;
 	SetText(str.data(), str.length());
 
 	Wrap();
@@ -134,6 +139,8 @@ void WrappedText::Wrap(const string &str)
 
 void WrappedText::Wrap(const char *str)
 {
+	if(isWrapped && source == str)
+		return;
 	SetText(str, strlen(str));
 
 	Wrap();
@@ -166,23 +173,32 @@ void WrappedText::Draw(const Point &topLeft, const Color &color) const
 	if(words.empty())
 		return;
 
-	if(truncate == Truncate::NONE)
-		for(const Word &w : words)
-			font->Draw(text.c_str() + w.Index(), w.Pos() + topLeft, color);
-	else
+	// Lay out the glyphs of every word together, so that they can all be drawn
+	// with a single draw call.
+	if(!hasGlyphs || glyphsUnderlined != Font::UnderlinesShown())
 	{
-		// Currently, we only apply truncation to a line if it contains a single word.
-		int h = words[0].y - 1;
-		for(size_t i = 0; i < words.size(); ++i)
+		glyphs.clear();
+		hasGlyphs = true;
+		glyphsUnderlined = Font::UnderlinesShown();
+		if(truncate == Truncate::NONE)
+			for(const Word &w : words)
+				font->AddGlyphs(text.c_str() + w.Index(), w.Pos(), glyphs);
+		else
 		{
-			const Word &w = words[i];
-			if(h == w.y && (i != words.size() - 1 && w.y == words[i + 1].y))
-				font->Draw(text.c_str() + w.Index(), w.Pos() + topLeft, color);
-			else
-				font->Draw({text.c_str() + w.Index(), {wrapWidth, truncate}}, w.Pos() + topLeft, color);
-			h = w.y;
+			// Currently, we only apply truncation to a line if it contains a single word.
+			int h = words[0].y - 1;
+			for(size_t i = 0; i < words.size(); ++i)
+			{
+				const Word &w = words[i];
+				if(h == w.y && (i != words.size() - 1 && w.y == words[i + 1].y))
+					font->AddGlyphs(text.c_str() + w.Index(), w.Pos(), glyphs);
+				else
+					font->AddGlyphs({text.c_str() + w.Index(), {wrapWidth, truncate}}, w.Pos(), glyphs);
+				h = w.y;
+			}
 		}
 	}
+	font->DrawGlyphs(glyphs, topLeft, color);
 }
 
 
@@ -207,8 +223,10 @@ void WrappedText::SetText(const char *it, size_t length)
 	// underlying text buffer changes.
 	words.clear();
 
-	// Reallocate that buffer.
+	// Reallocate that buffer, and remember what was in it before the words
+	// were split apart.
 	text.assign(it, length);
+	source.assign(it, length);
 }
 
 
@@ -217,6 +235,8 @@ void WrappedText::Wrap()
 {
 	height = 0;
 	longestLineWidth = 0;
+	isWrapped = true;
+	hasGlyphs = false;
 
 	if(text.empty() || !font)
 		return;
@@ -357,3 +377,14 @@ int WrappedText::Space(char c) const
 {
 	return (c == ' ') ? space : (c == '\t') ? tabWidth : 0;
 }
+
+
+
+// Note that the text must be wrapped again, if the given setting changes.
+template<class Type>
+void WrappedText::Change(Type &setting, Type value)
+{
+	if(setting != value)
+		isWrapped = false;
+	setting = value;
+}
@@ -28,7 +28,9 @@ class Font;
 
 
 // Class for calculating word positions in wrapped text. You can specify various
-// parameters of the formatting, including text alignment.
+// parameters of the formatting, including text alignment. Wrapping the same
+// text again with the same parameters does nothing, so the text can be wrapped
+// each time it is drawn without laying it out again.
 class WrappedText {
 public:
 	WrappedText() = default;
@@ -62,7 +64,7 @@ public:
 	int ParagraphBreak() const;
 	void SetParagraphBreak(int height);
 
-	// Wrap the given text. Use Draw() to draw it.
+	// Wrap the given text, unless it is already wrapped. Use Draw() to draw it.
 	void Wrap(const std::string &str);
 	void Wrap(const char *str);
 
@@ -80,6 +82,9 @@ public:
 private:
 	void SetText(const char *it, size_t length);
 	void Wrap();
+	// Note that the text must be wrapped again, if the given setting changes.
+	template<class Type>
+	void Change(Type &setting, Type value);
 	void AdjustLine(size_t &lineBegin, int &lineWidth, bool isEnd);
 	int Space(char c) const;
 
@@ -118,4 +123,15 @@ private:
 	int height = 0;
 
 	int longestLineWidth = 0;
+
+	// The text that was last wrapped, and whether it is still wrapped the way
+	// the current settings say it should be.
+	std::string source;
+	bool isWrapped = false;
+	// The glyph quads for drawing all the words at once, relative to the top
+	// left corner, and whether they were laid out with underlines shown. They
+	// are laid out again whenever the text is wrapped differently.
+	mutable std::vector<float> glyphs;
+	mutable bool hasGlyphs = false;
+	mutable bool glyphsUnderlined = false;
 };
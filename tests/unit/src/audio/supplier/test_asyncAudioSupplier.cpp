@@ -0,0 +1,166 @@
+/* test_asyncAudioSupplier.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../../source/audio/supplier/AsyncAudioSupplier.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// What the decoder threads have done with one supplier. This outlives the
+// supplier, so that it can tell whether it was decoded after being destroyed.
+struct DecodeRecord {
+	std::atomic<int> decoding = 0;
+	std::atomic<bool> isDestroyed = false;
+	std::atomic<int> overlaps = 0;
+	std::atomic<int> lateDecodes = 0;
+};
+
+// A looping supplier that fills its buffer with a constant, and records how
+// it was decoded.
+class TestSupplier : public AsyncAudioSupplier {
+public:
+	explicit TestSupplier(std::shared_ptr<DecodeRecord> record)
+		: AsyncAudioSupplier(std::make_shared<std::stringstream>(), true), record(std::move(record))
+	{
+		StartDecoding();
+	}
+	~TestSupplier() override
+	{
+		StopDecoding();
+		record->isDestroyed = true;
+	}
+
+	static size_t ChunkSize() { return OUTPUT_CHUNK; }
+
+
+protected:
+	void Decode() override
+	{
+		std::shared_ptr<DecodeRecord> current = record;
+		if(current->decoding++)
+			++current->overlaps;
+		// Only decode one chunk at a time, so that the supplier has to be
+		// scheduled again as often as possible.
+		for(size_t size = 0; size < OUTPUT_CHUNK; )
+		{
+			std::span<sample_t> space = BufferSpace();
+			if(space.empty())
+				break;
+			size_t count = std::min(space.size(), OUTPUT_CHUNK - size);
+			std::fill_n(space.begin(), count, 1);
+			CommitSamples(count);
+			size += count;
+		}
+		if(current->isDestroyed)
+			++current->lateDecodes;
+		--current->decoding;
+	}
+
+
+private:
+	std::shared_ptr<DecodeRecord> record;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Decoding audio on the shared decoder threads", "[AsyncAudioSupplier]" ) {
+	GIVEN( "suppliers that are read from as fast as they are decoded" ) {
+		std::vector<std::shared_ptr<DecodeRecord>> records;
+		std::vector<AudioSupplier::sample_t> chunk(TestSupplier::ChunkSize());
+		bool gotData = true;
+		// Reading a chunk schedules the supplier again, often while a decoder
+		// thread is still finishing up with it.
+		for(int i = 0; i < 200; ++i)
+		{
+			auto first = std::make_shared<DecodeRecord>();
+			auto second = std::make_shared<DecodeRecord>();
+			{
+				TestSupplier a(first);
+				TestSupplier b(second);
+				for(int j = 0; j < 10; ++j)
+				{
+					for(TestSupplier *supplier : {&a, &b})
+					{
+						while(!supplier->AvailableChunks())
+							continue;
+						supplier->NextDataChunk(chunk);
+						gotData &= (chunk.front() == 1 && chunk.back() == 1);
+					}
+				}
+			}
+			records.push_back(first);
+			records.push_back(second);
+		}
+		// Give any decoding that wrongly outlived its supplier time to finish.
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		THEN( "each supplier is only decoded by one thread at a time" ) {
+			int overlaps = 0;
+			for(const auto &record : records)
+				overlaps += record->overlaps;
+			CHECK( overlaps == 0 );
+		}
+		THEN( "no supplier is decoded after it has been destroyed" ) {
+			int lateDecodes = 0;
+			for(const auto &record : records)
+				lateDecodes += record->lateDecodes;
+			CHECK( lateDecodes == 0 );
+		}
+		THEN( "every chunk is filled with decoded data" ) {
+			CHECK( gotData );
+		}
+	}
+}
+
+SCENARIO( "Reading decoded audio in place", "[AsyncAudioSupplier]" ) {
+	GIVEN( "a supplier with decoded chunks" ) {
+		TestSupplier supplier(std::make_shared<DecodeRecord>());
+		while(!supplier.AvailableChunks())
+			std::this_thread::yield();
+		std::vector<AudioSupplier::sample_t> chunk(TestSupplier::ChunkSize(), 0);
+		WHEN( "a chunk is peeked at" ) {
+			std::span<const AudioSupplier::sample_t> samples = supplier.PeekChunk(chunk);
+			THEN( "it is a whole chunk that was not copied" ) {
+				CHECK( samples.size() == TestSupplier::ChunkSize() );
+				CHECK( samples.data() != chunk.data() );
+				CHECK( samples.front() == 1 );
+				CHECK( chunk.front() == 0 );
+			}
+			supplier.ReleaseChunk();
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
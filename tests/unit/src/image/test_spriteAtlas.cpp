@@ -0,0 +1,134 @@
+/* test_spriteAtlas.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/image/SpriteAtlas.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+class Rect {
+public:
+	int x;
+	int y;
+	int width;
+	int height;
+
+	bool Overlaps(const Rect &other) const
+	{
+		return x < other.x + other.width && other.x < x + width
+			&& y < other.y + other.height && other.y < y + height;
+	}
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Packing sprites into an atlas", "[SpriteAtlas]" ) {
+	GIVEN( "an empty atlas" ) {
+		SpriteAtlas atlas(64);
+		int x = -1;
+		int y = -1;
+
+		THEN( "it has the given size" ) {
+			CHECK( atlas.Size() == 64 );
+		}
+		THEN( "the first sprite is placed in the corner" ) {
+			REQUIRE( atlas.Place(10, 20, x, y) );
+			CHECK( x == 0 );
+			CHECK( y == 0 );
+		}
+		THEN( "sprites larger than the atlas are not placed" ) {
+			CHECK_FALSE( atlas.Place(65, 1, x, y) );
+			CHECK_FALSE( atlas.Place(1, 65, x, y) );
+			CHECK_FALSE( atlas.Place(0, 10, x, y) );
+		}
+		THEN( "a sprite the size of the atlas fills it" ) {
+			REQUIRE( atlas.Place(64, 64, x, y) );
+			CHECK_FALSE( atlas.Place(1, 1, x, y) );
+		}
+		WHEN( "sprites are placed next to each other" ) {
+			REQUIRE( atlas.Place(40, 20, x, y) );
+			REQUIRE( atlas.Place(20, 10, x, y) );
+			THEN( "they share a row while it has room" ) {
+				CHECK( x == 40 );
+				CHECK( y == 0 );
+			}
+			THEN( "a sprite that does not fit in the row starts a new one below it" ) {
+				REQUIRE( atlas.Place(10, 10, x, y) );
+				CHECK( x == 0 );
+				CHECK( y == 20 );
+			}
+			THEN( "a sprite taller than the row starts a new one below it" ) {
+				REQUIRE( atlas.Place(4, 30, x, y) );
+				CHECK( x == 0 );
+				CHECK( y == 20 );
+			}
+		}
+		WHEN( "there are rows of different heights with room in them" ) {
+			REQUIRE( atlas.Place(60, 30, x, y) );
+			REQUIRE( atlas.Place(10, 12, x, y) );
+			REQUIRE( y == 30 );
+			THEN( "a sprite goes in the shortest row that it fits in" ) {
+				REQUIRE( atlas.Place(4, 8, x, y) );
+				CHECK( x == 10 );
+				CHECK( y == 30 );
+			}
+		}
+	}
+	GIVEN( "an atlas that many sprites are placed in" ) {
+		SpriteAtlas atlas(256);
+		std::vector<Rect> placed;
+		for(int i = 0; i < 200; ++i)
+		{
+			Rect rect{0, 0, 3 + (i * 7) % 29, 3 + (i * 13) % 23};
+			if(atlas.Place(rect.width, rect.height, rect.x, rect.y))
+				placed.push_back(rect);
+		}
+
+		THEN( "most of them fit" ) {
+			CHECK( placed.size() > 100 );
+		}
+		THEN( "they are all inside the atlas" ) {
+			for(const Rect &rect : placed)
+			{
+				CHECK( rect.x >= 0 );
+				CHECK( rect.y >= 0 );
+				CHECK( rect.x + rect.width <= 256 );
+				CHECK( rect.y + rect.height <= 256 );
+			}
+		}
+		THEN( "none of them overlap" ) {
+			bool overlap = false;
+			for(size_t i = 0; i < placed.size(); ++i)
+				for(size_t j = i + 1; j < placed.size(); ++j)
+					overlap |= placed[i].Overlaps(placed[j]);
+			CHECK_FALSE( overlap );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
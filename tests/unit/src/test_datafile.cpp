@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Include a helper functions.
 #include "datanode-factory.h"
 #include "../../../source/text/Format.h"
+#include "../../../source/Gzip.h"
 #include "logger-output.h"
 #include "output-capture.hpp"
 
@@ -102,6 +103,17 @@ node2 hi
 					}
 		}
 	}
+	GIVEN( "A DataFile created with a compressed stream" ) {
+		std::istringstream stream(Gzip::Compress("node1\n\tfoo\nnode2 hi\n"));
+		const DataFile root(stream);
+
+		THEN( "it is decompressed before it is parsed" ) {
+			REQUIRE( std::distance(root.begin(), root.end()) == 2 );
+			CHECK( root.begin()->Token(0) == "node1" );
+			CHECK( root.begin()->begin()->Token(0) == "foo" );
+			CHECK( std::next(root.begin())->Token(1) == "hi" );
+		}
+	}
 }
 
 SCENARIO( "Loading a DataFile with missing quotes", "[DataFile]" ) {
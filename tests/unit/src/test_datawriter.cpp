@@ -184,6 +184,52 @@ TEST_CASE( "DataWriter::Write", "[datawriter][write]" ) {
 		}
 	}
 }
+
+TEST_CASE( "DataWriter::WriteToken", "[datawriter][writetoken]" ) {
+	DataWriter writer;
+	GIVEN( "numbers" ) {
+		writer.Write(0, -12, 1234567890123ll, 3u);
+		writer.Write(0., 1.5, -0.25, 1. / 3., 123456789., 1e-7);
+		THEN( "integers are written in full and other numbers with eight significant digits" ) {
+			CHECK( writer.SaveToString() == "0 -12 1234567890123 3\n0 1.5 -0.25 0.33333333 1.2345679e+08 1e-07\n" );
+		}
+	}
+	GIVEN( "strings" ) {
+		const std::string text = "some text";
+		writer.Write("plain", text, "with \"quote\"", "`");
+		THEN( "they are quoted as needed" ) {
+			CHECK( writer.SaveToString() == "plain \"some text\" `with \"quote\"` \"`\"\n" );
+		}
+	}
+}
+
+TEST_CASE( "DataWriter with a sink", "[datawriter][sink]" ) {
+	GIVEN( "a DataWriter that passes its output to a function" ) {
+		std::string output;
+		int blocks = 0;
+		DataWriter inMemory;
+		{
+			DataWriter writer([&output, &blocks](const char *data, size_t size)
+				{
+					output.append(data, size);
+					++blocks;
+				});
+			for(int i = 0; i < 10000; ++i)
+			{
+				writer.Write("line", i, i * .5);
+				inMemory.Write("line", i, i * .5);
+			}
+			THEN( "the output is passed along a block at a time" ) {
+				CHECK( blocks > 0 );
+				CHECK( output.size() < inMemory.SaveToString().size() );
+			}
+		}
+		THEN( "all the output has been passed along once the writer is destroyed" ) {
+			CHECK( blocks > 1 );
+			CHECK( output == inMemory.SaveToString() );
+		}
+	}
+}
 // #endregion unit tests
 
 
@@ -0,0 +1,109 @@
+/* test_fileTree.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/FileTree.h"
+
+// ... and any system includes needed for the test file.
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A directory of files that is deleted again at the end of the test.
+class TemporaryDirectory {
+public:
+	TemporaryDirectory()
+		: path(std::filesystem::temp_directory_path() / "endless-sky-test-file-tree")
+	{
+		std::filesystem::remove_all(path);
+		std::filesystem::create_directories(path / "data" / "human");
+		std::filesystem::create_directories(path / "images" / "ship");
+		std::filesystem::create_directories(path / "empty");
+		for(const char *name : {"data/map.txt", "data/human/ships.txt", "data/human/outfits.txt",
+				"images/ship/shuttle.png", "credits.txt"})
+			std::ofstream(path / name) << name;
+	}
+	~TemporaryDirectory()
+	{
+		std::error_code error;
+		std::filesystem::remove_all(path, error);
+	}
+
+	std::filesystem::path path;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Scanning a directory", "[FileTree]" ) {
+	GIVEN( "a directory with files and directories in it" ) {
+		TemporaryDirectory directory;
+		const std::filesystem::path &root = directory.path;
+		FileTree tree({root / "data", root / "images", root / "empty"});
+
+		THEN( "the contents of each directory are listed in order" ) {
+			CHECK( tree.List(root / "data") == std::vector<std::filesystem::path>{root / "data" / "map.txt"} );
+			CHECK( tree.ListDirectories(root / "data") == std::vector<std::filesystem::path>{root / "data" / "human"} );
+			CHECK( tree.List(root / "data" / "human") == std::vector<std::filesystem::path>{
+				root / "data" / "human" / "outfits.txt", root / "data" / "human" / "ships.txt"} );
+			CHECK( tree.List(root / "empty") == std::vector<std::filesystem::path>{} );
+		}
+		THEN( "the files in each directory can be listed recursively" ) {
+			CHECK( tree.RecursiveList(root / "data") == std::vector<std::filesystem::path>{
+				root / "data" / "human" / "outfits.txt", root / "data" / "human" / "ships.txt",
+				root / "data" / "map.txt"} );
+			CHECK( tree.RecursiveList(root / "images") == std::vector<std::filesystem::path>{
+				root / "images" / "ship" / "shuttle.png"} );
+		}
+		THEN( "the files that exist are known" ) {
+			CHECK( tree.Exists(root / "data") == true );
+			CHECK( tree.Exists(root / "data" / "human") == true );
+			CHECK( tree.Exists(root / "images" / "ship" / "shuttle.png") == true );
+		}
+		THEN( "the modification time of each file is known" ) {
+			const std::filesystem::path path = root / "data" / "map.txt";
+			CHECK( tree.Timestamp(path) == std::filesystem::last_write_time(path) );
+		}
+		THEN( "anything outside of the scanned directories is not known" ) {
+			CHECK_FALSE( tree.Exists(root / "credits.txt").has_value() );
+			CHECK_FALSE( tree.List(root).has_value() );
+			CHECK_FALSE( tree.Timestamp(root / "credits.txt").has_value() );
+		}
+		WHEN( "a scanned directory is changed" ) {
+			tree.Forget(root / "data" / "human" / "new.txt");
+			THEN( "its contents are no longer known" ) {
+				CHECK_FALSE( tree.List(root / "data").has_value() );
+				CHECK_FALSE( tree.Exists(root / "data" / "map.txt").has_value() );
+			}
+			THEN( "the other directories are still known" ) {
+				CHECK( tree.Exists(root / "images" / "ship" / "shuttle.png") == true );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
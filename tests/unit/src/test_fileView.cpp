@@ -0,0 +1,104 @@
+/* test_fileView.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/FileView.h"
+
+// ... and any system includes needed for the test file.
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A file that is deleted again at the end of the test.
+class TemporaryFile {
+public:
+	explicit TemporaryFile(const std::string &contents)
+		: path(std::filesystem::temp_directory_path() / "endless-sky-test-file-view.txt")
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << contents;
+	}
+	~TemporaryFile()
+	{
+		std::error_code error;
+		std::filesystem::remove(path, error);
+	}
+
+	std::filesystem::path path;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Viewing the contents of a file", "[FileView]" ) {
+	GIVEN( "a file with some text in it" ) {
+		const std::string contents = "ship \"Bactrian\"\n\tattributes\n";
+		TemporaryFile file(contents);
+		WHEN( "it is mapped" ) {
+			FileView view = FileView::Map(file.path);
+			THEN( "the view has its contents" ) {
+				CHECK( view.IsMapped() );
+				CHECK( view.Size() == contents.size() );
+				CHECK( view.Data() == contents );
+			}
+			AND_WHEN( "the view is moved" ) {
+				FileView moved = std::move(view);
+				THEN( "the new view has the contents" ) {
+					CHECK( moved.Data() == contents );
+					CHECK( view.Empty() );
+					CHECK_FALSE( view.IsMapped() );
+				}
+			}
+		}
+	}
+	GIVEN( "an empty file" ) {
+		TemporaryFile file("");
+		THEN( "it cannot be mapped" ) {
+			FileView view = FileView::Map(file.path);
+			CHECK( view.Empty() );
+			CHECK_FALSE( view.IsMapped() );
+		}
+	}
+	GIVEN( "a file that does not exist" ) {
+		THEN( "it cannot be mapped" ) {
+			FileView view = FileView::Map(std::filesystem::temp_directory_path() / "endless-sky-no-such-file.txt");
+			CHECK( view.Empty() );
+			CHECK_FALSE( view.IsMapped() );
+		}
+	}
+	GIVEN( "contents that were read into memory" ) {
+		FileView view(std::string("short"));
+		THEN( "the view holds a copy of them" ) {
+			CHECK_FALSE( view.IsMapped() );
+			CHECK( view.Data() == "short" );
+			FileView moved = std::move(view);
+			CHECK( moved.Data() == "short" );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
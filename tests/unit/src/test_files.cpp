@@ -0,0 +1,83 @@
+/* test_files.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Files.h"
+
+// Include Gzip, to write compressed data like saved games are.
+#include "../../../source/Gzip.h"
+
+// ... and any system includes needed for the test file.
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Data that line ending translation would change.
+const std::string LINE_ENDINGS = std::string("first\nsecond\r\nthird\r\r\n\x1a\0fourth\n", 26);
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Writing and reading back a file", "[Files]" ) {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "es-test-files.dat";
+	GIVEN( "data with line endings in it" ) {
+		WHEN( "it is written and read back" ) {
+			{
+				std::shared_ptr<std::iostream> out = Files::Open(path, true);
+				REQUIRE( out );
+				out->write(LINE_ENDINGS.data(), LINE_ENDINGS.size());
+			}
+			THEN( "it is unchanged" ) {
+				CHECK( Files::Read(Files::Open(path)) == LINE_ENDINGS );
+			}
+		}
+	}
+	GIVEN( "compressed data" ) {
+		std::string text;
+		for(int i = 0; i < 1000; ++i)
+			text += "line " + std::to_string(i) + "\n";
+		const std::string compressed = Gzip::Compress(text);
+		WHEN( "it is written and read back" ) {
+			{
+				std::shared_ptr<std::iostream> out = Files::Open(path, true);
+				REQUIRE( out );
+				out->write(compressed.data(), compressed.size());
+			}
+			const std::string read = Files::Read(Files::Open(path));
+			THEN( "it is unchanged" ) {
+				CHECK( read == compressed );
+			}
+			THEN( "it decompresses to the original data" ) {
+				CHECK( Gzip::Decompress(read) == text );
+			}
+		}
+	}
+	Files::Delete(path);
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,97 @@
+/* test_gzip.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Gzip.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Make some text that looks a bit like a saved game.
+std::string MakeSave(int ships)
+{
+	std::string text = "pilot Test Pilot\ndate 16 11 3013\n";
+	for(int i = 0; i < ships; ++i)
+	{
+		text += "ship \"Star Barge\"\n\tname \"Barge " + std::to_string(i) + "\"\n";
+		text += "\toutfits\n\t\t\"Hai Fissure Batteries\" 2\n\t\t\"X1700 Ion Thruster\"\n";
+	}
+	return text;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Compressing and decompressing data", "[Gzip]" ) {
+	GIVEN( "some text" ) {
+		const std::string text = MakeSave(5000);
+		REQUIRE_FALSE( Gzip::IsCompressed(text) );
+
+		WHEN( "it is compressed" ) {
+			const std::string compressed = Gzip::Compress(text);
+			THEN( "it is recognized as compressed" ) {
+				CHECK( Gzip::IsCompressed(compressed) );
+			}
+			THEN( "it is smaller" ) {
+				CHECK( compressed.size() < text.size() / 4 );
+			}
+			THEN( "it decompresses to the original text" ) {
+				CHECK( Gzip::Decompress(compressed) == text );
+			}
+			THEN( "only the beginning can be decompressed" ) {
+				const std::string start = Gzip::Decompress(compressed, 100);
+				CHECK( start.size() >= 100 );
+				CHECK( start.size() < text.size() );
+				CHECK( text.starts_with(start) );
+			}
+			THEN( "incomplete data decompresses as far as it goes" ) {
+				const std::string start = Gzip::Decompress(compressed.substr(0, compressed.size() / 2));
+				CHECK_FALSE( start.empty() );
+				CHECK( text.starts_with(start) );
+			}
+		}
+		WHEN( "it is compressed in pieces" ) {
+			std::string compressed;
+			Gzip::Compressor compressor([&compressed](const char *data, size_t size) { compressed.append(data, size); });
+			for(size_t i = 0; i < text.size(); i += 1000)
+				compressor.Write(text.data() + i, std::min<size_t>(1000, text.size() - i));
+			compressor.Finish();
+			THEN( "it decompresses to the original text" ) {
+				CHECK( Gzip::Decompress(compressed) == text );
+			}
+		}
+	}
+	GIVEN( "no text" ) {
+		THEN( "it round trips" ) {
+			const std::string compressed = Gzip::Compress("");
+			CHECK( Gzip::IsCompressed(compressed) );
+			CHECK( Gzip::Decompress(compressed).empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,76 @@
+/* test_information.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Information.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Reusing an Information object", "[Information]" ) {
+	GIVEN( "an object with some information set" ) {
+		Information info;
+		info.SetString("name", "value");
+		info.SetBar("shields", .5, 4.);
+		info.SetCondition("ready");
+		info.SetRegion(Rectangle(Point(1., 2.), Point(3., 4.)));
+
+		WHEN( "it is cleared" ) {
+			info.Clear();
+			THEN( "nothing that was set is left" ) {
+				CHECK( info.GetString("name").empty() );
+				CHECK( info.BarValue("shields") == 0. );
+				CHECK( info.BarSegments("shields") == 1. );
+				CHECK_FALSE( info.HasCondition("ready") );
+				CHECK_FALSE( info.HasCustomRegion() );
+			}
+			AND_WHEN( "different information is set" ) {
+				info.SetString("other", "new value");
+				info.SetBar("hull", .25);
+				info.SetCondition("alert");
+				THEN( "only the new information is known" ) {
+					CHECK( info.GetString("other") == "new value" );
+					CHECK( info.GetString("name").empty() );
+					CHECK( info.BarValue("hull") == .25 );
+					CHECK( info.BarValue("shields") == 0. );
+					CHECK( info.HasCondition("alert") );
+					CHECK_FALSE( info.HasCondition("ready") );
+				}
+			}
+		}
+		WHEN( "a value is set again" ) {
+			info.SetString("name", "changed");
+			THEN( "the new value replaces the old one" ) {
+				CHECK( info.GetString("name") == "changed" );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
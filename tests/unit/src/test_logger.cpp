@@ -0,0 +1,144 @@
+/* test_logger.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Logger.h"
+
+// Include a helper for capturing & asserting on logged output.
+#include "output-capture.hpp"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Records the messages passed to the log callback, without their timestamps.
+class LogRecord {
+public:
+	LogRecord()
+	{
+		Logger::SetLogCallback([this](const std::string &message, Logger::Level)
+		{
+			messages.push_back(message.substr(message.find(" | ") + 7));
+		}, [this]() { ++batches; });
+	}
+	~LogRecord()
+	{
+		Logger::SetLogCallback(nullptr);
+	}
+
+	std::vector<std::string> messages;
+	int batches = 0;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Logging messages", "[Logger]" ) {
+	OutputSink errors(std::cerr);
+	OutputSink info(std::cout);
+	GIVEN( "no active session" ) {
+		LogRecord record;
+		WHEN( "a message is logged" ) {
+			Logger::Log("first", Logger::Level::WARNING);
+			THEN( "it is written immediately" ) {
+				REQUIRE( record.messages.size() == 1 );
+				CHECK( record.messages[0] == "first" );
+				CHECK( record.batches == 1 );
+				CHECK( errors.Peek().ends_with("| W | first\n") );
+				CHECK( info.Peek().empty() );
+			}
+		}
+		WHEN( "the same message is logged several times" ) {
+			for(int i = 0; i < 3; ++i)
+				Logger::Log("repeated", Logger::Level::INFO);
+			THEN( "every copy of it is written" ) {
+				CHECK( record.messages == std::vector<std::string>(3, "repeated") );
+			}
+		}
+	}
+	GIVEN( "an active session" ) {
+		LogRecord record;
+		{
+			Logger::Session session(true);
+			WHEN( "a message is repeated" ) {
+				for(int i = 0; i < 3; ++i)
+					Logger::Log("repeated", Logger::Level::WARNING);
+				Logger::Log("different", Logger::Level::WARNING);
+				Logger::Flush();
+				THEN( "the repeats are collapsed into one line" ) {
+					const std::vector<std::string> expected = {
+						"repeated",
+						"The previous message was repeated 2 more times.",
+						"different"
+					};
+					CHECK( record.messages == expected );
+				}
+			}
+			WHEN( "a message is logged many times between other messages" ) {
+				for(int i = 0; i < 20; ++i)
+				{
+					Logger::Log("common", Logger::Level::WARNING);
+					Logger::Log("message " + std::to_string(i), Logger::Level::WARNING);
+				}
+				Logger::Flush();
+				THEN( "only the first few copies are written" ) {
+					CHECK( std::count_if(record.messages.begin(), record.messages.end(),
+						[](const std::string &message) { return message.starts_with("common"); }) == 10 );
+					CHECK( record.messages.size() == 30 );
+				}
+			}
+			WHEN( "several threads log messages at once" ) {
+				static const int THREADS = 4;
+				static const int MESSAGES = 2000;
+				std::vector<std::thread> threads;
+				for(int thread = 0; thread < THREADS; ++thread)
+					threads.emplace_back([thread]()
+					{
+						for(int i = 0; i < MESSAGES; ++i)
+							Logger::Log(std::to_string(thread) + ' ' + std::to_string(i), Logger::Level::INFO);
+					});
+				for(std::thread &thread : threads)
+					thread.join();
+				Logger::Flush();
+				THEN( "every message is written once, in the order each thread logged them" ) {
+					REQUIRE( record.messages.size() == THREADS * MESSAGES );
+					std::vector<int> next(THREADS, 0);
+					bool inOrder = true;
+					for(const std::string &message : record.messages)
+					{
+						int thread = std::stoi(message);
+						inOrder &= (message == std::to_string(thread) + ' ' + std::to_string(next[thread]++));
+					}
+					CHECK( inOrder );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
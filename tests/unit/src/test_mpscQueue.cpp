@@ -0,0 +1,125 @@
+/* test_mpscQueue.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/MpscQueue.h"
+
+// ... and any system includes needed for the test file.
+#include <thread>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// An item that records which thread added it, and in what order.
+struct Item {
+	int producer = 0;
+	int index = 0;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Adding and removing items from an MpscQueue", "[MpscQueue]" ) {
+	GIVEN( "an empty queue" ) {
+		MpscQueue<int, 4> queue;
+		int value = 0;
+		THEN( "nothing can be removed" ) {
+			CHECK_FALSE( queue.Pop(value) );
+		}
+		WHEN( "items are added" ) {
+			REQUIRE( queue.Push(1) );
+			REQUIRE( queue.Push(2) );
+			THEN( "they are removed in the same order" ) {
+				CHECK( queue.Pop(value) );
+				CHECK( value == 1 );
+				CHECK( queue.Pop(value) );
+				CHECK( value == 2 );
+				CHECK_FALSE( queue.Pop(value) );
+			}
+		}
+		WHEN( "the queue is filled" ) {
+			for(int i = 0; i < 4; ++i)
+				REQUIRE( queue.Push(i) );
+			THEN( "no more items can be added until one is removed" ) {
+				CHECK_FALSE( queue.Push(4) );
+				CHECK( queue.Pop(value) );
+				CHECK( value == 0 );
+				CHECK( queue.Push(4) );
+			}
+		}
+		WHEN( "many more items than its capacity pass through it" ) {
+			bool inOrder = true;
+			for(int i = 0; i < 100; ++i)
+			{
+				REQUIRE( queue.Push(i) );
+				REQUIRE( queue.Pop(value) );
+				inOrder &= (value == i);
+			}
+			THEN( "they all come out in order" ) {
+				CHECK( inOrder );
+				CHECK_FALSE( queue.Pop(value) );
+			}
+		}
+	}
+	GIVEN( "several threads adding items at once" ) {
+		static const int PRODUCERS = 4;
+		static const int ITEMS = 20000;
+		MpscQueue<Item, 256> queue;
+		std::vector<std::thread> producers;
+		for(int producer = 0; producer < PRODUCERS; ++producer)
+			producers.emplace_back([&queue, producer]()
+			{
+				for(int i = 0; i < ITEMS; ++i)
+					while(!queue.Push(Item{producer, i}))
+						std::this_thread::yield();
+			});
+
+		// Read everything on this thread while the producers are running.
+		std::vector<int> next(PRODUCERS, 0);
+		bool inOrder = true;
+		int received = 0;
+		Item item;
+		while(received < PRODUCERS * ITEMS)
+		{
+			if(!queue.Pop(item))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			inOrder &= (item.index == next[item.producer]++);
+			++received;
+		}
+		for(std::thread &thread : producers)
+			thread.join();
+
+		THEN( "every item is received once, in the order each thread added them" ) {
+			CHECK( inOrder );
+			for(int count : next)
+				CHECK( count == ITEMS );
+			CHECK_FALSE( queue.Pop(item) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,181 @@
+/* test_savedGameIndex.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/SavedGameIndex.h"
+
+// Include DataNode, to check the fields that are read.
+#include "../../../source/DataNode.h"
+// Include Gzip, to write compressed saved games.
+#include "../../../source/Gzip.h"
+
+// ... and any system includes needed for the test file.
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// How much of a saved game is read at a time.
+const size_t BLOCK_SIZE = 64 * 1024;
+
+// A saved game that is deleted again at the end of the test. It is not in
+// the saves directory, so it is read directly rather than through the index.
+class TemporaryFile {
+public:
+	explicit TemporaryFile(const std::string &contents)
+		: path(std::filesystem::temp_directory_path() / "endless-sky-test-saved-game.txt")
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << contents;
+	}
+	~TemporaryFile()
+	{
+		std::error_code error;
+		std::filesystem::remove(path, error);
+	}
+
+	std::filesystem::path path;
+};
+
+// Make a saved game whose second ship is the flagship, and whose "account"
+// node starts at the given offset, using the given line ending. Fields after
+// the account are not part of the header, so they should never be read.
+std::string MakeSave(size_t accountOffset, const std::string &eol = "\n")
+{
+	std::string text = "pilot Test Pilot" + eol + "date 16 11 3013" + eol + "system Sol" + eol
+		+ "planet Earth" + eol + "playtime 1234" + eol + "\"flagship index\" 1" + eol;
+	text += "ship \"Star Barge\"" + eol + "\tname First" + eol + "\tsprite ship/barge" + eol;
+	text += "ship Shuttle" + eol + "\tname Second" + eol + "\tsprite ship/shuttle" + eol
+		+ "\tcrew 1" + eol;
+	text += "ship Sparrow" + eol + "\tname Third" + eol;
+	// Pad the last ship so that the account starts where it is wanted.
+	const std::string padding = "\t\"padding line\"" + eol;
+	while(text.size() + padding.size() + eol.size() + 1 < accountOffset)
+		text += padding;
+	if(text.size() + eol.size() + 1 < accountOffset)
+		text += "\t" + std::string(accountOffset - text.size() - eol.size() - 1, 'x') + eol;
+	text += "account" + eol + "\tcredits 5000" + eol + "\tscore 400" + eol;
+	text += "pilot Not Read" + eol + "ship Ignored" + eol + "\tname Ignored" + eol;
+	return text;
+}
+
+// Get the tokens of each child of the given node whose first token is the given key.
+std::vector<std::vector<std::string>> Find(const DataNode &node, const std::string &key)
+{
+	std::vector<std::vector<std::string>> result;
+	for(const DataNode &child : node)
+		if(child.Token(0) == key)
+			result.push_back(child.Tokens());
+	return result;
+}
+
+// Check that the header has all of the indexed fields from a saved game made by MakeSave().
+void CheckHeader(const std::shared_ptr<const DataNode> &header)
+{
+	REQUIRE( header );
+	CHECK( Find(*header, "pilot") == std::vector<std::vector<std::string>>{{"pilot", "Test", "Pilot"}} );
+	CHECK( Find(*header, "date") == std::vector<std::vector<std::string>>{{"date", "16", "11", "3013"}} );
+	CHECK( Find(*header, "system") == std::vector<std::vector<std::string>>{{"system", "Sol"}} );
+	CHECK( Find(*header, "planet") == std::vector<std::vector<std::string>>{{"planet", "Earth"}} );
+	CHECK( Find(*header, "playtime") == std::vector<std::vector<std::string>>{{"playtime", "1234"}} );
+	CHECK( Find(*header, "flagship index") == std::vector<std::vector<std::string>>{{"flagship index", "0"}} );
+
+	std::vector<const DataNode *> ships;
+	std::vector<const DataNode *> accounts;
+	for(const DataNode &child : *header)
+	{
+		if(child.Token(0) == "ship")
+			ships.push_back(&child);
+		else if(child.Token(0) == "account")
+			accounts.push_back(&child);
+	}
+	// Only the flagship is kept, with only its name and sprite.
+	REQUIRE( ships.size() == 1 );
+	CHECK( Find(*ships.front(), "name") == std::vector<std::vector<std::string>>{{"name", "Second"}} );
+	CHECK( Find(*ships.front(), "sprite") == std::vector<std::vector<std::string>>{{"sprite", "ship/shuttle"}} );
+	CHECK( Find(*ships.front(), "crew").empty() );
+	// Only the credits are kept from the account.
+	REQUIRE( accounts.size() == 1 );
+	CHECK( Find(*accounts.front(), "credits") == std::vector<std::vector<std::string>>{{"credits", "5000"}} );
+	CHECK( Find(*accounts.front(), "score").empty() );
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Reading the header of a saved game", "[SavedGameIndex]" ) {
+	GIVEN( "a small saved game" ) {
+		TemporaryFile file(MakeSave(0));
+		THEN( "the indexed fields are read, and nothing after the account" ) {
+			CheckHeader(SavedGameIndex::Header(file.path));
+		}
+	}
+	GIVEN( "a saved game with Windows line endings" ) {
+		TemporaryFile file(MakeSave(0, "\r\n"));
+		THEN( "the indexed fields are read, and nothing after the account" ) {
+			CheckHeader(SavedGameIndex::Header(file.path));
+		}
+	}
+	GIVEN( "saved games whose account starts near the end of a block" ) {
+		for(size_t offset : {BLOCK_SIZE - 40, BLOCK_SIZE - 8, BLOCK_SIZE - 4, BLOCK_SIZE, BLOCK_SIZE + 3,
+				BLOCK_SIZE + 20, 2 * BLOCK_SIZE - 10})
+			for(const char *eol : {"\n", "\r\n"})
+			{
+				const std::string save = MakeSave(offset, eol);
+				REQUIRE( save.find(std::string(eol) + "account") + std::string(eol).size() == offset );
+				TemporaryFile file(save);
+				CheckHeader(SavedGameIndex::Header(file.path));
+			}
+	}
+	GIVEN( "a compressed saved game" ) {
+		TemporaryFile file(Gzip::Compress(MakeSave(3 * BLOCK_SIZE)));
+		THEN( "the indexed fields are read, and nothing after the account" ) {
+			CheckHeader(SavedGameIndex::Header(file.path));
+		}
+	}
+	GIVEN( "a compressed saved game with Windows line endings" ) {
+		TemporaryFile file(Gzip::Compress(MakeSave(BLOCK_SIZE, "\r\n")));
+		THEN( "the indexed fields are read, and nothing after the account" ) {
+			CheckHeader(SavedGameIndex::Header(file.path));
+		}
+	}
+	GIVEN( "an empty file" ) {
+		TemporaryFile file("");
+		THEN( "it has no header" ) {
+			CHECK_FALSE( SavedGameIndex::Header(file.path) );
+		}
+	}
+	GIVEN( "a file that does not exist" ) {
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / "endless-sky-no-such-save.txt";
+		THEN( "it has no header" ) {
+			CHECK_FALSE( SavedGameIndex::Header(path) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
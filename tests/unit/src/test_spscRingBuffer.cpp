@@ -0,0 +1,122 @@
+/* test_spscRingBuffer.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/SpscRingBuffer.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <span>
+#include <thread>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Writing to and reading from an SpscRingBuffer", "[SpscRingBuffer]" ) {
+	GIVEN( "an empty buffer" ) {
+		SpscRingBuffer<int> buffer(6);
+		THEN( "nothing can be read, and all of it can be written" ) {
+			CHECK( buffer.Capacity() == 6 );
+			CHECK( buffer.Size() == 0 );
+			CHECK( buffer.ReadView().empty() );
+			CHECK( buffer.WriteView().size() == 6 );
+		}
+		WHEN( "items are written" ) {
+			std::span<int> space = buffer.WriteView();
+			space[0] = 1;
+			space[1] = 2;
+			buffer.Commit(2);
+			THEN( "they can be read in the same order" ) {
+				CHECK( buffer.Size() == 2 );
+				std::span<const int> items = buffer.ReadView();
+				REQUIRE( items.size() == 2 );
+				CHECK( items[0] == 1 );
+				CHECK( items[1] == 2 );
+				CHECK( buffer.WriteView().size() == 4 );
+			}
+			AND_WHEN( "they are read" ) {
+				buffer.Consume(2);
+				THEN( "the free space only extends to the end of the buffer" ) {
+					CHECK( buffer.Size() == 0 );
+					CHECK( buffer.WriteView().size() == 4 );
+				}
+				AND_WHEN( "the buffer is filled" ) {
+					for(int i = 0; i < 6; ++i)
+					{
+						std::span<int> space = buffer.WriteView();
+						REQUIRE_FALSE( space.empty() );
+						space[0] = 10 + i;
+						buffer.Commit(1);
+					}
+					THEN( "it wraps around to the start" ) {
+						CHECK( buffer.Size() == 6 );
+						CHECK( buffer.WriteView().empty() );
+						std::span<const int> items = buffer.ReadView();
+						REQUIRE( items.size() == 4 );
+						CHECK( items[0] == 10 );
+						buffer.Consume(4);
+						items = buffer.ReadView();
+						REQUIRE( items.size() == 2 );
+						CHECK( items[0] == 14 );
+						CHECK( items[1] == 15 );
+					}
+				}
+			}
+		}
+	}
+	GIVEN( "one thread writing while another reads" ) {
+		static const int ITEMS = 200000;
+		SpscRingBuffer<int> buffer(100);
+		std::thread writer([&buffer]()
+		{
+			int next = 0;
+			while(next < ITEMS)
+			{
+				std::span<int> space = buffer.WriteView();
+				size_t count = std::min<size_t>(space.size(), ITEMS - next);
+				for(size_t i = 0; i < count; ++i)
+					space[i] = next++;
+				buffer.Commit(count);
+				if(!count)
+					std::this_thread::yield();
+			}
+		});
+
+		int expected = 0;
+		bool inOrder = true;
+		while(expected < ITEMS)
+		{
+			std::span<const int> items = buffer.ReadView();
+			for(int item : items)
+				inOrder &= (item == expected++);
+			buffer.Consume(items.size());
+			if(items.empty())
+				std::this_thread::yield();
+		}
+		writer.join();
+
+		THEN( "every item is read once, in order" ) {
+			CHECK( inOrder );
+			CHECK( buffer.Size() == 0 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,139 @@
+/* test_systemGrid.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/SystemGrid.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Planet.h"
+#include "../../../source/System.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Create a square galaxy of the given number of systems on each side, spaced
+// so that each system's closest neighbors are a little over 70 units away.
+Set<System> MakeGalaxy(int side)
+{
+	Set<System> systems;
+	Set<Planet> planets;
+	for(int y = 0; y < side; ++y)
+		for(int x = 0; x < side; ++x)
+		{
+			std::string name = std::to_string(x) + "," + std::to_string(y);
+			// Offset every other row so that the systems do not all line up.
+			double posX = 71.3 * x + (y % 2) * 35.;
+			double posY = 71.3 * y - 2000.;
+			systems.Get(name)->Load(AsDataNode("system " + name + "\n\tpos " + std::to_string(posX)
+				+ " " + std::to_string(posY)), planets, nullptr);
+		}
+	return systems;
+}
+
+std::vector<const System *> BruteForce(const Set<System> &systems, const Point &center, double radius)
+{
+	std::vector<const System *> result;
+	for(const auto &it : systems)
+		if(it.second.Position().Distance(center) <= radius)
+			result.push_back(&it.second);
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding systems near a point", "[systemGrid]" ) {
+	GIVEN( "a grid of a galaxy" ) {
+		const Set<System> systems = MakeGalaxy(20);
+		SystemGrid grid;
+		REQUIRE( grid.Update(systems) );
+
+		THEN( "updating it again without changes does nothing" ) {
+			CHECK_FALSE( grid.Update(systems) );
+		}
+		THEN( "every system within each radius is found" ) {
+			for(double radius : {0., 50., 100., 150., 450., 10000.})
+				for(const auto &it : systems)
+				{
+					const Point &center = it.second.Position();
+					std::vector<const System *> result;
+					grid.Circle(center, radius, result);
+					std::sort(result.begin(), result.end());
+					CHECK( result == BruteForce(systems, center, radius) );
+				}
+		}
+		THEN( "points away from any system are handled" ) {
+			std::vector<const System *> result;
+			grid.Circle(Point(-5000., 5000.), 100., result);
+			CHECK( result.empty() );
+			grid.Circle(Point(-100., -2100.), 150., result);
+			CHECK( result == BruteForce(systems, Point(-100., -2100.), 150.) );
+		}
+	}
+	GIVEN( "a system that is not valid" ) {
+		Set<System> systems = MakeGalaxy(2);
+		Set<Planet> planets;
+		systems.Get("no position")->Load(AsDataNode("system \"no position\""), planets, nullptr);
+		SystemGrid grid;
+		grid.Update(systems);
+		THEN( "it is not in the grid" ) {
+			std::vector<const System *> result;
+			grid.Circle(Point(), 100000., result);
+			CHECK( result.size() == 4 );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark SystemGrid::Circle", "[!benchmark][systemGrid]" ) {
+	const Set<System> systems = MakeGalaxy(60);
+	SystemGrid grid;
+	grid.Update(systems);
+	const Point center(71.3 * 30., 71.3 * 30. - 2000.);
+
+	BENCHMARK( "SystemGrid::Circle()" ) {
+		std::vector<const System *> result;
+		grid.Circle(center, 100., result);
+		return result;
+	};
+	BENCHMARK( "Checking every system" ) {
+		std::vector<const System *> result;
+		for(const auto &it : systems)
+			if(it.second.Position().Distance(center) <= 100.)
+				result.push_back(&it.second);
+		return result;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
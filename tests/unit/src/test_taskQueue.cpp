@@ -0,0 +1,139 @@
+/* test_taskQueue.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/TaskQueue.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cstdint>
+
+namespace { // test namespace
+
+// #region mock data
+
+// An upload that copies the given number of bytes, as much at a time as the budget allows.
+class MockUpload {
+public:
+	explicit MockUpload(int64_t size) : size(size) {}
+
+	void Queue(TaskQueue &queue)
+	{
+		queue.RunUpload([this](int64_t &budget) -> bool {
+			int64_t bytes = std::min(budget, size - copied);
+			copied += bytes;
+			budget -= bytes;
+			return copied == size;
+		}, [this] { ++cancelled; });
+	}
+
+	int64_t size;
+	int64_t copied = 0;
+	int cancelled = 0;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Spreading uploads over several frames", "[TaskQueue]" ) {
+	const int64_t FRAME = TaskQueue::MAX_FRAME_UPLOAD_BYTES;
+	TaskQueue::ResetUploadBudget();
+	GIVEN( "an upload larger than one frame's budget" ) {
+		MockUpload upload(FRAME * 5 / 2);
+		TaskQueue queue;
+		upload.Queue(queue);
+		WHEN( "the queue is processed once" ) {
+			queue.ProcessSyncTasks();
+			THEN( "only one frame's worth of data is copied" ) {
+				CHECK( upload.copied == FRAME );
+			}
+			AND_WHEN( "it is processed again in the same frame" ) {
+				queue.ProcessSyncTasks();
+				THEN( "nothing more is copied" ) {
+					CHECK( upload.copied == FRAME );
+				}
+			}
+			AND_WHEN( "it is processed in the following frames" ) {
+				TaskQueue::ResetUploadBudget();
+				queue.ProcessSyncTasks();
+				TaskQueue::ResetUploadBudget();
+				queue.ProcessSyncTasks();
+				THEN( "the upload finishes" ) {
+					CHECK( upload.copied == upload.size );
+				}
+			}
+		}
+		WHEN( "the uploads must be finished right away" ) {
+			queue.ProcessSyncTasks(true);
+			THEN( "all of the data is copied at once" ) {
+				CHECK( upload.copied == upload.size );
+			}
+		}
+	}
+	GIVEN( "uploads in two queues" ) {
+		MockUpload first(FRAME);
+		MockUpload second(FRAME);
+		TaskQueue firstQueue;
+		TaskQueue secondQueue;
+		first.Queue(firstQueue);
+		second.Queue(secondQueue);
+		WHEN( "both queues are processed in one frame" ) {
+			firstQueue.ProcessSyncTasks();
+			secondQueue.ProcessSyncTasks();
+			THEN( "they share one frame's budget" ) {
+				CHECK( first.copied == FRAME );
+				CHECK( second.copied == 0 );
+			}
+		}
+	}
+	GIVEN( "an upload that has finished" ) {
+		MockUpload upload(FRAME / 2);
+		{
+			TaskQueue queue;
+			upload.Queue(queue);
+			queue.ProcessSyncTasks();
+			REQUIRE( upload.copied == upload.size );
+		}
+		THEN( "it is not cancelled when its queue is destroyed" ) {
+			CHECK( upload.cancelled == 0 );
+		}
+	}
+	GIVEN( "uploads that are never finished" ) {
+		MockUpload started(FRAME * 2);
+		MockUpload waiting(FRAME);
+		{
+			TaskQueue queue;
+			started.Queue(queue);
+			waiting.Queue(queue);
+			queue.ProcessSyncTasks();
+			REQUIRE( started.copied == FRAME );
+		}
+		THEN( "each one is cancelled when its queue is destroyed" ) {
+			CHECK( started.cancelled == 1 );
+			CHECK( waiting.cancelled == 1 );
+			CHECK( waiting.copied == 0 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,147 @@
+/* test_textTemplate.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/text/TextTemplate.h"
+
+// ... utility classes
+#include "../../../../source/text/Format.h"
+
+// ... and any system includes needed for the test file.
+#include <map>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+const std::map<std::string, std::string> keys = {
+	{"<first>", "Jane"},
+	{"<last>", "Doe"},
+	{"<planet>", "New Boston"},
+	{"<empty>", ""},
+	{"<a<b>", "nested"},
+	{"<b>", "B"},
+};
+
+// Substitute keys by searching the text for each placeholder in turn.
+std::string SearchAndReplace(const std::string &source, const std::map<std::string, std::string> &keys)
+{
+	std::string result;
+	size_t start = 0;
+	size_t search = 0;
+	while(search < source.length())
+	{
+		size_t left = source.find('<', search);
+		if(left == std::string::npos)
+			break;
+		size_t right = source.find('>', left);
+		if(right == std::string::npos)
+			break;
+
+		++right;
+		auto it = keys.find(source.substr(left, right - left));
+		if(it != keys.end())
+		{
+			result.append(source, start, left - start);
+			result.append(it->second);
+			start = right;
+			search = start;
+		}
+		else
+			search = left + 1;
+	}
+	result.append(source, start, std::string::npos);
+	return result;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Substituting keys into a template", "[TextTemplate]" ) {
+	GIVEN( "text without any placeholders" ) {
+		const TextTemplate text("Nothing to see here.");
+		THEN( "it is returned unchanged" ) {
+			CHECK_FALSE( text.HasPlaceholders() );
+			CHECK( text.Replace(keys) == "Nothing to see here." );
+		}
+	}
+	GIVEN( "text with placeholders" ) {
+		const TextTemplate text("Take <first> <last> to <planet>, <first>.");
+		THEN( "every placeholder is replaced" ) {
+			CHECK( text.HasPlaceholders() );
+			CHECK( text.Replace(keys) == "Take Jane Doe to New Boston, Jane." );
+		}
+		THEN( "placeholders without a value are left alone" ) {
+			CHECK( text.Replace({{"<first>", "Jo"}}) == "Take Jo <last> to <planet>, Jo." );
+		}
+		THEN( "placeholders can be replaced with nothing" ) {
+			CHECK( TextTemplate("a<empty>b").Replace(keys) == "ab" );
+		}
+	}
+	GIVEN( "text with unusual brackets" ) {
+		THEN( "each placeholder is found the same way as by searching for it" ) {
+			for(const char *source : {"<", ">", "<>", "<<first>", "<first>>", "<a<b>", "x<a<b>y<b>",
+					"<first", "first>", "<first><last", "<b><a<b>>", "<<<b>>>", "<last> < <first>"})
+			{
+				std::map<std::string, std::string> withoutNested = keys;
+				withoutNested.erase("<a<b>");
+				CHECK( TextTemplate(source).Replace(keys) == SearchAndReplace(source, keys) );
+				CHECK( TextTemplate(source).Replace(withoutNested) == SearchAndReplace(source, withoutNested) );
+			}
+			CHECK( TextTemplate("x<a<b>y<b>").Replace(keys) == "xnestedyB" );
+			CHECK( TextTemplate("<<first>").Replace(keys) == "<Jane" );
+		}
+	}
+}
+
+SCENARIO( "Substituting keys with Format::Replace", "[Format][Replace]" ) {
+	GIVEN( "the same text more than once" ) {
+		const std::string source = "<first> went to <planet>.";
+		THEN( "each substitution uses the given keys" ) {
+			CHECK( Format::Replace(source, keys) == "Jane went to New Boston." );
+			CHECK( Format::Replace(source, {{"<first>", "Jo"}}) == "Jo went to <planet>." );
+			CHECK( Format::Replace(source, keys) == "Jane went to New Boston." );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark TextTemplate::Replace", "[!benchmark][TextTemplate]" ) {
+	std::string source;
+	for(int i = 0; i < 20; ++i)
+		source += "Bring <first> <last> and their <b> to <planet> by <date>, or else. ";
+	const TextTemplate text(source);
+
+	BENCHMARK( "TextTemplate::Replace()" ) {
+		return text.Replace(keys);
+	};
+	BENCHMARK( "Format::Replace()" ) {
+		return Format::Replace(source, keys);
+	};
+	BENCHMARK( "Searching for each placeholder" ) {
+		return SearchAndReplace(source, keys);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace